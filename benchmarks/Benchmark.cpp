@@ -0,0 +1,927 @@
+#include "../include/bitscpp/VectorWrapper.hpp" // IWYU pragma: keep
+#include "../include/bitscpp/CursorWrapper.hpp"
+#include "../include/bitscpp/BufferPool.hpp"
+#include "../include/bitscpp/RawBufferWrapper.hpp"
+#include "../include/bitscpp/SegmentedBuffer.hpp"
+#include "../include/bitscpp/ByteWriter_v2.hpp"
+#include "../include/bitscpp/ByteReader_v2.hpp"
+#include "../include/bitscpp/HalfFloat.hpp"
+#include "../include/bitscpp/Validator_v2.hpp"
+#include "../include/bitscpp/Tape_v2.hpp"
+#include "../include/bitscpp/MapView_v2.hpp"
+#include "../src/ByteWriter_v2.inl.hpp"
+#include "../thirdparty/half_float/HalfFloat.hpp"
+#include "StructDecode.hpp"
+
+#include <chrono>
+#include <cstdio>
+
+#include <map>
+#include <memory>
+#include <vector>
+
+constexpr uint32_t OPS_PER_MESSAGE = 1024;
+constexpr uint32_t MESSAGES = 4096;
+
+uint64_t sink = 0;
+
+template<typename F>
+void Measure(const char *name, F &&f, uint32_t messages = MESSAGES,
+			 uint32_t opsPerMessage = OPS_PER_MESSAGE)
+{
+	f(); // warmup
+	const auto beg = std::chrono::steady_clock::now();
+	for (uint32_t i = 0; i < messages; ++i) {
+		f();
+	}
+	const auto end = std::chrono::steady_clock::now();
+	const double ns =
+		std::chrono::duration_cast<std::chrono::nanoseconds>(end - beg).count();
+	printf("  %-40s %8.3f ns/op\n", name,
+		   ns / ((double)messages * opsPerMessage));
+}
+
+template<typename F>
+void BenchWriter(const char *name, F &&op)
+{
+	char legacyName[128], cursorName[128];
+	snprintf(legacyName, sizeof(legacyName), "%s VectorWrapper", name);
+	snprintf(cursorName, sizeof(cursorName), "%s CursorWrapper", name);
+
+	bitscpp::VectorWrapper buffer;
+	Measure(legacyName, [&]() {
+		buffer.clear();
+		bitscpp::v2::ByteWriter writer(&buffer);
+		for (uint32_t i = 0; i < OPS_PER_MESSAGE; ++i) {
+			op(writer, i);
+		}
+		sink += writer.GetSize();
+	});
+
+	Measure(cursorName, [&]() {
+		buffer.clear();
+		bitscpp::CursorWrapper cursor(&buffer);
+		bitscpp::v2::ByteWriter writer(&cursor);
+		for (uint32_t i = 0; i < OPS_PER_MESSAGE; ++i) {
+			op(writer, i);
+		}
+		writer.Commit();
+		sink += buffer.size();
+	});
+}
+
+void BenchmarkCursorWriter()
+{
+	printf("v2::ByteWriter:\n");
+	BenchWriter("op_int", [](auto &writer, uint32_t i) {
+		writer.op_int((int64_t)i * 0x9E3779B1ll);
+	});
+	BenchWriter("op_int(mixed width)", [](auto &writer, uint32_t i) {
+		writer.op_int((int64_t)(i * 0x9E3779B97F4A7C15llu) >> (i & 63));
+	});
+	BenchWriter("op_untyped_var_uint", [](auto &writer, uint32_t i) {
+		writer.op_untyped_var_uint((i * 0x9E3779B97F4A7C15llu) >> (i & 63));
+	});
+	BenchWriter("op_float", [](auto &writer, uint32_t i) {
+		writer.op_float((float)i * 0.3f);
+	});
+	BenchWriter("op_double", [](auto &writer, uint32_t i) {
+		writer.op_double((double)i * 0.3);
+	});
+	const std::vector<uint8_t> bytes(80, 0x55);
+	std::vector<uint32_t> sizes(OPS_PER_MESSAGE);
+	for (uint32_t i = 0; i < OPS_PER_MESSAGE; ++i) {
+		sizes[i] = 16 + ((i * 0x9E3779B1u) >> 26);
+	}
+	BenchWriter("op_byte_array(16..79)", [&](auto &writer, uint32_t i) {
+		writer.op_byte_array(bytes.data(), sizes[i]);
+	});
+}
+
+struct Telemetry {
+	uint64_t timestamp = 0;
+	int32_t x = 0, y = 0, z = 0;
+	float speed = 0;
+	double heading = 0;
+	uint16_t flags = 0;
+	bool active = false;
+
+	constexpr static bool FIXED_ENCODED_SIZE = true;
+
+	BITSCPP_DEFINE_INLINE_SERIALIZE_METHOD(s, {
+		s.op(timestamp);
+		s.op(x);
+		s.op(y);
+		s.op(z);
+		s.op(speed);
+		s.op(heading);
+		s.op(flags);
+		s.op(active);
+	});
+};
+
+void BenchmarkBoundedWriter()
+{
+	printf("v2::ByteWriter fixed layout struct:\n");
+	Telemetry tm{123456789012ll, 1000, -20000, 3, 12.5f, 0.125, 0x8001, true};
+	BenchWriter("per field", [&](auto &writer, uint32_t i) {
+		tm.x = i;
+		tm.serialize(writer);
+	});
+	BenchWriter("max_encoded_size", [&](auto &writer, uint32_t i) {
+		tm.x = i;
+		writer.op(tm);
+	});
+}
+
+void BenchmarkBufferPool()
+{
+	printf("v2::ByteWriter buffer per message:\n");
+	Telemetry tm{123456789012ll, 1000, -20000, 3, 12.5f, 0.125, 0x8001, true};
+	Measure("new VectorWrapper", [&]() {
+		bitscpp::VectorWrapper buffer;
+		bitscpp::v2::ByteWriter writer(&buffer);
+		for (uint32_t i = 0; i < OPS_PER_MESSAGE; ++i) {
+			tm.x = i;
+			writer.op(tm);
+		}
+		sink += buffer.size();
+	});
+	Measure("BufferPool::ThreadLocal()", [&]() {
+		bitscpp::BufferPool::Lease buffer =
+			bitscpp::BufferPool::ThreadLocal().Acquire();
+		bitscpp::v2::ByteWriter writer(buffer.get());
+		for (uint32_t i = 0; i < OPS_PER_MESSAGE; ++i) {
+			tm.x = i;
+			writer.op(tm);
+		}
+		sink += buffer->size();
+	});
+}
+
+template<typename BT>
+void BenchBlobs(const char *name, const std::vector<uint8_t> &blob)
+{
+	constexpr uint32_t BLOBS = 16;
+	Measure(name, [&]() {
+		BT buffer;
+		bitscpp::v2::ByteWriter writer(&buffer);
+		for (uint32_t i = 0; i < BLOBS; ++i) {
+			writer.op_int(i);
+			writer.op_byte_array(blob.data(), 3000);
+			writer.op_byte_array(blob);
+		}
+		sink += buffer.size();
+	}, 32, BLOBS);
+
+	char cursorName[128];
+	snprintf(cursorName, sizeof(cursorName), "%s + CursorWrapper", name);
+	Measure(cursorName, [&]() {
+		BT buffer;
+		bitscpp::CursorWrapper cursor(&buffer);
+		bitscpp::v2::ByteWriter writer(&cursor);
+		for (uint32_t i = 0; i < BLOBS; ++i) {
+			writer.op_int(i);
+			writer.op_byte_array(blob.data(), 3000);
+			writer.op_byte_array(blob);
+		}
+		writer.Commit();
+		sink += buffer.size();
+	}, 32, BLOBS);
+}
+
+void BenchmarkRawBuffer()
+{
+	printf("v2::ByteWriter 16 x 1 MiB blobs into new buffer:\n");
+	const std::vector<uint8_t> blob(1024 * 1024, 0x55);
+	BenchBlobs<bitscpp::VectorWrapper>("VectorWrapper", blob);
+	BenchBlobs<bitscpp::RawBufferWrapper>("RawBufferWrapper", blob);
+}
+
+void BenchmarkSegmentedBuffer()
+{
+	constexpr uint32_t STRUCTS = 256 * 1024;
+	printf("v2::ByteWriter ~8 MiB message of structs into new buffer:\n");
+	Telemetry tm{123456789012ll, 1000, -20000, 3, 12.5f, 0.125, 0x8001, true};
+	Measure("VectorWrapper", [&]() {
+		bitscpp::VectorWrapper buffer;
+		bitscpp::v2::ByteWriter writer(&buffer);
+		for (uint32_t i = 0; i < STRUCTS; ++i) {
+			tm.x = i;
+			writer.op(tm);
+		}
+		sink += buffer.size();
+	}, 16, STRUCTS);
+	Measure("SegmentedBuffer", [&]() {
+		bitscpp::SegmentedBuffer buffer;
+		bitscpp::v2::ByteWriter writer(&buffer);
+		for (uint32_t i = 0; i < STRUCTS; ++i) {
+			tm.x = i;
+			writer.op(tm);
+		}
+		writer.Commit();
+		sink += buffer.size();
+	}, 16, STRUCTS);
+
+	constexpr uint32_t BLOBS = 16;
+	printf("v2::ByteWriter 16 x 1 MiB blobs into SegmentedBuffer:\n");
+	const std::vector<uint8_t> blob(1024 * 1024, 0x55);
+	bitscpp::SegmentedBuffer buffer;
+	Measure("op_byte_array", [&]() {
+		buffer.clear();
+		bitscpp::v2::ByteWriter writer(&buffer);
+		for (uint32_t i = 0; i < BLOBS; ++i) {
+			writer.op_int(i);
+			writer.op_byte_array(blob);
+		}
+		writer.Commit();
+		sink += buffer.size();
+	}, 32, BLOBS);
+	Measure("op_byte_array_ref", [&]() {
+		buffer.clear();
+		bitscpp::v2::ByteWriter writer(&buffer);
+		for (uint32_t i = 0; i < BLOBS; ++i) {
+			writer.op_int(i);
+			writer.op_byte_array_ref(blob.data(), blob.size());
+		}
+		writer.Commit();
+		sink += buffer.size();
+	}, 32, BLOBS);
+}
+
+template<typename T>
+void BenchIntegerArray(const char *name, const std::vector<T> &values)
+{
+	char perElementName[128], batchName[128];
+	snprintf(perElementName, sizeof(perElementName), "%s op_int", name);
+	snprintf(batchName, sizeof(batchName), "%s op(vector)", name);
+	bitscpp::VectorWrapper buffer;
+	Measure(perElementName, [&]() {
+		buffer.clear();
+		bitscpp::v2::ByteWriter writer(&buffer);
+		writer.op_array_header(values.size());
+		for (T v : values) {
+			writer.op_int(v);
+		}
+		sink += buffer.size();
+	}, 64, values.size());
+	Measure(batchName, [&]() {
+		buffer.clear();
+		bitscpp::v2::ByteWriter writer(&buffer);
+		writer.op(values);
+		sink += buffer.size();
+	}, 64, values.size());
+
+	snprintf(perElementName, sizeof(perElementName), "%s read op(T)", name);
+	snprintf(batchName, sizeof(batchName), "%s read op(vector)", name);
+	std::vector<T> read(values.size());
+	Measure(perElementName, [&]() {
+		bitscpp::v2::ByteReader reader(buffer.data(), buffer.size());
+		uint32_t elements = 0;
+		reader.op_array_header(elements);
+		for (uint32_t i = 0; i < elements; ++i) {
+			reader.op(read[i]);
+		}
+		sink += read[elements / 2] + reader.is_valid();
+	}, 64, values.size());
+	Measure(batchName, [&]() {
+		bitscpp::v2::ByteReader reader(buffer.data(), buffer.size());
+		reader.op(read);
+		sink += read[read.size() / 2] + reader.is_valid();
+	}, 64, values.size());
+}
+
+void BenchmarkIntegerArray()
+{
+	constexpr uint32_t ELEMENTS = 256 * 1024;
+	printf("v2::ByteWriter and v2::ByteReader integer arrays of 256k elements:\n");
+	std::vector<int32_t> counters(ELEMENTS), ids(ELEMENTS);
+	std::vector<int16_t> deltas(ELEMENTS);
+	std::vector<int64_t> mixed(ELEMENTS);
+	for (uint32_t i = 0; i < ELEMENTS; ++i) {
+		const uint32_t r = i * 0x9E3779B1u;
+		counters[i] = (r >> 25) - 16;
+		ids[i] = r >> 4;
+		mixed[i] = (r & 7) ? (int64_t)(r >> 26) : (int64_t)r * r;
+		deltas[i] = (int16_t)(r >> 20) - 2048;
+	}
+	BenchIntegerArray("int32 counters", counters);
+	BenchIntegerArray("int16 deltas", deltas);
+	BenchIntegerArray("int32 ids", ids);
+	BenchIntegerArray("int64 mixed", mixed);
+}
+
+template<typename T>
+void BenchPackedArray(const char *name, const std::vector<T> &values)
+{
+	char arrayName[128], packedName[128];
+	bitscpp::VectorWrapper arrayBuffer, packedBuffer;
+	std::vector<T> read;
+	snprintf(arrayName, sizeof(arrayName), "%s write op(vector)", name);
+	snprintf(packedName, sizeof(packedName), "%s write op_packed_array", name);
+	Measure(arrayName, [&]() {
+		arrayBuffer.clear();
+		bitscpp::v2::ByteWriter writer(&arrayBuffer);
+		writer.op(values);
+		sink += arrayBuffer.size();
+	}, 64, values.size());
+	Measure(packedName, [&]() {
+		packedBuffer.clear();
+		bitscpp::v2::ByteWriter writer(&packedBuffer);
+		writer.op_packed_array(values);
+		sink += packedBuffer.size();
+	}, 64, values.size());
+	snprintf(arrayName, sizeof(arrayName), "%s read op(vector)", name);
+	snprintf(packedName, sizeof(packedName), "%s read op_packed_array", name);
+	Measure(arrayName, [&]() {
+		bitscpp::v2::ByteReader reader(arrayBuffer.data(), arrayBuffer.size());
+		reader.op(read);
+		sink += read.size() + reader.is_valid();
+	}, 64, values.size());
+	Measure(packedName, [&]() {
+		bitscpp::v2::ByteReader reader(packedBuffer.data(), packedBuffer.size());
+		reader.op_packed_array(read);
+		sink += read.size() + reader.is_valid();
+	}, 64, values.size());
+
+	bitscpp::VectorWrapper alignedBuffer;
+	{
+		bitscpp::v2::ByteWriter writer(&alignedBuffer);
+		writer.op(1);
+		writer.op_aligned_packed_array(values);
+	}
+	// constant time, measured per array instead of per element
+	snprintf(packedName, sizeof(packedName),
+			 "%s read op_packed_array_view (array)", name);
+	Measure(packedName, [&]() {
+		bitscpp::v2::ByteReader reader(alignedBuffer.data(),
+									   alignedBuffer.size());
+		int i = 0;
+		std::span<const T> view;
+		reader.op(i);
+		reader.op_packed_array_view(view, read);
+		sink += view.size() + reader.is_valid();
+	}, 64, 1);
+}
+
+void BenchmarkPackedArray()
+{
+	constexpr uint32_t ELEMENTS = 256 * 1024;
+	printf("v2 array vs packed array of 256k elements:\n");
+	std::vector<float> vertices(ELEMENTS);
+	std::vector<double> samples(ELEMENTS);
+	std::vector<uint16_t> indices(ELEMENTS);
+	for (uint32_t i = 0; i < ELEMENTS; ++i) {
+		const uint32_t r = i * 0x9E3779B1u;
+		vertices[i] = (float)(r >> 8) / 1024.0f;
+		samples[i] = (double)r / 3.0;
+		indices[i] = r >> 16;
+	}
+	BenchPackedArray("float", vertices);
+	BenchPackedArray("double", samples);
+	BenchPackedArray("uint16", indices);
+}
+
+void BenchmarkBitArray()
+{
+	constexpr uint32_t ELEMENTS = 256 * 1024;
+	printf("v2 array of bool vs bit array of 256k elements:\n");
+	std::unique_ptr<bool[]> flags(new bool[ELEMENTS]);
+	std::vector<bool> mask(ELEMENTS);
+	for (uint32_t i = 0; i < ELEMENTS; ++i) {
+		flags[i] = mask[i] = ((i * 0x9E3779B1u) >> 13) & 1;
+	}
+	std::unique_ptr<bool[]> read(new bool[ELEMENTS]);
+	std::vector<bool> readMask;
+	bitscpp::VectorWrapper arrayBuffer, bitBuffer, maskBuffer;
+	Measure("bool[] write op(bool *, n)", [&]() {
+		arrayBuffer.clear();
+		bitscpp::v2::ByteWriter writer(&arrayBuffer);
+		writer.op(flags.get(), ELEMENTS);
+		sink += arrayBuffer.size();
+	}, 64, ELEMENTS);
+	Measure("bool[] write op_bit_array", [&]() {
+		bitBuffer.clear();
+		bitscpp::v2::ByteWriter writer(&bitBuffer);
+		writer.op_bit_array(flags.get(), ELEMENTS);
+		sink += bitBuffer.size();
+	}, 64, ELEMENTS);
+	Measure("std::vector<bool> write op", [&]() {
+		maskBuffer.clear();
+		bitscpp::v2::ByteWriter writer(&maskBuffer);
+		writer.op(mask);
+		sink += maskBuffer.size();
+	}, 64, ELEMENTS);
+	Measure("bool[] read op(bool *, n)", [&]() {
+		bitscpp::v2::ByteReader reader(arrayBuffer.data(), arrayBuffer.size());
+		reader.op(read.get(), ELEMENTS);
+		sink += read[ELEMENTS / 2] + reader.is_valid();
+	}, 64, ELEMENTS);
+	Measure("bool[] read op_bit_array", [&]() {
+		bitscpp::v2::ByteReader reader(bitBuffer.data(), bitBuffer.size());
+		reader.op_bit_array(read.get(), ELEMENTS);
+		sink += read[ELEMENTS / 2] + reader.is_valid();
+	}, 64, ELEMENTS);
+	Measure("std::vector<bool> read op", [&]() {
+		bitscpp::v2::ByteReader reader(maskBuffer.data(), maskBuffer.size());
+		reader.op(readMask);
+		sink += readMask.size() + reader.is_valid();
+	}, 64, ELEMENTS);
+	printf("  encoded size: %zu -> %zu bytes\n", arrayBuffer.size(),
+		   bitBuffer.size());
+}
+
+void BenchmarkHalfFloat()
+{
+	constexpr uint32_t ELEMENTS = 64 * 1024;
+	printf("half float conversion of 64k elements:\n");
+	std::vector<float> floats(ELEMENTS), read(ELEMENTS);
+	std::vector<uint16_t> halves(ELEMENTS);
+	for (uint32_t i = 0; i < ELEMENTS; ++i) {
+		floats[i] = ((int32_t)(i * 0x9E3779B1u) >> 8) * 0x1p-20f;
+	}
+	Measure("Float32ToFloat16 (thirdparty)", [&]() {
+		for (uint32_t i = 0; i < ELEMENTS; ++i) {
+			halves[i] = Float32ToFloat16(floats[i]);
+		}
+		sink += halves[ELEMENTS / 2];
+	}, 256, ELEMENTS);
+	Measure("FloatToHalf array", [&]() {
+		bitscpp::FloatToHalf(halves.data(), floats.data(), ELEMENTS);
+		sink += halves[ELEMENTS / 2];
+	}, 256, ELEMENTS);
+	Measure("Float16ToFloat32 (thirdparty)", [&]() {
+		for (uint32_t i = 0; i < ELEMENTS; ++i) {
+			read[i] = Float16ToFloat32(halves[i]);
+		}
+		sink += read[ELEMENTS / 2];
+	}, 256, ELEMENTS);
+	Measure("HalfToFloat array", [&]() {
+		bitscpp::HalfToFloat(read.data(), halves.data(), ELEMENTS);
+		sink += read[ELEMENTS / 2];
+	}, 256, ELEMENTS);
+
+	bitscpp::VectorWrapper singleBuffer, arrayBuffer;
+	Measure("write op_half", [&]() {
+		singleBuffer.clear();
+		bitscpp::v2::ByteWriter writer(&singleBuffer);
+		for (uint32_t i = 0; i < ELEMENTS; ++i) {
+			writer.op_half(floats[i]);
+		}
+		sink += singleBuffer.size();
+	}, 256, ELEMENTS);
+	Measure("write op_half_array", [&]() {
+		arrayBuffer.clear();
+		bitscpp::v2::ByteWriter writer(&arrayBuffer);
+		writer.op_half_array(floats);
+		sink += arrayBuffer.size();
+	}, 256, ELEMENTS);
+	Measure("read op_half", [&]() {
+		bitscpp::v2::ByteReader reader(singleBuffer.data(), singleBuffer.size());
+		for (uint32_t i = 0; i < ELEMENTS; ++i) {
+			reader.op_half(read[i]);
+		}
+		sink += read[ELEMENTS / 2] + reader.is_valid();
+	}, 256, ELEMENTS);
+	Measure("read op_half_array", [&]() {
+		bitscpp::v2::ByteReader reader(arrayBuffer.data(), arrayBuffer.size());
+		reader.op_half_array(read);
+		sink += read[ELEMENTS / 2] + reader.is_valid();
+	}, 256, ELEMENTS);
+}
+
+void BenchmarkPaddedReader()
+{
+	constexpr uint32_t VALUES = 8;
+	printf("v2::ByteReader messages of %u wide integers and var uints:\n",
+		   VALUES);
+	// messages are read one after another from single padded buffer
+	bitscpp::VectorWrapper buffer;
+	std::vector<uint32_t> offsets = {0};
+	for (uint32_t m = 0; m < MESSAGES; ++m) {
+		bitscpp::v2::ByteWriter writer(&buffer);
+		for (uint32_t i = 0; i < VALUES / 2; ++i) {
+			const uint64_t r = (m * VALUES + i) * 0x9E3779B97F4A7C15llu;
+			writer.op_int((int64_t)r >> (r >> 58));
+			writer.op_untyped_var_uint(r >> (r >> 58));
+		}
+		offsets.push_back(buffer.size());
+	}
+	const uint32_t size = buffer.size();
+	buffer.vector.resize(size + bitscpp::v2::ByteReader::INPUT_PADDING);
+
+	auto read = [&](bitscpp::v2::ByteReader &reader) {
+		for (uint32_t i = 0; i < VALUES / 2; ++i) {
+			int64_t v = 0;
+			uint64_t u = 0;
+			reader.op_int(v);
+			reader.op_untyped_var_uint(u);
+			sink += v + u;
+		}
+		sink += reader.is_valid();
+	};
+	Measure("read", [&]() {
+		for (uint32_t m = 0; m < MESSAGES; ++m) {
+			bitscpp::v2::ByteReader reader(buffer.data() + offsets[m],
+										   offsets[m + 1] - offsets[m]);
+			read(reader);
+		}
+	}, 64, MESSAGES * VALUES);
+	Measure("read Padded", [&]() {
+		for (uint32_t m = 0; m < MESSAGES; ++m) {
+			bitscpp::v2::ByteReader reader(buffer.data() + offsets[m],
+										   offsets[m + 1] - offsets[m],
+										   bitscpp::v2::ByteReader::Padded{});
+			read(reader);
+		}
+	}, 64, MESSAGES * VALUES);
+}
+
+template<typename Reader, typename F>
+void BenchReader(const char *name, bitscpp::VectorWrapper &buffer,
+				 F &&read)
+{
+	Measure(name, [&]() {
+		Reader reader(buffer.data(), buffer.size());
+		for (uint32_t i = 0; i < OPS_PER_MESSAGE; ++i) {
+			read(reader);
+		}
+		sink += reader.is_valid();
+	});
+}
+
+void BenchmarkUncheckedReader()
+{
+	printf("v2::ByteReader vs v2::UncheckedByteReader:\n");
+	Telemetry tm{123456789012ll, 1000, -20000, 3, 12.5f, 0.125, 0x8001, true};
+	bitscpp::VectorWrapper structs, ints;
+	{
+		bitscpp::v2::ByteWriter writer(&structs);
+		for (uint32_t i = 0; i < OPS_PER_MESSAGE; ++i) {
+			tm.x = i;
+			writer.op(tm);
+		}
+	}
+	{
+		bitscpp::v2::ByteWriter writer(&ints);
+		for (uint32_t i = 0; i < OPS_PER_MESSAGE; ++i) {
+			writer.op_int((int64_t)(i * 0x9E3779B97F4A7C15llu) >> (i & 63));
+		}
+	}
+	auto readStruct = [&](auto &reader) {
+		reader.op(tm);
+		sink += tm.x;
+	};
+	auto readInt = [&](auto &reader) {
+		int64_t v = 0;
+		reader.op_int(v);
+		sink += v;
+	};
+	BenchReader<bitscpp::v2::ByteReader>("Telemetry checked", structs,
+										 readStruct);
+	BenchReader<bitscpp::v2::UncheckedByteReader>("Telemetry unchecked",
+												  structs, readStruct);
+	BenchReader<bitscpp::v2::ByteReader>("op_int(mixed width) checked", ints,
+										 readInt);
+	BenchReader<bitscpp::v2::UncheckedByteReader>(
+		"op_int(mixed width) unchecked", ints, readInt);
+}
+
+template<typename F>
+void BenchValidatedReader(const char *name, bitscpp::VectorWrapper &buffer,
+						  F &&read)
+{
+	Measure(name, [&]() {
+		if (bitscpp::v2::validate(buffer.data(), buffer.size()) !=
+			bitscpp::v2::ERROR_OK) {
+			return;
+		}
+		bitscpp::v2::UncheckedByteReader reader(buffer.data(), buffer.size());
+		for (uint32_t i = 0; i < OPS_PER_MESSAGE; ++i) {
+			read(reader);
+		}
+		sink += reader.is_valid();
+	});
+}
+
+void BenchmarkValidator()
+{
+	printf("v2::validate() + v2::UncheckedByteReader vs v2::ByteReader:\n");
+	Telemetry tm{123456789012ll, 1000, -20000, 3, 12.5f, 0.125, 0x8001, true};
+	std::vector<std::vector<int32_t>> rows(OPS_PER_MESSAGE);
+	bitscpp::VectorWrapper structs, arrays;
+	{
+		bitscpp::v2::ByteWriter writer(&structs);
+		for (uint32_t i = 0; i < OPS_PER_MESSAGE; ++i) {
+			tm.x = i;
+			writer.op(tm);
+		}
+	}
+	{
+		bitscpp::v2::ByteWriter writer(&arrays);
+		for (uint32_t i = 0; i < OPS_PER_MESSAGE; ++i) {
+			rows[i].resize(16 + i % 16);
+			for (uint32_t j = 0; j < rows[i].size(); ++j) {
+				rows[i][j] = (i + j) % 100;
+			}
+			writer.op(rows[i]);
+		}
+	}
+	auto readStruct = [&](auto &reader) {
+		reader.op(tm);
+		sink += tm.x;
+	};
+	std::vector<int32_t> row;
+	auto readArray = [&](auto &reader) {
+		reader.op(row);
+		sink += row.size();
+	};
+	Measure("validate(Telemetry)", [&]() {
+		sink += bitscpp::v2::validate(structs.data(), structs.size());
+	});
+	BenchReader<bitscpp::v2::ByteReader>("Telemetry checked", structs,
+										 readStruct);
+	BenchValidatedReader("Telemetry validate + unchecked", structs,
+						 readStruct);
+	Measure("validate(small int arrays)", [&]() {
+		sink += bitscpp::v2::validate(arrays.data(), arrays.size());
+	});
+	BenchReader<bitscpp::v2::ByteReader>("small int arrays checked", arrays,
+										 readArray);
+	BenchValidatedReader("small int arrays validate + unchecked", arrays,
+						 readArray);
+}
+
+void BenchmarkSkipValue()
+{
+	printf("v2::ByteReader skip_values() vs decoding:\n");
+	Telemetry tm{123456789012ll, 1000, -20000, 3, 12.5f, 0.125, 0x8001, true};
+	std::vector<std::vector<int32_t>> rows(OPS_PER_MESSAGE);
+	bitscpp::VectorWrapper structs, arrays;
+	{
+		bitscpp::v2::ByteWriter writer(&structs);
+		for (uint32_t i = 0; i < OPS_PER_MESSAGE; ++i) {
+			tm.x = i;
+			writer.op(tm);
+		}
+	}
+	{
+		bitscpp::v2::ByteWriter writer(&arrays);
+		for (uint32_t i = 0; i < OPS_PER_MESSAGE; ++i) {
+			// rows of rows, 2 levels of nesting
+			rows[i].resize(16 + i % 16);
+			for (uint32_t j = 0; j < rows[i].size(); ++j) {
+				rows[i][j] = (i + j) % 1000;
+			}
+			writer.op(std::vector<std::vector<int32_t>>(4, rows[i]));
+		}
+	}
+	BenchReader<bitscpp::v2::ByteReader>("Telemetry decode", structs,
+										 [&](auto &reader) {
+											 reader.op(tm);
+											 sink += tm.x;
+										 });
+	BenchReader<bitscpp::v2::ByteReader>(
+		"Telemetry skip_values(8)", structs,
+		[&](auto &reader) { reader.skip_values(8); });
+	BenchReader<bitscpp::v2::ByteReader>(
+		"Telemetry skip_next_value() x 8", structs, [&](auto &reader) {
+			for (int i = 0; i < 8; ++i) {
+				reader.skip_next_value();
+			}
+		});
+	std::vector<std::vector<int32_t>> nested;
+	BenchReader<bitscpp::v2::ByteReader>("nested int arrays decode", arrays,
+										 [&](auto &reader) {
+											 reader.op(nested);
+											 sink += nested.size();
+										 });
+	BenchReader<bitscpp::v2::ByteReader>(
+		"nested int arrays skip_next_value()", arrays,
+		[&](auto &reader) { reader.skip_next_value(); });
+}
+
+void BenchmarkTape()
+{
+	printf("v2::Tape random access vs decoding:\n");
+	struct Row {
+		uint32_t id = 0;
+		std::string name;
+		std::vector<int32_t> values;
+	};
+	bitscpp::VectorWrapper buffer;
+	{
+		bitscpp::v2::ByteWriter writer(&buffer);
+		writer.op_array_header(OPS_PER_MESSAGE);
+		for (uint32_t i = 0; i < OPS_PER_MESSAGE; ++i) {
+			writer.op_begin_object();
+			writer.op(i);
+			writer.op("row " + std::to_string(i));
+			writer.op(std::vector<int32_t>(16 + i % 16, i % 300));
+			writer.op_end_object();
+		}
+	}
+	auto readRow = [](auto &reader, Row &row) {
+		reader.op_begin_object();
+		reader.op(row.id);
+		reader.op(row.name);
+		reader.op(row.values);
+		reader.op_end_object();
+	};
+	Row row;
+	Measure("decode all rows", [&]() {
+		bitscpp::v2::ByteReader reader(buffer.data(), buffer.size());
+		uint32_t rows = 0;
+		reader.op_array_header(rows);
+		for (uint32_t i = 0; i < rows; ++i) {
+			readRow(reader, row);
+		}
+		sink += row.id;
+	});
+	bitscpp::v2::Tape tape;
+	Measure("Tape::build()", [&]() {
+		sink += tape.build(buffer.data(), buffer.size());
+		sink += tape.entries.size();
+	});
+	// queries of 10 rows, which is 1% of document
+	constexpr uint32_t QUERIES = 10;
+	Measure("10 rows with skip_values()", [&]() {
+		for (uint32_t i = 0; i < QUERIES; ++i) {
+			bitscpp::v2::ByteReader reader(buffer.data(), buffer.size());
+			uint32_t rows = 0;
+			reader.op_array_header(rows);
+			reader.skip_values((i * 97 + sink) % rows);
+			readRow(reader, row);
+			sink += row.id;
+		}
+	}, MESSAGES, QUERIES);
+	Measure("10 rows with TapeCursor", [&]() {
+		const bitscpp::v2::TapeCursor rows = tape.first();
+		for (uint32_t i = 0; i < QUERIES; ++i) {
+			auto reader =
+				rows.element((i * 97 + sink) % rows.size()).reader();
+			readRow(reader, row);
+			sink += row.id;
+		}
+	}, MESSAGES, QUERIES);
+}
+
+void BenchmarkIndexedArray()
+{
+	printf("v2 indexed array vs array:\n");
+	// sorted keys of different lengths
+	std::vector<std::string> keys(OPS_PER_MESSAGE);
+	for (uint32_t i = 0; i < OPS_PER_MESSAGE; ++i) {
+		keys[i] = std::to_string(1000000 + i * 7) + std::string(i % 24, 'k');
+	}
+	bitscpp::VectorWrapper plain, indexed;
+	Measure("write array", [&]() {
+		plain.clear();
+		bitscpp::v2::ByteWriter(&plain).op(keys);
+	}, MESSAGES / 4);
+	Measure("write indexed array", [&]() {
+		indexed.clear();
+		bitscpp::v2::ByteWriter(&indexed).op_indexed_array(keys);
+	}, MESSAGES / 4);
+	constexpr uint32_t QUERIES = 10;
+	std::string key;
+	Measure("10 elements with skip_values()", [&]() {
+		for (uint32_t i = 0; i < QUERIES; ++i) {
+			bitscpp::v2::ByteReader reader(plain.data(), plain.size());
+			uint32_t elements = 0;
+			reader.op_array_header(elements);
+			reader.skip_values((i * 97 + sink) % elements).op(key);
+			sink += key.size();
+		}
+	}, MESSAGES, QUERIES);
+	Measure("10 elements with seek_array_element()", [&]() {
+		for (uint32_t i = 0; i < QUERIES; ++i) {
+			bitscpp::v2::ByteReader reader(indexed.data(), indexed.size());
+			bitscpp::v2::IndexedArray array;
+			reader.op_indexed_array_header(array);
+			reader.seek_array_element(array, (i * 97 + sink) % array.elements)
+				.op(key);
+			sink += key.size();
+		}
+	}, MESSAGES, QUERIES);
+	Measure("10 binary searches in indexed array", [&]() {
+		bitscpp::v2::ByteReader reader(indexed.data(), indexed.size());
+		bitscpp::v2::IndexedArray array;
+		reader.op_indexed_array_header(array);
+		for (uint32_t i = 0; i < QUERIES; ++i) {
+			const std::string &wanted = keys[(i * 97 + sink) % keys.size()];
+			uint32_t low = 0, high = array.elements;
+			while (low < high) {
+				const uint32_t mid = (low + high) / 2;
+				std::string_view view;
+				reader.seek_array_element(array, mid).op(view);
+				if (view < wanted) {
+					low = mid + 1;
+				} else {
+					high = mid;
+				}
+			}
+			sink += low;
+		}
+	}, MESSAGES, QUERIES);
+}
+
+void BenchmarkMapView()
+{
+	printf("v2 map lookup, std::map vs MapView:\n");
+	std::map<std::string, std::string> map;
+	for (uint32_t i = 0; i < 512; ++i) {
+		map[std::to_string(1000000 + i * 7)] = std::string(i % 40, 'v');
+	}
+	bitscpp::VectorWrapper plain, sorted;
+	bitscpp::v2::ByteWriter(&plain).op(map);
+	bitscpp::v2::ByteWriter(&sorted).op_sorted_map(map);
+	constexpr uint32_t QUERIES = 2;
+	const auto key = [&](uint32_t i) {
+		return std::to_string(1000000 + ((i * 97 + sink) % 512) * 7);
+	};
+	Measure("decode std::map, 2 lookups", [&]() {
+		std::map<std::string, std::string> decoded;
+		bitscpp::v2::ByteReader(plain.data(), plain.size()).op(decoded);
+		for (uint32_t i = 0; i < QUERIES; ++i) {
+			sink += decoded.find(key(i))->second.size();
+		}
+	}, MESSAGES / 16, QUERIES);
+	const auto lookup = [&](const std::vector<uint8_t> &buffer) {
+		return [&]() {
+			bitscpp::v2::ByteReader reader(buffer.data(), buffer.size());
+			bitscpp::v2::MapView view(reader);
+			for (uint32_t i = 0; i < QUERIES; ++i) {
+				bitscpp::v2::ByteReader value(nullptr, 0);
+				std::string_view str;
+				view.find(key(i), value);
+				value.op(str);
+				sink += str.size();
+			}
+		};
+	};
+	Measure("MapView of map, 2 lookups", lookup(plain.vector), MESSAGES,
+			QUERIES);
+	Measure("MapView of sorted map, 2 lookups", lookup(sorted.vector), MESSAGES,
+			QUERIES);
+}
+
+void BenchmarkHeaderOnlyReader()
+{
+	printf("v2::ByteReader static library vs BITSCPP_HEADER_ONLY:\n");
+	bitscpp::VectorWrapper buffer;
+	{
+		bitscpp::v2::ByteWriter writer(&buffer);
+		Struct s;
+		s.str = "ala ma hfdjsak lfdhsjk fljhasd fljadskl fdha klfdasjf l";
+		s.str2 = s.str;
+		for (uint32_t i = 0; i < OPS_PER_MESSAGE; ++i) {
+			const uint64_t v = i * 0x9E3779B97F4A7C15llu;
+			s.bytes16 = s.bytes32 = s.bytes64 = i & 7;
+			s.a8 = s.b8 = v;
+			s.ua8 = s.ub8 = v >> 8;
+			s.a16 = s.b16 = v >> 16;
+			s.ua16 = s.ub16 = v >> 24;
+			s.a32 = s.b32 = v >> 32;
+			s.ua32 = s.ub32 = v >> 40;
+			s.a64 = s.b64 = v;
+			s.ua64 = s.ub64 = v >> (i & 63);
+			s.f1 = i * 0.5f;
+			s.f2 = i * 0.25;
+			s.is.resize(i % 32);
+			for (uint32_t j = 0; j < s.is.size(); ++j) {
+				s.is[j] = (v >> j) & 0xFFFFFF;
+			}
+			writer.op(s);
+		}
+	}
+	Measure("Struct static library", [&]() {
+		sink += decode_structs(buffer.data(), buffer.size(), OPS_PER_MESSAGE);
+	}, MESSAGES / 4);
+	Measure("Struct BITSCPP_HEADER_ONLY", [&]() {
+		sink += DecodeStructsHeaderOnly(buffer.data(), buffer.size(),
+										OPS_PER_MESSAGE);
+	}, MESSAGES / 4);
+}
+
+int main()
+{
+	BenchmarkCursorWriter();
+	BenchmarkBoundedWriter();
+	BenchmarkBufferPool();
+	BenchmarkRawBuffer();
+	BenchmarkSegmentedBuffer();
+	BenchmarkIntegerArray();
+	BenchmarkPackedArray();
+	BenchmarkBitArray();
+	BenchmarkHalfFloat();
+	BenchmarkPaddedReader();
+	BenchmarkUncheckedReader();
+	BenchmarkValidator();
+	BenchmarkSkipValue();
+	BenchmarkTape();
+	BenchmarkIndexedArray();
+	BenchmarkMapView();
+	BenchmarkHeaderOnlyReader();
+	return sink == 0 ? 1 : 0;
+}
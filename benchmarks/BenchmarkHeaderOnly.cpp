@@ -0,0 +1,9 @@
+#define BITSCPP_HEADER_ONLY
+
+#include "StructDecode.hpp"
+
+uint64_t DecodeStructsHeaderOnly(const uint8_t *buffer, uint32_t size,
+								 uint32_t count)
+{
+	return decode_structs(buffer, size, count);
+}
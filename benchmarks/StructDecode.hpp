@@ -0,0 +1,92 @@
+#ifndef BITSCPP_BENCHMARK_STRUCT_DECODE_HPP
+#define BITSCPP_BENCHMARK_STRUCT_DECODE_HPP
+
+#include "../include/bitscpp/ByteReader_v2.hpp"
+
+#include <string>
+#include <vector>
+
+// Struct of tests/Test.cpp, decoded by translation units compiled with and
+// without BITSCPP_HEADER_ONLY. Anonymous namespace keeps serialize()
+// instantiations of both units apart.
+namespace
+{
+struct Struct {
+	std::string str;
+	std::string str2;
+	std::vector<int> is;
+
+	int64_t bytes16 = 0;
+	int64_t bytes32 = 0;
+	int64_t bytes64 = 0;
+
+	uint64_t a64 = 0;
+	int64_t ua64 = 0;
+	uint64_t b64 = 0;
+	int64_t ub64 = 0;
+
+	double f2 = 0;
+	float f1 = 0;
+
+	uint32_t a32 = 0;
+	int32_t ua32 = 0;
+	uint32_t b32 = 0;
+	int32_t ub32 = 0;
+
+	uint16_t a16 = 0;
+	int16_t ua16 = 0;
+	uint16_t b16 = 0;
+	int16_t ub16 = 0;
+
+	uint8_t a8 = 0;
+	int8_t ua8 = 0;
+	uint8_t b8 = 0;
+	int8_t ub8 = 0;
+
+	BITSCPP_DEFINE_INLINE_SERIALIZE_METHOD(s, {
+		s.op(bytes16);
+		s.op(bytes32);
+		s.op(bytes64);
+		s.op(a8);
+		s.op(ua8);
+		s.op(a16);
+		s.op(ua16);
+		s.op(a32);
+		s.op(ua32);
+		s.op(a64);
+		s.op(ua64);
+		s.op(str);
+		s.op(str2);
+		s.op(b8);
+		s.op(ub8);
+		s.op(b16);
+		s.op(ub16);
+		s.op(is);
+		s.op(b32);
+		s.op(ub32);
+		s.op(b64);
+		s.op(ub64);
+		s.op(f2);
+		s.op(f1);
+	});
+};
+
+inline uint64_t decode_structs(const uint8_t *buffer, uint32_t size,
+							   uint32_t count)
+{
+	Struct s;
+	uint64_t sum = 0;
+	bitscpp::v2::ByteReader reader(buffer, size);
+	for (uint32_t i = 0; i < count; ++i) {
+		reader.op(s);
+		sum += s.a32 + s.is.size();
+	}
+	return sum + reader.is_valid();
+}
+} // namespace
+
+// Defined in BenchmarkHeaderOnly.cpp.
+uint64_t DecodeStructsHeaderOnly(const uint8_t *buffer, uint32_t size,
+								 uint32_t count);
+
+#endif
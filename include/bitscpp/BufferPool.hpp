@@ -0,0 +1,165 @@
+// Copyright (C) 2026 Marek Zalewski aka Drwalin
+//
+// This file is part of bitscpp project under MIT License
+// You should have received a copy of the MIT License along with this program.
+
+#ifndef BITSCPP_BUFFER_POOL_HPP
+#define BITSCPP_BUFFER_POOL_HPP
+
+#include <cstdint>
+#include <cstddef>
+
+#include <utility>
+#include <vector>
+
+#include "VectorWrapper.hpp"
+
+/*
+ * Pool of pre-reserved VectorWrapper buffers, handed out as RAII leases.
+ * Released buffers are cleared and kept for reuse; capacity of buffers bigger
+ * than highWaterMark is trimmed down to it, so that single huge message does
+ * not pin memory.
+ *
+ * BufferPool is not thread safe. BufferPool::ThreadLocal() returns pool owned
+ * by calling thread, Lease has to be destroyed on the same thread as its
+ * pool.
+ *
+ * Usage:
+ *   bitscpp::BufferPool::Lease buffer = bitscpp::BufferPool::ThreadLocal().Acquire();
+ *   bitscpp::v2::ByteWriter writer(buffer.get());
+ *   writer.op(...);
+ *   send(buffer->data(), buffer->size());
+ */
+
+namespace bitscpp
+{
+class BufferPool {
+public:
+	struct Config {
+		// Capacity of newly allocated buffers.
+		size_t initialCapacity = 4096;
+		// Capacity of bigger buffers is trimmed to this value on release.
+		size_t highWaterMark = 1024 * 1024;
+		// Released buffers above this count are freed.
+		size_t maxBuffers = 64;
+	};
+
+	struct Stats {
+		uint64_t hits = 0;
+		uint64_t misses = 0;
+		uint64_t trimmed = 0;
+		uint64_t dropped = 0;
+		// Sum of capacities of buffers kept in pool.
+		size_t bytesRetained = 0;
+
+		inline double HitRate() const {
+			const uint64_t total = hits + misses;
+			return total ? (double)hits / (double)total : 0.0;
+		}
+	};
+
+	class Lease {
+	public:
+		inline Lease() = default;
+		inline Lease(BufferPool *pool, VectorWrapper &&buffer)
+			: pool(pool), buffer(std::move(buffer)) {}
+		inline ~Lease() { Release(); }
+		inline Lease(Lease &&o) : pool(o.pool), buffer(std::move(o.buffer)) {
+			o.pool = nullptr;
+		}
+		inline Lease &operator=(Lease &&o) {
+			if (this != &o) {
+				Release();
+				pool = o.pool;
+				buffer = std::move(o.buffer);
+				o.pool = nullptr;
+			}
+			return *this;
+		}
+		Lease(Lease &o) = delete;
+		Lease(const Lease &o) = delete;
+		Lease &operator=(Lease &o) = delete;
+		Lease &operator=(const Lease &o) = delete;
+
+		inline VectorWrapper *get() { return &buffer; }
+		inline VectorWrapper *operator->() { return &buffer; }
+		inline VectorWrapper &operator*() { return buffer; }
+
+		// Returns buffer to pool before destruction of lease.
+		inline void Release() {
+			if (pool) {
+				pool->Release(std::move(buffer));
+				pool = nullptr;
+			}
+		}
+
+	private:
+		BufferPool *pool = nullptr;
+		VectorWrapper buffer;
+	};
+
+public:
+	inline BufferPool() = default;
+	inline BufferPool(Config config) : config(config) {}
+	~BufferPool() = default;
+	BufferPool(BufferPool &o) = delete;
+	BufferPool(const BufferPool &o) = delete;
+	BufferPool &operator=(BufferPool &o) = delete;
+	BufferPool &operator=(const BufferPool &o) = delete;
+
+	inline static BufferPool &ThreadLocal() {
+		static thread_local BufferPool pool;
+		return pool;
+	}
+
+	inline Lease Acquire() {
+		if (freeBuffers.empty() == false) {
+			[[likely]];
+			++stats.hits;
+			VectorWrapper buffer = std::move(freeBuffers.back());
+			freeBuffers.pop_back();
+			stats.bytesRetained -= buffer.capacity();
+			return Lease(this, std::move(buffer));
+		}
+		++stats.misses;
+		VectorWrapper buffer;
+		buffer.reserve_exact(config.initialCapacity);
+		return Lease(this, std::move(buffer));
+	}
+
+	inline void Release(VectorWrapper &&buffer) {
+		if (freeBuffers.size() >= config.maxBuffers) {
+			++stats.dropped;
+			return;
+		}
+		if (buffer.capacity() > config.highWaterMark) {
+			[[unlikely]];
+			++stats.trimmed;
+			std::vector<uint8_t> trimmed;
+			trimmed.reserve(config.highWaterMark);
+			buffer.vector.swap(trimmed);
+		}
+		buffer.clear();
+		stats.bytesRetained += buffer.capacity();
+		freeBuffers.emplace_back(std::move(buffer));
+	}
+
+	// Frees all buffers kept in pool.
+	inline void Clear() {
+		freeBuffers.clear();
+		stats.bytesRetained = 0;
+	}
+
+	inline size_t FreeBuffers() const { return freeBuffers.size(); }
+	inline const Stats &GetStats() const { return stats; }
+	inline const Config &GetConfig() const { return config; }
+	inline void SetConfig(Config c) { config = c; }
+
+private:
+	Config config;
+	Stats stats;
+	std::vector<VectorWrapper> freeBuffers;
+};
+}
+
+#endif
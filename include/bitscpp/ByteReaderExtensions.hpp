@@ -59,9 +59,9 @@ inline ByteReader<false>& op(ByteReader<false>& s, std::unordered_set<T>& set) {
 	return s;
 }
 
-template<typename T>
-struct serializer<v2::ByteReader, std::set<T>> {
-static inline void op(v2::ByteReader& s, std::set<T>& set) {
+template<bool CHECKED, typename T>
+struct serializer<v2::BasicByteReader<CHECKED>, std::set<T>> {
+static inline void op(v2::BasicByteReader<CHECKED>& s, std::set<T>& set) {
 	set.clear();
 	uint32_t elements = 0;
 	s.op(elements);
@@ -70,7 +70,7 @@ static inline void op(v2::ByteReader& s, std::set<T>& set) {
 		s.set_error(v2::ERROR_ARRAY_TOO_BIG);
 		return;
 	}
-	if (elements > s.get_remaining_bytes()) {
+	if (CHECKED && elements > s.get_remaining_bytes()) {
 		[[unlikely]];
 		s.set_error(v2::ERROR_BUFFER_TOO_SMALL);
 		return;
@@ -86,9 +86,9 @@ static inline void op(v2::ByteReader& s, std::set<T>& set) {
 	}
 }
 };
-template<typename T>
-struct serializer<v2::ByteReader, std::unordered_set<T>> {
-static inline void op(v2::ByteReader& s, std::unordered_set<T>& set) {
+template<bool CHECKED, typename T>
+struct serializer<v2::BasicByteReader<CHECKED>, std::unordered_set<T>> {
+static inline void op(v2::BasicByteReader<CHECKED>& s, std::unordered_set<T>& set) {
 	set.clear();
 	uint32_t elements = 0;
 	s.op(elements);
@@ -97,7 +97,7 @@ static inline void op(v2::ByteReader& s, std::unordered_set<T>& set) {
 		s.set_error(v2::ERROR_ARRAY_TOO_BIG);
 		return;
 	}
-	if (elements > s.get_remaining_bytes()) {
+	if (CHECKED && elements > s.get_remaining_bytes()) {
 		[[unlikely]];
 		s.set_error(v2::ERROR_BUFFER_TOO_SMALL);
 		return;
@@ -8,10 +8,15 @@
 
 #include <cstdint>
 
+#include <bitset>
+#include <map>
+#include <span>
 #include <string>
 #include <string_view>
+#include <type_traits>
 #include <vector>
 
+#include "Endianness.hpp"
 #include "V2_Specification.hpp"
 #include "SerizalizerClass.hpp"
 
@@ -19,34 +24,68 @@ namespace bitscpp
 {
 namespace v2
 {
-class ByteReader
+template<bool CHECKED>
+class BasicMapView;
+
+// Position of array read by op_indexed_array_header(), or of sorted map.
+struct IndexedArray {
+	uint32_t elements = 0;
+	// Bytes per entry of offset table, 0 for array without table.
+	uint32_t width = 0;
+	// Offsets in read buffer of offset table and of first element.
+	uint32_t table = 0;
+	uint32_t data = 0;
+};
+
+/*
+ * ByteReader checks bounds of every read and reports ERROR_BUFFER_TOO_SMALL.
+ * UncheckedByteReader skips bounds checks, like v1 ByteReader<false>, so it
+ * may only read trusted, well formed input, for example buffers produced and
+ * checksummed by application itself, or buffers accepted by v2::validate()
+ * (see Validator_v2.hpp). Type mismatches are still reported.
+ *
+ * Readers are compiled into bitscpp library, so every op() is a call. When
+ * BITSCPP_HEADER_ONLY is defined before including this header, definitions
+ * are included too, so that reads can be inlined into serialize() methods
+ * and linking bitscpp library is not needed for the reader.
+ */
+template<bool CHECKED>
+class BasicByteReader
 {
 public:
 	constexpr static int VERSION = 2;
 	constexpr static bool READER = true;
 	constexpr static bool WRITER = false;
 
+	// Number of readable bytes that have to follow end of padded input.
+	constexpr static uint32_t INPUT_PADDING = 8;
+	// Marks input followed by at least INPUT_PADDING readable bytes, which
+	// are not part of data (like padded receive buffers). Then integers and
+	// VAR_UINTs are read with single 8 byte loads also at the end of data.
+	struct Padded {};
+
 	template<typename TT>
-	constexpr ByteReader &op(TT &item)
+	constexpr BasicByteReader &op(TT &item)
 	{
 		using T = std::remove_cvref_t<decltype(item)>;
 		if constexpr (requires { item.serialize(*this); }) {
 			item.serialize(*this);
 		} else if constexpr (requires {
-								 serializer<ByteReader, T>::op(*this, item);
+								 serializer<BasicByteReader, T>::op(*this, item);
 							 }) {
-			serializer<ByteReader, T>::op(*this, item);
+			serializer<BasicByteReader, T>::op(*this, item);
 		} else if constexpr (requires { serialize(*this, item); }) {
 			serialize(*this, (T &)item);
 		} else {
-			static_assert(
-				!"unimplemented bitscpp deserialization function or method");
+			static_assert(sizeof(T) == 0,
+				"unimplemented bitscpp deserialization function or method");
 		}
 		return *this;
 	}
 
 public:
-	inline ByteReader(const uint8_t *buffer, uint32_t offset, uint32_t size)
+	inline BasicByteReader(const uint8_t *buffer, uint32_t offset,
+						   uint32_t size)
 		: _buffer(buffer), ptr(buffer ? buffer + offset : nullptr),
 		  end(buffer ? buffer + size : nullptr), total_size(buffer ? size : 0),
 		  errors(0)
@@ -57,9 +96,14 @@ public:
 			set_error(ERROR_BUFFER_NULLPTR);
 		}
 	}
-	inline ByteReader(const uint8_t *buffer, uint32_t size)
-		: ByteReader(buffer, 0, size)
+	inline BasicByteReader(const uint8_t *buffer, uint32_t size)
+		: BasicByteReader(buffer, 0, size)
+	{
+	}
+	inline BasicByteReader(const uint8_t *buffer, uint32_t size, Padded)
+		: BasicByteReader(buffer, 0, size)
 	{
+		tail_padding = INPUT_PADDING;
 	}
 
 public:
@@ -74,79 +118,254 @@ public:
 	bool is_next_float64() const;
 	bool is_next_bool() const;
 	bool is_next_string() const;
+	// Also true for sorted map.
 	bool is_next_map() const;
+	bool is_next_sorted_map() const;
+	// Also true for indexed array.
 	bool is_next_array() const;
+	bool is_next_indexed_array() const;
+	bool is_next_packed_array() const;
+	// Packed array of halves.
+	bool is_next_half_array() const;
+	bool is_next_bit_array() const;
 	bool is_next_beg_object() const;
+	bool is_next_sized_object() const;
 	bool is_next_end_object() const;
 
 public:
 	// strings
-	ByteReader &op_sized_byte_array_header(uint32_t &bytes);
-	ByteReader &op_sized_string_header(uint32_t &bytes);
+	BasicByteReader &op_sized_byte_array_header(uint32_t &bytes);
+	BasicByteReader &op_sized_string_header(uint32_t &bytes);
 
-	ByteReader &op(std::string_view &str);
-	ByteReader &op_byte_array(char const **str, uint32_t &size);
-	ByteReader &op(char const *&str, uint32_t &size);
-	ByteReader &op(std::string &str);
+	BasicByteReader &op(std::string_view &str);
+	BasicByteReader &op_byte_array(char const **str, uint32_t &size);
+	BasicByteReader &op(char const *&str, uint32_t &size);
+	BasicByteReader &op(std::string &str);
 
 	// byte array
-	ByteReader &op_byte_array(uint8_t const **data, uint32_t &bytes);
-	ByteReader &op_byte_array(uint8_t const *&data, uint32_t &bytes);
-	ByteReader &op_byte_array(std::vector<uint8_t> &data);
-	ByteReader &op(std::vector<uint8_t> &data);
-	ByteReader &op_byte_array(std::vector<char> &data);
-	ByteReader &op(std::vector<char> &data);
+	BasicByteReader &op_byte_array(uint8_t const **data, uint32_t &bytes);
+	BasicByteReader &op_byte_array(uint8_t const *&data, uint32_t &bytes);
+	BasicByteReader &op_byte_array(std::vector<uint8_t> &data);
+	BasicByteReader &op(std::vector<uint8_t> &data);
+	BasicByteReader &op_byte_array(std::vector<char> &data);
+	BasicByteReader &op(std::vector<char> &data);
 
 	// miscelanous
-	ByteReader &op(bool &v);
-	ByteReader &op_boolean(bool &v);
-	ByteReader &op_begin_object();
-	ByteReader &op_end_object();
+	BasicByteReader &op(bool &v);
+	BasicByteReader &op_boolean(bool &v);
+	BasicByteReader &op_begin_object();
+	BasicByteReader &op_end_object();
+	// Accepts also object without size, then offset is 0. When object is
+	// sized, op_end_sized_object() skips not read remainder of object.
+	BasicByteReader &op_begin_sized_object(uint32_t &offset);
+	BasicByteReader &op_end_sized_object(uint32_t offset);
+	// Skips whole sized object without decoding it.
+	BasicByteReader &skip_object();
 
 	// integers
-	ByteReader &op(uint8_t &v);
-	ByteReader &op(uint16_t &v);
-	ByteReader &op(uint32_t &v);
-	ByteReader &op(uint64_t &v);
-	ByteReader &op(int8_t &v);
-	ByteReader &op(int16_t &v);
-	ByteReader &op(int32_t &v);
-	ByteReader &op(int64_t &v);
-	ByteReader &op(char &v);
-
-	ByteReader &op_uint(uint64_t &v);
-	ByteReader &op_int(int64_t &v);
+	BasicByteReader &op(uint8_t &v);
+	BasicByteReader &op(uint16_t &v);
+	BasicByteReader &op(uint32_t &v);
+	BasicByteReader &op(uint64_t &v);
+	BasicByteReader &op(int8_t &v);
+	BasicByteReader &op(int16_t &v);
+	BasicByteReader &op(int32_t &v);
+	BasicByteReader &op(int64_t &v);
+	BasicByteReader &op(char &v);
+
+	BasicByteReader &op_uint(uint64_t &v);
+	BasicByteReader &op_int(int64_t &v);
 
 	// floats
-	ByteReader &op_half(float &v);
-	ByteReader &op_bfloat(float &v);
-	ByteReader &op_float(float &v);
-	ByteReader &op_double(double &v);
+	BasicByteReader &op_half(float &v);
+	BasicByteReader &op_bfloat(float &v);
+	BasicByteReader &op_float(float &v);
+	BasicByteReader &op_double(double &v);
 	static void _read_half(const uint8_t *ptr, float &v);
 	static void _read_bfloat(const uint8_t *ptr, float &v);
 	static void _read_float(const uint8_t *ptr, float &v);
 	static void _read_double(const uint8_t *ptr, double &v);
-	ByteReader &op(float &v);
-	ByteReader &op(double &v);
+	BasicByteReader &op(float &v);
+	BasicByteReader &op(double &v);
+
+	// map, accepts also sorted map, then its offset table is skipped
+	BasicByteReader &op_map_header(uint32_t &elements);
+
+	// array, accepts also indexed array, then its offset table is skipped
+	BasicByteReader &op_array_header(uint32_t &elements);
+	// Number of elements of array which header is next, without reading it,
+	// 0 when next value is not an array.
+	uint32_t array_element_count() const;
+	// Reads header of indexed array and moves to its first element. Accepts
+	// also array without offset table.
+	BasicByteReader &op_indexed_array_header(IndexedArray &array);
+	// Moves to element i of array read from this buffer by
+	// op_indexed_array_header(), in O(1) when array has offset table,
+	// otherwise elements before i are skipped with skip_values(). Index
+	// equal to number of elements moves after array.
+	BasicByteReader &seek_array_element(const IndexedArray &array,
+										uint32_t i);
 
-	// map
-	ByteReader &op_map_header(uint32_t &elements);
+	// packed array of fixed size numbers
+	BasicByteReader &op_packed_array_header(PackedArrayType &type,
+											uint32_t &elements);
+	// Requires exactly given type and number of elements.
+	BasicByteReader &op_packed_array(PackedArrayType type, void *data,
+									 uint32_t elements);
+	// Packed array of halves (PACKED_HALF), converted to floats. Requires
+	// exactly given number of elements.
+	BasicByteReader &op_half_array(float *data, uint32_t elements);
+	BasicByteReader &op_half_array(std::vector<float> &data);
 
-	// array
-	ByteReader &op_array_header(uint32_t &elements);
+	// bit array, one bit per boolean
+	BasicByteReader &op_bit_array_header(uint32_t &elements);
+	// Element i is bit (i % 8) of bits[i / 8], bits point into read buffer.
+	BasicByteReader &op_bit_array(const uint8_t *&bits, uint32_t &elements);
+	// Requires exactly given number of elements.
+	BasicByteReader &op_bit_array(bool *data, uint32_t elements);
+	BasicByteReader &op_bit_array(std::vector<bool> &data);
+	// Accepts both bit array and array of booleans.
+	BasicByteReader &op(std::vector<bool> &data);
 
-	ByteReader &op_untyped_var_uint(uint64_t &v);
-	ByteReader &op_untyped_var_int(int64_t &v);
+	BasicByteReader &op_untyped_var_uint(uint64_t &v);
+	BasicByteReader &op_untyped_var_int(int64_t &v);
 
-	ByteReader &op_untyped_uint32(uint32_t &v);
+	BasicByteReader &op_untyped_uint32(uint32_t &v);
 
 	// util
-	ByteReader &skip(uint32_t bytes);
+	BasicByteReader &skip(uint32_t bytes);
+	// Skips next value of any type, arrays, maps and objects together with
+	// all nested values, without decoding them. Values of size known from
+	// header are skipped in O(1), nesting is walked with explicit stack.
+	// Nesting of skipped values is checked like in v2::validate(), also
+	// by UncheckedByteReader.
+	BasicByteReader &skip_next_value();
+	BasicByteReader &skip_values(uint32_t values);
 
 public:
+	template <PackedElement T>
+	inline BasicByteReader &op_packed_array(T *data, uint32_t elements)
+	{
+		return op_packed_array(packed_array_type<T>::value, data, elements);
+	}
+
+	template <PackedElement T>
+	inline BasicByteReader &op_packed_array(std::vector<T> &arr)
+	{
+		PackedArrayType type;
+		uint32_t elements = 0;
+		op_packed_array_header(type, elements);
+		if (get_errors()) {
+			[[unlikely]];
+			return *this;
+		}
+		if (type != packed_array_type<T>::value) {
+			[[unlikely]];
+			set_error(ERROR_TYPE_MISMATCH);
+			return *this;
+		}
+		arr.resize(elements);
+		return _read_packed_array_data(arr.data(), elements, sizeof(T));
+	}
+
+	template <size_t N> inline BasicByteReader &op(std::bitset<N> &bits)
+	{
+		const uint8_t *data = nullptr;
+		uint32_t elements = 0;
+		op_bit_array(data, elements);
+		if (get_errors()) {
+			[[unlikely]];
+			return *this;
+		}
+		if (elements != N) {
+			[[unlikely]];
+			set_error(ERROR_TYPE_MISMATCH);
+			return *this;
+		}
+		for (uint32_t i = 0; i < N; ++i) {
+			bits[i] = (data[i >> 3] >> (i & 7)) & 1;
+		}
+		return *this;
+	}
+
+	// Same as op_packed_array(), for symmetry with ByteWriter.
+	template <PackedElement T>
+	inline BasicByteReader &op_aligned_packed_array(T *data, uint32_t elements)
+	{
+		return op_packed_array(data, elements);
+	}
+	template <PackedElement T>
+	inline BasicByteReader &op_aligned_packed_array(std::vector<T> &arr)
+	{
+		return op_packed_array(arr);
+	}
+
+	// Same as op(), indexed array is read like any array, for symmetry with
+	// ByteWriter.
 	template <typename T>
-	inline ByteReader &op(T *data, const uint32_t elements)
+	inline BasicByteReader &op_indexed_array(T *data, uint32_t elements)
 	{
+		return op(data, elements);
+	}
+	template <typename T>
+	inline BasicByteReader &op_indexed_array(std::vector<T> &arr)
+	{
+		return op(arr);
+	}
+
+	// Returns view of packed array data inside read buffer, when data is
+	// aligned for T and host is little endian. Otherwise data is copied into
+	// storage and view of storage is returned. Use
+	// ByteWriter::op_aligned_packed_array() to write data that can be viewed
+	// in place.
+	template <PackedElement T>
+	inline BasicByteReader &op_packed_array_view(std::span<const T> &view,
+												 std::vector<T> &storage)
+	{
+		view = {};
+		PackedArrayType type;
+		uint32_t elements = 0;
+		op_packed_array_header(type, elements);
+		if (get_errors()) {
+			[[unlikely]];
+			return *this;
+		}
+		if (type != packed_array_type<T>::value) {
+			[[unlikely]];
+			set_error(ERROR_TYPE_MISMATCH);
+			return *this;
+		}
+		if (Endian::little && (uintptr_t)ptr % alignof(T) == 0) {
+			[[likely]];
+			view = {(const T *)ptr, elements};
+			ptr += (size_t)elements * sizeof(T);
+			return *this;
+		}
+		storage.resize(elements);
+		_read_packed_array_data(storage.data(), elements, sizeof(T));
+		view = storage;
+		return *this;
+	}
+
+	// Accepts both array and packed array, or bit array for bool, or packed
+	// array of halves for float.
+	template <typename T>
+	inline BasicByteReader &op(T *data, const uint32_t elements)
+	{
+		if constexpr (std::is_same_v<T, float>) {
+			if (is_next_half_array()) {
+				return op_half_array(data, elements);
+			}
+		}
+		if constexpr (PackedElement<T>) {
+			if (is_next_packed_array()) {
+				return op_packed_array(data, elements);
+			}
+		} else if constexpr (std::is_same_v<T, bool>) {
+			if (is_next_bit_array()) {
+				return op_bit_array(data, elements);
+			}
+		}
 		uint32_t size = 0;
 		op_array_header(size);
 		if (get_errors()) {
@@ -165,13 +384,28 @@ public:
 			set_error(ERROR_BUFFER_TOO_SMALL);
 			return *this;
 		}
+		if constexpr (requires { _op_int_array(data, elements); }) {
+			return _op_int_array(data, elements);
+		}
 		for (uint32_t i = 0; i < elements && errors == 0; ++i)
 			op(data[i]);
 		return *this;
 	}
 
-	template <typename T> inline ByteReader &op(std::vector<T> &arr)
+	// Accepts both array and packed array, or packed array of halves for
+	// float.
+	template <typename T> inline BasicByteReader &op(std::vector<T> &arr)
 	{
+		if constexpr (std::is_same_v<T, float>) {
+			if (is_next_half_array()) {
+				return op_half_array(arr);
+			}
+		}
+		if constexpr (PackedElement<T>) {
+			if (is_next_packed_array()) {
+				return op_packed_array(arr);
+			}
+		}
 		uint32_t elems = 0;
 		op_array_header(elems);
 		if (get_errors()) {
@@ -183,7 +417,7 @@ public:
 			set_error(ERROR_ARRAY_TOO_BIG);
 			return *this;
 		}
-		if (elems > get_remaining_bytes()) {
+		if (CHECKED && elems > get_remaining_bytes()) {
 			[[unlikely]];
 			set_error(ERROR_ARRAY_TOO_BIG);
 			set_error(ERROR_TYPE_MISMATCH);
@@ -191,11 +425,29 @@ public:
 			return *this;
 		}
 		arr.resize(elems);
+		if constexpr (requires { _op_int_array(arr.data(), elems); }) {
+			return _op_int_array(arr.data(), elems);
+		}
 		for (uint32_t i = 0; i < elems && errors == 0; ++i)
 			op(arr[i]);
 		return *this;
 	}
 
+	// Accepts both map and sorted map.
+	template <typename K, typename V>
+	inline BasicByteReader &op(std::map<K, V> &map)
+	{
+		map.clear();
+		uint32_t entries = 0;
+		op_map_header(entries);
+		for (uint32_t i = 0; i < entries && errors == 0; ++i) {
+			K key{};
+			op(key);
+			op(map[std::move(key)]);
+		}
+		return *this;
+	}
+
 	bool is_valid() const;
 	Errors get_errors() const;
 	bool has_any_more() const;
@@ -207,6 +459,29 @@ public:
 
 protected:
 	bool has_bytes_to_read(uint32_t bytes) const;
+	// Reads 1 to 8 bytes at ptr, with single 8 byte load when there are 8
+	// readable bytes including tail padding.
+	uint64_t _read_bytes(int bytes) const;
+
+	// Bulk decoding of integer array elements.
+	BasicByteReader &_op_int_array(int8_t *data, uint32_t elements);
+	BasicByteReader &_op_int_array(int16_t *data, uint32_t elements);
+	BasicByteReader &_op_int_array(int32_t *data, uint32_t elements);
+	BasicByteReader &_op_int_array(int64_t *data, uint32_t elements);
+	BasicByteReader &_op_int_array(uint8_t *data, uint32_t elements);
+	BasicByteReader &_op_int_array(uint16_t *data, uint32_t elements);
+	BasicByteReader &_op_int_array(uint32_t *data, uint32_t elements);
+	BasicByteReader &_op_int_array(uint64_t *data, uint32_t elements);
+	template<typename T>
+	BasicByteReader &_op_int_array_impl(T *data, uint32_t elements);
+
+	// Copies data of packed array after its header was read.
+	BasicByteReader &_read_packed_array_data(void *data, uint32_t elements,
+											 uint32_t elementSize);
+	// Reads count and offset table of indexed array or sorted map after its
+	// header was read.
+	BasicByteReader &_op_offset_table(IndexedArray &array,
+									  uint32_t valuesPerElement);
 
 	uint8_t const *_buffer = nullptr;
 
@@ -215,9 +490,25 @@ protected:
 
 	uint32_t total_size = 0;
 	uint32_t errors = 0;
+	// Readable bytes after end, 0 or INPUT_PADDING.
+	uint32_t tail_padding = 0;
+
+	template<bool> friend class BasicMapView;
 };
 
+using ByteReader = BasicByteReader<true>;
+using UncheckedByteReader = BasicByteReader<false>;
+
+#ifndef BITSCPP_HEADER_ONLY
+extern template class BasicByteReader<true>;
+extern template class BasicByteReader<false>;
+#endif
+
 } // namespace v2
 } // namespace bitscpp
 
+#ifdef BITSCPP_HEADER_ONLY
+#include "../../src/ByteReader_v2.inl.hpp"
+#endif
+
 #endif
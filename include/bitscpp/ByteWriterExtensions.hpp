@@ -58,6 +58,42 @@ struct serializer<v2::ByteWriter<BT>, std::unordered_set<T>> {
 			s.op(v);
 	}
 };
+
+template<typename T>
+struct serializer<v2::SizeCounter, std::set<T>> {
+	static inline void op(v2::SizeCounter& s, const std::set<T>& set) {
+		s.op((uint32_t)set.size());
+		for(auto& v : set)
+			s.op(v);
+	}
+};
+template<typename T>
+struct serializer<v2::SizeCounter, std::unordered_set<T>> {
+	static inline void op(v2::SizeCounter& s, const std::unordered_set<T>& set) {
+		s.op((uint32_t)set.size());
+		for(auto& v : set)
+			s.op(v);
+	}
+};
+
+template<typename T>
+struct serializer<v2::MaxSizeCounter, std::set<T>> {
+	static inline void op(v2::MaxSizeCounter& s, const std::set<T>& set) {
+		s.fixed = false;
+		s.op((uint32_t)set.size());
+		for(auto& v : set)
+			s.op(v);
+	}
+};
+template<typename T>
+struct serializer<v2::MaxSizeCounter, std::unordered_set<T>> {
+	static inline void op(v2::MaxSizeCounter& s, const std::unordered_set<T>& set) {
+		s.fixed = false;
+		s.op((uint32_t)set.size());
+		for(auto& v : set)
+			s.op(v);
+	}
+};
 } // namespace bitscpp
 
 #endif
@@ -10,12 +10,21 @@
 #include <cstring>
 #include <cassert>
 
+#include <algorithm>
+#include <bitset>
+#include <map>
+#include <concepts>
 #include <string>
 #include <string_view>
+#include <type_traits>
 #include <vector>
 
 #include "V2_Specification.hpp"
 #include "SerizalizerClass.hpp"
+#include "SizeCounter_v2.hpp"
+
+#include "../../src/IntegerArray_v2.inl.hpp"
+#include "../../src/BitArray_v2.inl.hpp"
 
 /*
  * Type BT requires following interface:
@@ -30,12 +39,61 @@
  * };
  *
  * behavior should be similar to std::vector<uint8_t>
+ *
+ * BT can provide `void reserve_exact(size_t newCapacity)`, which is used
+ * instead of reserve() when final size is known, like in op_exact().
+ *
+ * Optionally BT can provide cursor interface. Then ByteWriter keeps raw write
+ * cursor into window of buffer memory and calls BT only when window is
+ * exhausted, while size() of BT is updated only on ByteWriter::Commit():
+ * class BT {
+ *   // Appends bytes written into current window up to cursor (nullptr when no
+ *   // window is open) and returns new window of at least `bytes` writable
+ *   // bytes starting at offset size(), end of window is stored in `end`.
+ *   // Returns nullptr when window cannot be provided. Requested size may be
+ *   // only an upper bound of data to be written, after failure ByteWriter
+ *   // retries with smaller requests.
+ *   uint8_t *next_window(uint8_t *cursor, size_t bytes, uint8_t *&end);
+ *   // Appends bytes written into current window up to cursor and closes it.
+ *   void commit_window(uint8_t *cursor);
+ *   size_t size();
+ *   void write(const uint8_t *data, uint32_t bytes);
+ * };
+ *
+ * See CursorWrapper.hpp, FixedBufferWrapper.hpp, SegmentedBuffer.hpp and
+ * StreamBuffer.hpp.
+ *
+ * Cursor BT which does not keep whole output in memory (like StreamBuffer)
+ * can define `constexpr static bool UNLIMITED_SIZE = true`, then output is
+ * not limited by MAX_BUFFER_SIZE and GetSize() wraps around.
+ *
+ * BT can provide `void write_reference(const uint8_t *data, uint32_t bytes)`
+ * to store pointer to external data instead of copying it, used by
+ * op_byte_array_ref().
+ *
+ * Contents of BT are unspecified between first write and ByteWriter::Commit().
+ *
+ * ByteWriter<UncheckedBuffer> writes into memory already reserved by other
+ * ByteWriter, without any capacity checks.
  */
 
 namespace bitscpp
 {
 namespace v2
 {
+template<typename BT>
+concept CursorBuffer = requires(BT &buffer, uint8_t *cursor, uint8_t *&end) {
+	{ buffer.next_window(cursor, (size_t)1, end) } -> std::same_as<uint8_t *>;
+	buffer.commit_window(cursor);
+};
+
+struct UncheckedBuffer {
+	inline size_t size() const { return 0; }
+	inline uint8_t *next_window(uint8_t *, size_t, uint8_t *&) { return nullptr; }
+	inline void commit_window(uint8_t *) {}
+	inline void write(const uint8_t *, uint32_t) {}
+};
+
 template<typename BT>
 class ByteWriter
 {
@@ -43,16 +101,50 @@ public:
 	constexpr static int VERSION = 2;
 	constexpr static bool READER = false;
 	constexpr static bool WRITER = true;
+	constexpr static bool CURSOR = CursorBuffer<BT>;
+	constexpr static bool UNCHECKED = std::is_same_v<BT, UncheckedBuffer>;
+	constexpr static bool UNLIMITED_SIZE =
+		requires { requires BT::UNLIMITED_SIZE; };
+	// Written bytes can be modified later, required by sized objects,
+	// indexed arrays and sorted maps.
+	constexpr static bool RANDOM_ACCESS =
+		UNCHECKED || requires(BT &buffer) { buffer.data(); };
+
+	// In cursor mode byte arrays at least this big are passed directly to
+	// BT::write() instead of being copied into window.
+	constexpr static uint32_t CURSOR_DIRECT_WRITE_THRESHOLD = 4096;
+
+	// Writers to UNLIMITED_SIZE buffers (streams) request windows of at most
+	// this many bytes, so that staging buffer does not grow with output.
+	// Arrays of types with max_encoded_size are encoded in chunks of this
+	// bound, other items with bigger bounds are written with capacity checks.
+	constexpr static size_t UNLIMITED_SIZE_MAX_BOUND = 16 * 1024;
+
+	// Writers with window (cursor mode and unchecked writer) encode numbers
+	// with single 8 byte store when window has impl::WIDE_STORE_BYTES
+	// writable bytes, bytes stored past encoded value are overwritten by
+	// following writes. Unchecked writer gets this many bytes past its
+	// bound, so that wide stores can be used up to end of bound.
+	constexpr static uint32_t WIDE_STORE_SLACK = impl::WIDE_STORE_BYTES - 1;
 
 	template<typename TT>
 	inline constexpr ByteWriter &op(const TT &item)
 	{
 		using T = std::remove_cvref_t<decltype(item)>;
 		if constexpr (requires { item.serialize(*this); }) {
-			item.serialize(*this);
+			if constexpr (UNCHECKED == false &&
+						  requires { max_encoded_size<T>::value; } &&
+						  requires(ByteWriter<UncheckedBuffer> &writer) {
+							  item.serialize(writer);
+						  }) {
+				_op_unchecked(max_encoded_size<T>::value,
+							  [&](auto &writer) { item.serialize(writer); });
+			} else {
+				item.serialize(*this);
+			}
 		} else if constexpr (requires { ((T &)item).serialize(*this); }) {
 			// TODO: remove this branch
-			static_assert(!"Consider removing this branch");
+			static_assert(sizeof(T) == 0, "Consider removing this branch");
 			((T &)item).serialize(*this);
 		} else if constexpr (requires {
 				bitscpp::serializer<ByteWriter<BT>, T>::op(*this, item);
@@ -67,11 +159,11 @@ public:
 			serialize(*this, item);
 		} else if constexpr (requires { serialize(*this, *(T *)&item); }) {
 			// TODO: remove this branch
-			static_assert(!"Consider removing this branch");
+			static_assert(sizeof(T) == 0, "Consider removing this branch");
 			serialize(*this, *(T *)&item);
 		} else {
-			static_assert(
-				!"Unimplemented bitscpp serialization function or method");
+			static_assert(sizeof(T) == 0,
+				"Unimplemented bitscpp serialization function or method");
 		}
 		return *this;
 	}
@@ -79,15 +171,30 @@ public:
 public:
 	inline uint32_t GetSize() const
 	{
+		if constexpr (UNCHECKED) {
+			return _windowOffset + (_ptr - _window);
+		}
 		if (_buffer == nullptr)
 			return 0;
-		return _buffer->size();
+		if constexpr (CURSOR) {
+			return _buffer->size() + (_ptr - _window);
+		} else {
+			return _buffer->size();
+		}
 	}
 
-	inline void Init(BT *buffer) { _buffer = buffer; }
+	inline void Init(BT *buffer)
+	{
+		_buffer = buffer;
+		_ptr = _end = _window = nullptr;
+	}
 	inline ByteWriter() { Init(nullptr); }
 	inline ByteWriter(BT *buffer) { Init(buffer); }
 
+	// Makes all written bytes part of buffer. Required before using buffer
+	// in cursor mode, no-op otherwise.
+	void Commit();
+
 	// strings
 	ByteWriter &op_sized_byte_array_header(uint32_t bytes);
 	ByteWriter &op_sized_string_header(uint32_t bytes);
@@ -105,6 +212,9 @@ public:
 	ByteWriter &op(const std::vector<uint8_t> &data);
 	ByteWriter &op_byte_array(const std::vector<char> &data);
 	ByteWriter &op(const std::vector<char> &data);
+	// Encodes same bytes as op_byte_array(), but when BT provides
+	// write_reference() data is only referenced by BT and has to outlive it.
+	ByteWriter &op_byte_array_ref(const uint8_t *data, uint32_t bytes);
 
 	// miscelanous
 	ByteWriter &op(bool v);
@@ -113,6 +223,11 @@ public:
 	ByteWriter &op_true();
 	ByteWriter &op_begin_object();
 	ByteWriter &op_end_object();
+	// Begins object with byte length, which can be skipped by
+	// ByteReader::skip_object(). Requires BT::data(). Offset has to be passed
+	// to matching op_end_sized_object().
+	ByteWriter &op_begin_sized_object(uint32_t &offset);
+	ByteWriter &op_end_sized_object(uint32_t offset);
 
 	// integers
 	ByteWriter &op(uint8_t v);
@@ -138,9 +253,46 @@ public:
 
 	// map
 	ByteWriter &op_map_header(uint32_t elements);
+	// Map with keys in ascending order (see SPECIFICATION.md), where
+	// MapView::find() uses binary search. Requires BT::data(). Like with
+	// indexed array, after key and value of every entry
+	// op_end_sorted_map_entry() has to be called with its index, and after
+	// all entries op_end_sorted_map(). Order of keys is not checked.
+	ByteWriter &op_begin_sorted_map(uint32_t entries, uint32_t &offset);
+	ByteWriter &op_end_sorted_map_entry(uint32_t offset, uint32_t i);
+	ByteWriter &op_end_sorted_map(uint32_t offset, uint32_t entries);
 
 	// array
 	ByteWriter &op_array_header(uint32_t elements);
+	// Array with table of offsets of elements, which allows
+	// ByteReader::seek_array_element() to reach any element in O(1).
+	// Requires BT::data(). Every element is a single value, after it
+	// op_end_indexed_array_element() has to be called with its index, and
+	// after all elements op_end_indexed_array(). Table is written with 4
+	// bytes per entry and shrunk to 1 or 2 bytes when elements are small.
+	ByteWriter &op_begin_indexed_array(uint32_t elements, uint32_t &offset);
+	ByteWriter &op_end_indexed_array_element(uint32_t offset, uint32_t i);
+	ByteWriter &op_end_indexed_array(uint32_t offset, uint32_t elements);
+
+	// packed array of fixed size numbers, data is stored without headers
+	ByteWriter &op_packed_array_header(PackedArrayType type, uint32_t elements,
+									   bool aligned = false);
+	ByteWriter &op_packed_array(PackedArrayType type, const void *data,
+								uint32_t elements);
+	// Pads data to offset from beginning of buffer divisible by element
+	// size, so that ByteReader::op_packed_array_view() can return view into
+	// read buffer.
+	ByteWriter &op_aligned_packed_array(PackedArrayType type, const void *data,
+										uint32_t elements);
+	// Packed array of halves (PACKED_HALF), converted from floats.
+	ByteWriter &op_half_array(const float *data, uint32_t elements);
+	ByteWriter &op_half_array(const std::vector<float> &data);
+
+	// bit array, one bit per boolean
+	ByteWriter &op_bit_array_header(uint32_t elements);
+	ByteWriter &op_bit_array(const bool *data, uint32_t elements);
+	ByteWriter &op_bit_array(const std::vector<bool> &data);
+	ByteWriter &op(const std::vector<bool> &data);
 
 	ByteWriter &op_untyped_var_uint(uint64_t value);
 	ByteWriter &op_untyped_var_int(int64_t value);
@@ -159,6 +311,27 @@ public:
 			set_error(ERROR_ARRAY_TOO_BIG);
 			return *this;
 		}
+		if constexpr (UNCHECKED == false &&
+					  requires { max_encoded_size<T>::value; }) {
+			size_t maxBytes = MaxSizeCounter::MAX_HEADER_SIZE +
+							  max_encoded_size<T>::value * (size_t)elements;
+			if constexpr (impl::BatchInteger<T>) {
+				maxBytes += impl::INT_ARRAY_SLACK;
+			}
+			if constexpr (UNLIMITED_SIZE) {
+				if (maxBytes > UNLIMITED_SIZE_MAX_BOUND) {
+					return _op_array_in_chunks(data, elements);
+				}
+			}
+			return _op_unchecked(maxBytes, [&](auto &writer) {
+				writer.op(data, elements);
+			});
+		}
+		if constexpr (UNCHECKED && impl::BatchInteger<T>) {
+			op_array_header(elements);
+			_op_array_elements(data, elements);
+			return *this;
+		}
 		_reserve_expand(32 + sizeof(T) * elements);
 		op_array_header(elements);
 		for (uint32_t i = 0; i < elements; ++i)
@@ -176,18 +349,306 @@ public:
 		return op<T>(arr.data(), arr.size());
 	}
 
+	template <typename T>
+	inline ByteWriter &op_indexed_array(const T *data, uint32_t elements)
+	{
+		uint32_t offset = 0;
+		op_begin_indexed_array(elements, offset);
+		for (uint32_t i = 0; i < elements && errors == 0; ++i) {
+			op(data[i]);
+			op_end_indexed_array_element(offset, i);
+		}
+		return op_end_indexed_array(offset, elements);
+	}
+
+	template <typename T>
+	inline ByteWriter &op_indexed_array(const std::vector<T> &arr)
+	{
+		if (arr.size() > MAX_ARRAY_ELEMENTS) {
+			set_error(ERROR_ARRAY_TOO_BIG);
+			return *this;
+		}
+		return op_indexed_array<T>(arr.data(), arr.size());
+	}
+
+	template <typename K, typename V>
+	inline ByteWriter &op(const std::map<K, V> &map)
+	{
+		if (map.size() > MAX_ARRAY_ELEMENTS) {
+			set_error(ERROR_ARRAY_TOO_BIG);
+			return *this;
+		}
+		op_map_header(map.size());
+		for (const auto &[key, value] : map) {
+			op(key);
+			op(value);
+		}
+		return *this;
+	}
+
+	// Sorted map when keys are integers or strings, otherwise (and for empty
+	// map or unsigned 64-bit keys above INT64_MAX) map, the same as op().
+	// Requires BT::data().
+	template <typename K, typename V>
+	inline ByteWriter &op_sorted_map(const std::map<K, V> &map)
+	{
+		if (map.size() > MAX_ARRAY_ELEMENTS) {
+			set_error(ERROR_ARRAY_TOO_BIG);
+			return *this;
+		}
+		if (impl::writes_sorted_map(map) == false) {
+			return op(map);
+		}
+		uint32_t offset = 0;
+		uint32_t i = 0;
+		op_begin_sorted_map(map.size(), offset);
+		for (const auto &[key, value] : map) {
+			if (errors != 0) {
+				[[unlikely]];
+				break;
+			}
+			op(key);
+			op(value);
+			op_end_sorted_map_entry(offset, i++);
+		}
+		return op_end_sorted_map(offset, map.size());
+	}
+
+	template <PackedElement T>
+	inline ByteWriter &op_packed_array(const T *data, uint32_t elements)
+	{
+		return op_packed_array(packed_array_type<T>::value, data, elements);
+	}
+
+	template <PackedElement T>
+	inline ByteWriter &op_packed_array(const std::vector<T> &arr)
+	{
+		if (arr.size() > MAX_ARRAY_ELEMENTS) {
+			set_error(ERROR_ARRAY_TOO_BIG);
+			return *this;
+		}
+		return op_packed_array(arr.data(), arr.size());
+	}
+
+	template <PackedElement T>
+	inline ByteWriter &op_aligned_packed_array(const T *data, uint32_t elements)
+	{
+		return op_aligned_packed_array(packed_array_type<T>::value, data,
+									   elements);
+	}
+
+	template <PackedElement T>
+	inline ByteWriter &op_aligned_packed_array(const std::vector<T> &arr)
+	{
+		if (arr.size() > MAX_ARRAY_ELEMENTS) {
+			set_error(ERROR_ARRAY_TOO_BIG);
+			return *this;
+		}
+		return op_aligned_packed_array(arr.data(), arr.size());
+	}
+
+	template <size_t N> inline ByteWriter &op(const std::bitset<N> &bits)
+	{
+		return _op_bit_array(N, [&](uint8_t *dst, uint32_t first,
+									uint32_t count) {
+			memset(dst, 0, impl::bit_array_bytes(count));
+			for (uint32_t i = 0; i < count; ++i) {
+				dst[i >> 3] |= (uint8_t)bits[first + i] << (i & 7);
+			}
+		});
+	}
+
+	// Reserves upper bound of encoded size of item once and encodes it
+	// without further capacity checks.
+	template <typename T> inline ByteWriter &op_bounded(const T &item)
+	{
+		if constexpr (UNCHECKED) {
+			return op(item);
+		} else {
+			MaxSizeCounter counter;
+			counter.op(item);
+			if (counter.errors != 0) {
+				[[unlikely]];
+				return op(item);
+			}
+			return _op_unchecked(counter.size,
+								 [&](auto &writer) { writer.op(item); });
+		}
+	}
+
+	// Reserves exact encoded size of item once and encodes it without
+	// further capacity checks.
+	template <typename T> inline ByteWriter &op_exact(const T &item)
+	{
+		if constexpr (UNCHECKED) {
+			return op(item);
+		} else {
+			const size_t bytes = encoded_size(item, GetSize());
+			_reserve_exact(bytes);
+			return _op_unchecked(bytes, [&](auto &writer) { writer.op(item); });
+		}
+	}
+
+private:
+	// Elements of array after its header.
+	template <typename T>
+	inline void _op_array_elements(const T *data, uint32_t elements)
+	{
+		if constexpr (UNCHECKED && impl::BatchInteger<T>) {
+			if ((size_t)(_end - _ptr) >=
+				max_encoded_size<T>::value * (size_t)elements +
+					impl::INT_ARRAY_SLACK) {
+				[[likely]];
+				_ptr = impl::encode_int_array(_ptr, data, elements);
+				return;
+			}
+		}
+		for (uint32_t i = 0; i < elements; ++i)
+			op(data[i]);
+	}
+
+	// Array of type with max_encoded_size, with bound reserved separately
+	// for every chunk of UNLIMITED_SIZE_MAX_BOUND bytes.
+	template <typename T>
+	inline ByteWriter &_op_array_in_chunks(const T *data, uint32_t elements)
+	{
+		op_array_header(elements);
+		constexpr size_t SLACK =
+			impl::BatchInteger<T> ? impl::INT_ARRAY_SLACK : 0;
+		constexpr uint32_t CHUNK = std::max<size_t>(
+			1, (UNLIMITED_SIZE_MAX_BOUND - SLACK) / max_encoded_size<T>::value);
+		for (uint32_t i = 0; i < elements; i += CHUNK) {
+			const uint32_t count = std::min(CHUNK, elements - i);
+			const size_t bytes = max_encoded_size<T>::value * count + SLACK;
+			_op_unchecked(bytes, [&](auto &writer) {
+				if constexpr (requires {
+								  writer._op_array_elements(data, count);
+							  }) {
+					writer._op_array_elements(data + i, count);
+				} else {
+					for (uint32_t j = 0; j < count; ++j)
+						writer.op(data[i + j]);
+				}
+			});
+		}
+		return *this;
+	}
+
+	template <typename F>
+	inline ByteWriter &_op_unchecked(size_t maxBytes, F &&write)
+	{
+		if constexpr (UNLIMITED_SIZE) {
+			if (maxBytes > UNLIMITED_SIZE_MAX_BOUND) {
+				[[unlikely]];
+				write(*this);
+				return *this;
+			}
+		}
+		size_t slack = WIDE_STORE_SLACK;
+		if constexpr (CURSOR) {
+			if ((size_t)(_end - _ptr) < maxBytes + slack) {
+				[[unlikely]];
+				if (_next_window(maxBytes + slack, false) == false) {
+					// Bound does not fit into fixed size BT, but encoded data
+					// still may.
+					SizeCounter counter;
+					counter.size = GetSize();
+					write(counter);
+					maxBytes = counter.size - GetSize();
+					slack = 0;
+				}
+			}
+		} else if (_buffer->capacity() - _buffer->size() < maxBytes + slack) {
+			// slack does not cause reallocation, exact reservation is kept
+			slack = 0;
+		}
+		uint8_t *p = _try_expand(maxBytes + slack);
+		if (p == nullptr) {
+			[[unlikely]];
+			return *this;
+		}
+		ByteWriter<UncheckedBuffer> writer;
+		writer._ptr = writer._window = p;
+		writer._end = p + maxBytes + slack;
+		writer._windowOffset = GetSize() - maxBytes - slack;
+		write(writer);
+		errors |= writer.errors;
+		assert(writer._ptr <= writer._end);
+		_shrink(writer._end - writer._ptr);
+		return *this;
+	}
+
+private:
+	// pack(dst, first, count) stores count elements starting from first.
+	template <typename F>
+	inline ByteWriter &_op_bit_array(uint32_t elements, F &&pack)
+	{
+		if (elements > MAX_ARRAY_ELEMENTS) {
+			[[unlikely]];
+			set_error(ERROR_ARRAY_TOO_BIG);
+			return *this;
+		}
+		const uint32_t bytes = impl::bit_array_bytes(elements);
+		if (CURSOR == false || bytes < CURSOR_DIRECT_WRITE_THRESHOLD) {
+			_reserve_expand(bytes + 10);
+		}
+		op_bit_array_header(elements);
+		// in chunks, so that cursor BT does not need window for whole array
+		constexpr uint32_t CHUNK = CURSOR_DIRECT_WRITE_THRESHOLD * 8;
+		for (uint32_t i = 0; i < elements; i += CHUNK) {
+			const uint32_t count = std::min(elements - i, CHUNK);
+			uint8_t *p = _try_expand(impl::bit_array_bytes(count));
+			if (p == nullptr) {
+				[[unlikely]];
+				return *this;
+			}
+			pack(p, i, count);
+		}
+		return *this;
+	}
+
+	ByteWriter &_op_packed_array(PackedArrayType type, const void *data,
+								 uint32_t elements, bool aligned);
+	// Writes header, count and table of 4 byte entries of indexed array or
+	// sorted map.
+	ByteWriter &_op_begin_offset_table(uint8_t header, uint32_t elements,
+									   uint32_t &offset);
+
 private:
 	void _append_byte(const uint8_t byte);
 	void _append(const uint8_t *data, uint32_t bytes);
 
 private:
+	// Pointer to already written byte at given offset.
+	uint8_t *_data_at(uint32_t offset);
+	// Returns true when window has impl::WIDE_STORE_BYTES writable bytes,
+	// always false without window.
+	bool _has_wide_window();
+	// In cursor mode at most sizeof(_scratch) bytes, never fails.
 	uint8_t *_expand(size_t bytesToExpand);
+	// Returns nullptr when buffer cannot be expanded.
+	uint8_t *_try_expand(size_t bytesToExpand);
+	void _shrink(size_t bytes);
 	void _reserve_expand(size_t bytesToExpand);
 	void _reserve(size_t newCapacity);
+	void _reserve_exact(size_t bytesToExpand);
+	// When not required, failure does not set error.
+	bool _next_window(size_t bytes, bool required = true);
+
+	template<typename> friend class ByteWriter;
 
 public:
 	BT *_buffer = nullptr;
 	uint32_t errors = 0;
+
+	// cursor mode only
+	uint8_t *_ptr = nullptr;
+	uint8_t *_end = nullptr;
+	uint8_t *_window = nullptr;
+	// written to instead of buffer when window cannot be provided
+	uint8_t _scratch[16];
+	// unchecked mode only, offset of _window in output
+	uint32_t _windowOffset = 0;
 };
 
 } // namespace v2
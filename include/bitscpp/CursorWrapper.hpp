@@ -0,0 +1,90 @@
+// Copyright (C) 2026 Marek Zalewski aka Drwalin
+//
+// This file is part of bitscpp project under MIT License
+// You should have received a copy of the MIT License along with this program.
+
+#ifndef BITSCPP_CURSOR_WRAPPER_HPP
+#define BITSCPP_CURSOR_WRAPPER_HPP
+
+#include <cstdint>
+#include <cstddef>
+
+#include <algorithm>
+
+#include "VectorWrapper.hpp"
+
+/*
+ * Provides cursor interface of v2::ByteWriter (see ByteWriter_v2.hpp) over
+ * BT with std::vector<uint8_t> like interface. Open window is part of
+ * underlying buffer after committed bytes, which is resized to end of window
+ * until ByteWriter::Commit() is called. Windows grow with committed size, so
+ * that resize() initializes bytes proportional to output and not to capacity
+ * of reused buffer.
+ *
+ * Usage:
+ *   bitscpp::VectorWrapper buffer;
+ *   bitscpp::CursorWrapper cursor(&buffer);
+ *   bitscpp::v2::ByteWriter writer(&cursor);
+ *   writer.op(...);
+ *   writer.Commit();
+ */
+
+namespace bitscpp
+{
+template<typename BT = VectorWrapper>
+class CursorWrapper {
+public:
+	// Smallest window opened when capacity allows it.
+	constexpr static size_t MIN_WINDOW = 256;
+
+	BT *buffer = nullptr;
+	size_t committed = 0;
+
+public:
+	inline CursorWrapper(BT *buffer) : buffer(buffer), committed(buffer->size()) {}
+	~CursorWrapper() = default;
+	CursorWrapper(CursorWrapper &o) = delete;
+	CursorWrapper(const CursorWrapper &o) = delete;
+	CursorWrapper &operator=(CursorWrapper &o) = delete;
+	CursorWrapper &operator=(const CursorWrapper &o) = delete;
+
+	inline uint8_t *data() {
+		return buffer->data();
+	}
+	inline size_t size() const {
+		return committed;
+	}
+	inline uint8_t *next_window(uint8_t *cursor, size_t bytes, uint8_t *&end) {
+		if (cursor != nullptr) {
+			committed = cursor - buffer->data();
+		}
+		const size_t required = committed + bytes;
+		if (buffer->capacity() < required) {
+			if constexpr (requires { buffer->reserve_exact(required); }) {
+				buffer->reserve_exact((required * 3) / 2 + 16);
+			} else {
+				buffer->reserve(required);
+			}
+		}
+		const size_t window = std::max(
+			bytes, std::min(buffer->capacity() - committed,
+							std::max(MIN_WINDOW, committed)));
+		buffer->resize(committed + window);
+		uint8_t *data = buffer->data();
+		end = data + buffer->size();
+		return data + committed;
+	}
+	inline void commit_window(uint8_t *cursor) {
+		if (cursor != nullptr) {
+			committed = cursor - buffer->data();
+		}
+		buffer->resize(committed);
+	}
+	inline void write(const uint8_t *data, uint32_t bytes) {
+		buffer->write(data, bytes);
+		committed = buffer->size();
+	}
+};
+}
+
+#endif
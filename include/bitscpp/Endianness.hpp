@@ -8,6 +8,7 @@
 #define BITSCPP_ENDIANNESS_HPP
 
 #include <cstdint>
+#include <cstddef>
 
 #include <bit>
 
@@ -39,7 +40,19 @@ uint64_t NetworkToHostUint(uint64_t v);
 void WriteBytesInNetworkOrder(uint8_t *buffer, uint64_t value, int bytes);
 void WriteBytesInNetworkOrder(uint8_t *buffer, uint32_t value, int bytes);
 void WriteBytesInNetworkOrder(uint8_t *buffer, uint16_t value, int bytes);
+// Stores all bytes of value with single store. Used for wide stores, which
+// write whole 8 bytes even when only lower bytes of value are meaningful.
+void WriteUintInNetworkOrder(uint8_t *buffer, uint64_t value);
+void WriteUintInNetworkOrder(uint8_t *buffer, uint32_t value);
+void WriteUintInNetworkOrder(uint8_t *buffer, uint16_t value);
 uint64_t ReadBytesInNetworkOrder(const uint8_t *buffer, int bytes);
+// Same as ReadBytesInNetworkOrder(), but with single 8 byte load and mask,
+// buffer has to have 8 readable bytes.
+uint64_t ReadWideBytesInNetworkOrder(const uint8_t *buffer, int bytes);
+// Copies elements of elementSize bytes, swapping their byte order when host
+// is not little endian.
+void CopyElementsInNetworkOrder(uint8_t *dst, const uint8_t *src,
+								size_t elements, int elementSize);
 } // namespace bitscpp
 
 #include "../../src/Endianness.inl.hpp"
@@ -0,0 +1,130 @@
+// Copyright (C) 2026 Marek Zalewski aka Drwalin
+//
+// This file is part of bitscpp project under MIT License
+// You should have received a copy of the MIT License along with this program.
+
+#ifndef BITSCPP_FIXED_BUFFER_WRAPPER_HPP
+#define BITSCPP_FIXED_BUFFER_WRAPPER_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
+#include <algorithm>
+#include <span>
+#include <vector>
+
+/*
+ * Provides cursor interface of v2::ByteWriter (see ByteWriter_v2.hpp) over
+ * caller owned memory of fixed capacity. It never allocates: when data does
+ * not fit, next_window() fails and ByteWriter sets ERROR_BUFFER_TOO_SMALL.
+ *
+ * With spillToHeap enabled, overflowing data is moved into heap allocated
+ * std::vector<uint8_t> instead, and data() points into it from then on.
+ *
+ * Usage:
+ *   uint8_t memory[256];
+ *   bitscpp::FixedBufferWrapper buffer(memory);
+ *   bitscpp::v2::ByteWriter writer(&buffer);
+ *   writer.op(...);
+ *   writer.Commit();
+ *   if (writer.get_errors() == bitscpp::v2::ERROR_OK) {
+ *     send(buffer.data(), buffer.size());
+ *   }
+ */
+
+namespace bitscpp
+{
+class FixedBufferWrapper {
+public:
+	uint8_t *buffer = nullptr;
+	size_t bufferCapacity = 0;
+	size_t committed = 0;
+	bool spillToHeap = false;
+	bool spilled = false;
+	std::vector<uint8_t> heap;
+
+public:
+	inline FixedBufferWrapper(uint8_t *buffer, size_t capacity,
+							  bool spillToHeap = false)
+		: buffer(buffer), bufferCapacity(capacity), spillToHeap(spillToHeap)
+	{
+	}
+	inline FixedBufferWrapper(std::span<uint8_t> buffer,
+							  bool spillToHeap = false)
+		: FixedBufferWrapper(buffer.data(), buffer.size(), spillToHeap)
+	{
+	}
+	~FixedBufferWrapper() = default;
+	FixedBufferWrapper(FixedBufferWrapper &o) = delete;
+	FixedBufferWrapper(const FixedBufferWrapper &o) = delete;
+	FixedBufferWrapper &operator=(FixedBufferWrapper &o) = delete;
+	FixedBufferWrapper &operator=(const FixedBufferWrapper &o) = delete;
+
+	inline uint8_t *data() {
+		return spilled ? heap.data() : buffer;
+	}
+	inline size_t size() const {
+		return committed;
+	}
+	inline size_t capacity() const {
+		return spilled ? heap.size() : bufferCapacity;
+	}
+	inline std::span<uint8_t> span() {
+		return {data(), committed};
+	}
+	// Allows reuse of wrapper for next message. Heap memory of spilled data
+	// is kept.
+	inline void clear() {
+		committed = 0;
+		spilled = false;
+	}
+
+	inline uint8_t *next_window(uint8_t *cursor, size_t bytes, uint8_t *&end) {
+		if (cursor != nullptr) {
+			committed = cursor - data();
+		}
+		if (_ensure(committed + bytes) == false) {
+			[[unlikely]];
+			return nullptr;
+		}
+		uint8_t *d = data();
+		end = d + capacity();
+		return d + committed;
+	}
+	inline void commit_window(uint8_t *cursor) {
+		if (cursor != nullptr) {
+			committed = cursor - data();
+		}
+	}
+	inline void write(const uint8_t *src, uint32_t bytes) {
+		if (_ensure(committed + bytes) == false) {
+			[[unlikely]];
+			return;
+		}
+		memcpy(data() + committed, src, bytes);
+		committed += bytes;
+	}
+
+private:
+	inline bool _ensure(size_t required) {
+		if (required <= capacity()) {
+			[[likely]];
+			return true;
+		}
+		if (spillToHeap == false) {
+			return false;
+		}
+		if (spilled == false) {
+			heap.resize(std::max(required, bufferCapacity * 2 + 64));
+			memcpy(heap.data(), buffer, committed);
+			spilled = true;
+		} else {
+			heap.resize(std::max(required, (heap.size() * 3) / 2 + 64));
+		}
+		return true;
+	}
+};
+}
+
+#endif
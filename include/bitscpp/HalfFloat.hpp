@@ -0,0 +1,35 @@
+// Copyright (C) 2026 Marek Zalewski aka Drwalin
+//
+// This file is part of bitscpp project under MIT License
+// You should have received a copy of the MIT License along with this program.
+
+#ifndef BITSCPP_HALF_FLOAT_HPP
+#define BITSCPP_HALF_FLOAT_HPP
+
+#include <cstdint>
+#include <cstddef>
+
+/*
+ * Conversion between float and IEEE 754 binary16. Float is rounded to nearest
+ * even, values too big for binary16 become infinity. NaN stays NaN, it is
+ * made quiet and its payload is truncated.
+ *
+ * Uses F16C instructions when compiled with them (-mf16c or
+ * -march=haswell and newer), otherwise lookup table for half to float and
+ * branch-free integer arithmetic for float to half. Both give the same
+ * results.
+ */
+
+namespace bitscpp
+{
+uint16_t FloatToHalf(float value);
+float HalfToFloat(uint16_t value);
+
+// Arrays of halves in host byte order.
+void FloatToHalf(uint16_t *dst, const float *src, size_t elements);
+void HalfToFloat(float *dst, const uint16_t *src, size_t elements);
+} // namespace bitscpp
+
+#include "../../src/HalfFloat.inl.hpp"
+
+#endif
@@ -0,0 +1,111 @@
+// Copyright (C) 2026 Marek Zalewski aka Drwalin
+//
+// This file is part of bitscpp project under MIT License
+// You should have received a copy of the MIT License along with this program.
+
+#ifndef BITSCPP_MAP_VIEW_V2_HPP
+#define BITSCPP_MAP_VIEW_V2_HPP
+
+#include <cstdint>
+
+#include <string_view>
+
+#include "V2_Specification.hpp"
+#include "ByteReader_v2.hpp"
+
+/*
+ * Lazy view of V2 map, for lookup of few keys in big map without decoding all
+ * of its entries.
+ *
+ * View is read at position of reader, which is moved after the map without
+ * decoding it: entries of map are walked like in ByteReader::skip_values(),
+ * sorted map is skipped in O(1) with its offset table. Keys are compared in
+ * place in read buffer and values are read with readers returned by find()
+ * or by iteration. In sorted map (written by ByteWriter::op_sorted_map() for
+ * std::map with integer or string keys) find() is binary search over offset
+ * table, otherwise keys are compared one by one and values between them are
+ * skipped.
+ *
+ * View does not own buffer, it has to outlive view and its readers.
+ */
+
+namespace bitscpp
+{
+namespace v2
+{
+template<bool CHECKED>
+class BasicMapView
+{
+public:
+	using Reader = BasicByteReader<CHECKED>;
+
+	// Readers positioned at key and at value of entry.
+	struct Entry {
+		Reader key;
+		Reader value;
+	};
+
+	class Iterator
+	{
+	public:
+		Entry operator*() const;
+		Iterator &operator++();
+		inline bool operator==(const Iterator &other) const
+		{
+			return index == other.index;
+		}
+
+	private:
+		inline Iterator(const Reader &key, uint32_t index)
+			: key(key), index(index)
+		{
+		}
+
+		Reader key;
+		uint32_t index;
+
+		friend class BasicMapView;
+	};
+
+	BasicMapView() = default;
+	// Reads map or sorted map at position of reader and moves reader after
+	// it. Errors are set in reader, then view is empty.
+	explicit BasicMapView(Reader &reader);
+
+	// Number of entries.
+	uint32_t size() const;
+	bool is_sorted() const;
+
+	// Entries in order of buffer, each one is found by skipping previous.
+	Iterator begin() const;
+	Iterator end() const;
+
+	// Finds entry with given key and positions value at its value. Keys of
+	// other types are different from key. Returns false when key is not
+	// found or map is corrupted. Sorted map has to have keys of one type.
+	bool find(std::string_view key, Reader &value) const;
+	bool find(int64_t key, Reader &value) const;
+
+private:
+	template<typename K>
+	bool _find(K key, Reader &value) const;
+	// Compares key at reader with given key and moves reader after it.
+	// Returns negative, 0 or positive, or KEY_TYPE_MISMATCH.
+	static int _compare_key(Reader &reader, std::string_view key);
+	static int _compare_key(Reader &reader, int64_t key);
+	constexpr static int KEY_TYPE_MISMATCH = 2;
+
+	// positioned at first key
+	Reader first{nullptr, 0};
+	// table is present only in sorted map
+	IndexedArray map;
+};
+
+using MapView = BasicMapView<true>;
+using UncheckedMapView = BasicMapView<false>;
+} // namespace v2
+} // namespace bitscpp
+
+#include "../../src/MapView_v2.inl.hpp"
+
+#endif
@@ -0,0 +1,132 @@
+// Copyright (C) 2026 Marek Zalewski aka Drwalin
+//
+// This file is part of bitscpp project under MIT License
+// You should have received a copy of the MIT License along with this program.
+
+#ifndef BITSCPP_RAW_BUFFER_WRAPPER_HPP
+#define BITSCPP_RAW_BUFFER_WRAPPER_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+
+#include <new>
+#include <span>
+#include <utility>
+
+/*
+ * BT for v2::ByteWriter (see ByteWriter_v2.hpp) backed by malloc/realloc.
+ * Unlike VectorWrapper, resize() does not value-initialise new bytes, so
+ * growing buffer does not zero-fill memory which is overwritten right after.
+ * Large buffers can be grown in place by realloc.
+ *
+ * Bytes added by resize() have unspecified values.
+ */
+
+namespace bitscpp
+{
+class RawBufferWrapper {
+public:
+	RawBufferWrapper() = default;
+	inline ~RawBufferWrapper() {
+		free(_data);
+	}
+	inline RawBufferWrapper(RawBufferWrapper &&o)
+		: _data(o._data), _size(o._size), _capacity(o._capacity)
+	{
+		o._data = nullptr;
+		o._size = o._capacity = 0;
+	}
+	inline RawBufferWrapper &operator=(RawBufferWrapper &&o) {
+		std::swap(_data, o._data);
+		std::swap(_size, o._size);
+		std::swap(_capacity, o._capacity);
+		return *this;
+	}
+	RawBufferWrapper(RawBufferWrapper &o) = delete;
+	RawBufferWrapper(const RawBufferWrapper &o) = delete;
+	RawBufferWrapper &operator=(RawBufferWrapper &o) = delete;
+	RawBufferWrapper &operator=(const RawBufferWrapper &o) = delete;
+
+	inline uint8_t *data() {
+		return _data;
+	}
+	inline const uint8_t *data() const {
+		return _data;
+	}
+	inline size_t size() const {
+		return _size;
+	}
+	inline size_t capacity() const {
+		return _capacity;
+	}
+	inline std::span<uint8_t> span() {
+		return {_data, _size};
+	}
+	inline void resize(size_t s) {
+		if (s > _capacity) {
+			[[unlikely]];
+			reserve_exact(s);
+		}
+		_size = s;
+	}
+	inline void reserve(size_t c) {
+		if (capacity() >= c) {
+			[[likely]];
+			return;
+		}
+		reserve_exact((c*3)/2+32);
+	}
+	inline void reserve_exact(size_t c) {
+		if (c <= _capacity) {
+			return;
+		}
+		uint8_t *p = (uint8_t *)realloc(_data, c);
+		if (p == nullptr) {
+			[[unlikely]];
+			throw std::bad_alloc();
+		}
+		_data = p;
+		_capacity = c;
+	}
+	inline void shrink_to_fit() {
+		if (_size == 0) {
+			free(_data);
+			_data = nullptr;
+			_capacity = 0;
+		} else if (_size < _capacity) {
+			uint8_t *p = (uint8_t *)realloc(_data, _size);
+			if (p != nullptr) {
+				_data = p;
+				_capacity = _size;
+			}
+		}
+	}
+	inline void clear() {
+		_size = 0;
+	}
+	inline void push_back(uint8_t byte) {
+		if (_size == _capacity) {
+			[[unlikely]];
+			reserve(_size + 1);
+		}
+		_data[_size++] = byte;
+	}
+	inline void write(const uint8_t *data, uint32_t bytes) {
+		if (bytes == 0) {
+			return;
+		}
+		reserve(_size + bytes);
+		memcpy(_data + _size, data, bytes);
+		_size += bytes;
+	}
+
+private:
+	uint8_t *_data = nullptr;
+	size_t _size = 0;
+	size_t _capacity = 0;
+};
+}
+
+#endif
@@ -0,0 +1,237 @@
+// Copyright (C) 2026 Marek Zalewski aka Drwalin
+//
+// This file is part of bitscpp project under MIT License
+// You should have received a copy of the MIT License along with this program.
+
+#ifndef BITSCPP_SEGMENTED_BUFFER_HPP
+#define BITSCPP_SEGMENTED_BUFFER_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#if __has_include(<sys/uio.h>)
+#include <sys/uio.h>
+#include <climits>
+#define BITSCPP_HAS_IOVEC 1
+#endif
+
+/*
+ * Provides cursor interface of v2::ByteWriter (see ByteWriter_v2.hpp) over
+ * chain of separately allocated segments. When current segment is exhausted
+ * new one of at least segmentSize bytes is appended, already written data is
+ * never reallocated nor copied. Unused tail of segment is skipped when value
+ * does not fit into it.
+ *
+ * Large byte arrays written with v2::ByteWriter::op_byte_array_ref() are
+ * stored as references to caller's memory instead of being copied.
+ *
+ * Written data can be exported as list of iovec for writev()/sendmsg() or
+ * copied into contiguous memory with flatten(). writev() accepts at most
+ * IOV_MAX iovec, so that they are exported in batches of at most MAX_IOVEC,
+ * each one continuing from position where previous one ended.
+ *
+ * Usage:
+ *   bitscpp::SegmentedBuffer buffer;
+ *   bitscpp::v2::ByteWriter writer(&buffer);
+ *   writer.op(...);
+ *   writer.Commit();
+ *   std::vector<iovec> iov;
+ *   for (size_t pos = 0; buffer.export_iovec(iov, pos) != 0; iov.clear()) {
+ *     writev(fd, iov.data(), iov.size());
+ *   }
+ */
+
+namespace bitscpp
+{
+class SegmentedBuffer {
+public:
+	struct Segment {
+		std::unique_ptr<uint8_t[]> data;
+		// Not owned data referenced by write_reference().
+		const uint8_t *external = nullptr;
+		size_t size = 0;
+		size_t capacity = 0;
+
+		inline const uint8_t *begin() const {
+			return external ? external : data.get();
+		}
+		inline size_t available() const {
+			return external ? 0 : capacity - size;
+		}
+	};
+
+	constexpr static size_t DEFAULT_SEGMENT_SIZE = 64 * 1024;
+	constexpr static size_t DEFAULT_REFERENCE_THRESHOLD = 16 * 1024;
+#ifdef BITSCPP_HAS_IOVEC
+#ifdef IOV_MAX
+	constexpr static size_t MAX_IOVEC = IOV_MAX;
+#else
+	constexpr static size_t MAX_IOVEC = 1024;
+#endif
+#endif
+
+public:
+	// Data passed to write_reference() smaller than referenceThreshold is
+	// copied instead.
+	inline SegmentedBuffer(
+		size_t segmentSize = DEFAULT_SEGMENT_SIZE,
+		size_t referenceThreshold = DEFAULT_REFERENCE_THRESHOLD)
+		: segmentSize(segmentSize), referenceThreshold(referenceThreshold) {}
+	~SegmentedBuffer() = default;
+	SegmentedBuffer(SegmentedBuffer &&o) = default;
+	SegmentedBuffer &operator=(SegmentedBuffer &&o) = default;
+	SegmentedBuffer(SegmentedBuffer &o) = delete;
+	SegmentedBuffer(const SegmentedBuffer &o) = delete;
+	SegmentedBuffer &operator=(SegmentedBuffer &o) = delete;
+	SegmentedBuffer &operator=(const SegmentedBuffer &o) = delete;
+
+	inline size_t size() const {
+		return committed;
+	}
+	// Number of non-empty segments.
+	inline size_t segment_count() const {
+		return filled;
+	}
+	// Keeps allocated segments for reuse.
+	inline void clear() {
+		for (size_t i = 0; i < used; ++i) {
+			segments[i].size = 0;
+			segments[i].external = nullptr;
+		}
+		used = 0;
+		filled = 0;
+		committed = 0;
+	}
+
+	template<typename F>
+	inline void for_each_segment(F &&func) const {
+		for (size_t i = 0; i < used; ++i) {
+			if (segments[i].size) {
+				func(segments[i].begin(), segments[i].size);
+			}
+		}
+	}
+
+	// Copies data into dst, which has to have at least size() bytes.
+	inline void flatten(uint8_t *dst) const {
+		for_each_segment([&](const uint8_t *data, size_t bytes) {
+			memcpy(dst, data, bytes);
+			dst += bytes;
+		});
+	}
+	inline std::vector<uint8_t> flatten() const {
+		std::vector<uint8_t> ret(committed);
+		flatten(ret.data());
+		return ret;
+	}
+
+#ifdef BITSCPP_HAS_IOVEC
+	// Appends iovec of at most maxSegments non-empty segments to iov,
+	// starting from position, which is 0 for first batch and is moved after
+	// exported segments. Returns number of appended iovec, 0 after last one.
+	inline size_t export_iovec(std::vector<iovec> &iov, size_t &position,
+							   size_t maxSegments = MAX_IOVEC) const {
+		size_t exported = 0;
+		for (; position < used && exported < maxSegments; ++position) {
+			const Segment &seg = segments[position];
+			if (seg.size) {
+				iov.push_back({(void *)seg.begin(), seg.size});
+				++exported;
+			}
+		}
+		return exported;
+	}
+#endif
+
+	inline uint8_t *next_window(uint8_t *cursor, size_t bytes, uint8_t *&end) {
+		_commit(cursor);
+		Segment *seg = used ? &segments[used - 1] : nullptr;
+		if (seg == nullptr || seg->available() < bytes) {
+			seg = _next_segment(bytes);
+		}
+		end = seg->data.get() + seg->capacity;
+		return seg->data.get() + seg->size;
+	}
+	inline void commit_window(uint8_t *cursor) {
+		_commit(cursor);
+	}
+	inline void write(const uint8_t *data, uint32_t bytes) {
+		Segment *seg = used ? &segments[used - 1] : nullptr;
+		if (seg && seg->available()) {
+			const size_t n = std::min<size_t>(seg->available(), bytes);
+			filled += seg->size == 0 && n != 0;
+			memcpy(seg->data.get() + seg->size, data, n);
+			seg->size += n;
+			committed += n;
+			data += n;
+			bytes -= n;
+		}
+		if (bytes) {
+			seg = _next_segment(bytes);
+			memcpy(seg->data.get(), data, bytes);
+			seg->size = bytes;
+			++filled;
+			committed += bytes;
+		}
+	}
+
+	// Stores only pointer to data, which has to outlive this buffer or its
+	// next clear().
+	inline void write_reference(const uint8_t *data, uint32_t bytes) {
+		if (bytes < referenceThreshold) {
+			write(data, bytes);
+			return;
+		}
+		if (used == segments.size()) {
+			segments.emplace_back();
+		}
+		Segment &seg = segments[used++];
+		seg.external = data;
+		seg.size = bytes;
+		filled += bytes != 0;
+		committed += bytes;
+	}
+
+private:
+	inline void _commit(uint8_t *cursor) {
+		if (cursor != nullptr) {
+			Segment &seg = segments[used - 1];
+			const size_t size = cursor - seg.data.get();
+			filled += seg.size == 0 && size != 0;
+			committed += size - seg.size;
+			seg.size = size;
+		}
+	}
+	inline Segment *_next_segment(size_t bytes) {
+		const size_t capacity = std::max(bytes, segmentSize);
+		if (used == segments.size()) {
+			segments.emplace_back();
+		} else if (segments[used].capacity >= capacity) {
+			segments[used].external = nullptr;
+			return &segments[used++];
+		}
+		Segment &seg = segments[used++];
+		seg.data.reset(new uint8_t[capacity]);
+		seg.external = nullptr;
+		seg.capacity = capacity;
+		seg.size = 0;
+		return &seg;
+	}
+
+private:
+	std::vector<Segment> segments;
+	size_t used = 0;
+	// non-empty segments
+	size_t filled = 0;
+	size_t committed = 0;
+	size_t segmentSize = DEFAULT_SEGMENT_SIZE;
+	size_t referenceThreshold = DEFAULT_REFERENCE_THRESHOLD;
+};
+}
+
+#endif
@@ -0,0 +1,924 @@
+// Copyright (C) 2026 Marek Zalewski aka Drwalin
+//
+// This file is part of bitscpp project under MIT License
+// You should have received a copy of the MIT License along with this program.
+
+#ifndef BITSCPP_SIZE_COUNTER_V2_HPP
+#define BITSCPP_SIZE_COUNTER_V2_HPP
+
+#include <cstdint>
+#include <cstddef>
+
+#include <bit>
+#include <bitset>
+#include <map>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "V2_Specification.hpp"
+#include "SerizalizerClass.hpp"
+
+namespace bitscpp
+{
+namespace v2
+{
+template<typename T>
+struct max_encoded_size;
+
+namespace impl
+{
+// Keys of std::map, which std::less orders like keys of sorted map.
+template<typename K>
+concept SortedMapKey =
+	(std::is_integral_v<K> && std::is_same_v<K, bool> == false) ||
+	std::is_same_v<K, std::string> || std::is_same_v<K, std::string_view>;
+
+// True when op_sorted_map() writes std::map as sorted map. Unsigned 64-bit
+// keys above INT64_MAX are encoded as negative integers, which breaks order.
+template<typename K, typename V>
+constexpr bool writes_sorted_map(const std::map<K, V> &map)
+{
+	if constexpr (SortedMapKey<K> == false) {
+		return false;
+	} else if constexpr (std::is_unsigned_v<K> && sizeof(K) == 8) {
+		return map.empty() == false && map.rbegin()->first <= INT64_MAX;
+	} else {
+		return map.empty() == false;
+	}
+}
+} // namespace impl
+
+/*
+ * Serializer with the same interface as v2::ByteWriter, which computes upper
+ * bound of number of bytes that v2::ByteWriter would produce. Member `fixed`
+ * is cleared when bound depends on values (sizes of strings, arrays, maps).
+ * ERROR_TYPE_MISMATCH is set when bound of some type cannot be computed.
+ */
+class MaxSizeCounter
+{
+public:
+	constexpr static int VERSION = 2;
+	constexpr static bool READER = false;
+	constexpr static bool WRITER = true;
+
+	constexpr static size_t MAX_INT8_SIZE = 2;
+	constexpr static size_t MAX_UINT8_SIZE = 2;
+	constexpr static size_t MAX_INT16_SIZE = 3;
+	constexpr static size_t MAX_UINT16_SIZE = 4;
+	constexpr static size_t MAX_INT32_SIZE = 5;
+	constexpr static size_t MAX_UINT32_SIZE = 6;
+	constexpr static size_t MAX_INT64_SIZE = 9;
+	constexpr static size_t MAX_VAR_UINT_SIZE = 9;
+	constexpr static size_t MAX_HEADER_SIZE = 6;
+
+	template<typename TT>
+	constexpr MaxSizeCounter &op(const TT &item)
+	{
+		using T = std::remove_cvref_t<decltype(item)>;
+		if constexpr (requires { item.serialize(*this); }) {
+			item.serialize(*this);
+		} else if constexpr (requires {
+								 bitscpp::serializer<MaxSizeCounter, T>::op(
+									 *this, item);
+							 }) {
+			bitscpp::serializer<MaxSizeCounter, T>::op(*this, item);
+		} else if constexpr (requires { serialize(*this, item); }) {
+			serialize(*this, item);
+		} else {
+			// Type without serializer for MaxSizeCounter has unknown bound
+			fixed = false;
+			set_error(ERROR_TYPE_MISMATCH);
+		}
+		return *this;
+	}
+
+public:
+	inline constexpr uint32_t GetSize() const { return size; }
+
+	// strings
+	constexpr MaxSizeCounter &op_sized_byte_array_header(uint32_t)
+	{
+		return _add(MAX_HEADER_SIZE);
+	}
+	constexpr MaxSizeCounter &op_sized_string_header(uint32_t bytes)
+	{
+		return op_sized_byte_array_header(bytes);
+	}
+
+	constexpr MaxSizeCounter &op(const std::string &str)
+	{
+		return op_byte_array(nullptr, str.size());
+	}
+	constexpr MaxSizeCounter &op(const std::string_view str)
+	{
+		return op_byte_array(nullptr, str.size());
+	}
+	constexpr MaxSizeCounter &op(char const *str)
+	{
+		return op_byte_array(nullptr, std::char_traits<char>::length(str));
+	}
+	constexpr MaxSizeCounter &op(char const *, uint32_t size)
+	{
+		return op_byte_array(nullptr, size);
+	}
+	constexpr MaxSizeCounter &op(char *str)
+	{
+		return op_byte_array(nullptr, std::char_traits<char>::length(str));
+	}
+	constexpr MaxSizeCounter &op(char *, uint32_t size)
+	{
+		return op_byte_array(nullptr, size);
+	}
+
+	// constant size byte array
+	constexpr MaxSizeCounter &op_byte_array(const uint8_t *, uint32_t bytes)
+	{
+		fixed = false;
+		return _add(MAX_HEADER_SIZE + (size_t)bytes);
+	}
+	constexpr MaxSizeCounter &op_byte_array(const std::vector<uint8_t> &data)
+	{
+		return op_byte_array(nullptr, data.size());
+	}
+	constexpr MaxSizeCounter &op(const std::vector<uint8_t> &data)
+	{
+		return op_byte_array(data);
+	}
+	constexpr MaxSizeCounter &op_byte_array(const std::vector<char> &data)
+	{
+		return op_byte_array(nullptr, data.size());
+	}
+	constexpr MaxSizeCounter &op(const std::vector<char> &data)
+	{
+		return op_byte_array(data);
+	}
+	constexpr MaxSizeCounter &op_byte_array_ref(const uint8_t *data, uint32_t bytes)
+	{
+		return op_byte_array(data, bytes);
+	}
+
+	// miscelanous
+	constexpr MaxSizeCounter &op(bool) { return _add(1); }
+	constexpr MaxSizeCounter &op_boolean(bool) { return _add(1); }
+	constexpr MaxSizeCounter &op_false() { return _add(1); }
+	constexpr MaxSizeCounter &op_true() { return _add(1); }
+	constexpr MaxSizeCounter &op_begin_object() { return _add(1); }
+	constexpr MaxSizeCounter &op_end_object() { return _add(1); }
+	constexpr MaxSizeCounter &op_begin_sized_object(uint32_t &offset)
+	{
+		offset = 0;
+		return _add(1 + SIZED_OBJECT_LENGTH_BYTES);
+	}
+	constexpr MaxSizeCounter &op_end_sized_object(uint32_t) { return _add(1); }
+
+	// integers
+	constexpr MaxSizeCounter &op(uint8_t) { return _add(MAX_UINT8_SIZE); }
+	constexpr MaxSizeCounter &op(uint16_t) { return _add(MAX_UINT16_SIZE); }
+	constexpr MaxSizeCounter &op(uint32_t) { return _add(MAX_UINT32_SIZE); }
+	constexpr MaxSizeCounter &op(uint64_t) { return _add(MAX_INT64_SIZE); }
+	constexpr MaxSizeCounter &op(int8_t) { return _add(MAX_INT8_SIZE); }
+	constexpr MaxSizeCounter &op(int16_t) { return _add(MAX_INT16_SIZE); }
+	constexpr MaxSizeCounter &op(int32_t) { return _add(MAX_INT32_SIZE); }
+	constexpr MaxSizeCounter &op(int64_t) { return _add(MAX_INT64_SIZE); }
+	constexpr MaxSizeCounter &op(char) { return _add(MAX_INT8_SIZE); }
+
+	constexpr MaxSizeCounter &op_uint(uint64_t) { return _add(MAX_INT64_SIZE); }
+	constexpr MaxSizeCounter &op_int(int64_t) { return _add(MAX_INT64_SIZE); }
+
+	// floats
+	constexpr MaxSizeCounter &op_half(float) { return _add(3); }
+	constexpr MaxSizeCounter &op_bfloat(float) { return _add(3); }
+	constexpr MaxSizeCounter &op_float(float) { return _add(5); }
+	constexpr MaxSizeCounter &op_double(double) { return _add(9); }
+	constexpr MaxSizeCounter &op(float) { return _add(5); }
+	constexpr MaxSizeCounter &op(double) { return _add(9); }
+
+	// map
+	constexpr MaxSizeCounter &op_map_header(uint32_t)
+	{
+		fixed = false;
+		return _add(MAX_HEADER_SIZE);
+	}
+	constexpr MaxSizeCounter &op_begin_sorted_map(uint32_t entries,
+												  uint32_t &offset)
+	{
+		return op_begin_indexed_array(entries, offset);
+	}
+	constexpr MaxSizeCounter &op_end_sorted_map_entry(uint32_t, uint32_t)
+	{
+		return *this;
+	}
+	constexpr MaxSizeCounter &op_end_sorted_map(uint32_t, uint32_t)
+	{
+		return *this;
+	}
+
+	// array
+	constexpr MaxSizeCounter &op_array_header(uint32_t)
+	{
+		fixed = false;
+		return _add(MAX_HEADER_SIZE);
+	}
+	constexpr MaxSizeCounter &op_begin_indexed_array(uint32_t elements,
+													 uint32_t &offset)
+	{
+		offset = 0;
+		fixed = false;
+		return _add(MAX_HEADER_SIZE + 1 + 4 * (size_t)elements);
+	}
+	constexpr MaxSizeCounter &op_end_indexed_array_element(uint32_t, uint32_t)
+	{
+		return *this;
+	}
+	constexpr MaxSizeCounter &op_end_indexed_array(uint32_t, uint32_t)
+	{
+		return *this;
+	}
+
+	// packed array
+	constexpr MaxSizeCounter &op_packed_array_header(PackedArrayType type,
+													 uint32_t,
+													 bool aligned = false)
+	{
+		fixed = false;
+		if (aligned) {
+			_add(1 + packed_array_element_size(type) - 1);
+		}
+		return _add(2 + MAX_VAR_UINT_SIZE);
+	}
+	constexpr MaxSizeCounter &op_packed_array(PackedArrayType type,
+											  const void *, uint32_t elements)
+	{
+		op_packed_array_header(type, elements);
+		return _add((size_t)elements * packed_array_element_size(type));
+	}
+	constexpr MaxSizeCounter &op_aligned_packed_array(PackedArrayType type,
+													  const void *,
+													  uint32_t elements)
+	{
+		op_packed_array_header(type, elements, true);
+		return _add((size_t)elements * packed_array_element_size(type));
+	}
+	template <PackedElement T>
+	constexpr MaxSizeCounter &op_packed_array(const T *data, uint32_t elements)
+	{
+		return op_packed_array(packed_array_type<T>::value, data, elements);
+	}
+	template <PackedElement T>
+	constexpr MaxSizeCounter &op_packed_array(const std::vector<T> &arr)
+	{
+		return op_packed_array(arr.data(), arr.size());
+	}
+	template <PackedElement T>
+	constexpr MaxSizeCounter &op_aligned_packed_array(const T *data,
+													  uint32_t elements)
+	{
+		return op_aligned_packed_array(packed_array_type<T>::value, data,
+									   elements);
+	}
+	template <PackedElement T>
+	constexpr MaxSizeCounter &op_aligned_packed_array(const std::vector<T> &arr)
+	{
+		return op_aligned_packed_array(arr.data(), arr.size());
+	}
+	constexpr MaxSizeCounter &op_half_array(const float *data,
+											 uint32_t elements)
+	{
+		return op_packed_array(PACKED_HALF, data, elements);
+	}
+	constexpr MaxSizeCounter &op_half_array(const std::vector<float> &data)
+	{
+		return op_half_array(data.data(), data.size());
+	}
+
+	// bit array
+	constexpr MaxSizeCounter &op_bit_array_header(uint32_t)
+	{
+		fixed = false;
+		return _add(1 + MAX_VAR_UINT_SIZE);
+	}
+	constexpr MaxSizeCounter &op_bit_array(const bool *, uint32_t elements)
+	{
+		op_bit_array_header(elements);
+		return _add(((size_t)elements + 7) / 8);
+	}
+	constexpr MaxSizeCounter &op_bit_array(const std::vector<bool> &data)
+	{
+		return op_bit_array(nullptr, data.size());
+	}
+	constexpr MaxSizeCounter &op(const std::vector<bool> &data)
+	{
+		return op_bit_array(data);
+	}
+	// size of bitset does not depend on value
+	template <size_t N>
+	constexpr MaxSizeCounter &op(const std::bitset<N> &)
+	{
+		return _add(1 + MAX_VAR_UINT_SIZE + (N + 7) / 8);
+	}
+
+	constexpr MaxSizeCounter &op_untyped_var_uint(uint64_t)
+	{
+		return _add(MAX_VAR_UINT_SIZE);
+	}
+	constexpr MaxSizeCounter &op_untyped_var_int(int64_t)
+	{
+		return _add(MAX_VAR_UINT_SIZE);
+	}
+
+	constexpr MaxSizeCounter &op_untyped_uint32(uint32_t) { return _add(4); }
+
+	constexpr void set_error(Errors error) { errors |= error; }
+	constexpr Errors get_errors() const { return (Errors)errors; }
+
+public:
+	template <typename T>
+	constexpr MaxSizeCounter &op(const T *data, uint32_t elements)
+	{
+		if (elements > MAX_ARRAY_ELEMENTS) {
+			set_error(ERROR_ARRAY_TOO_BIG);
+			return *this;
+		}
+		op_array_header(elements);
+		if constexpr (requires { max_encoded_size<T>::value; }) {
+			_add(max_encoded_size<T>::value * elements);
+		} else {
+			for (uint32_t i = 0; i < elements; ++i)
+				op(data[i]);
+		}
+		return *this;
+	}
+
+	template <typename T>
+	constexpr MaxSizeCounter &op(const std::vector<T> &arr)
+	{
+		if (arr.size() > MAX_ARRAY_ELEMENTS) {
+			set_error(ERROR_ARRAY_TOO_BIG);
+			return *this;
+		}
+		return op<T>(arr.data(), arr.size());
+	}
+
+	template <typename T>
+	constexpr MaxSizeCounter &op_indexed_array(const T *data, uint32_t elements)
+	{
+		if (elements > MAX_ARRAY_ELEMENTS) {
+			set_error(ERROR_ARRAY_TOO_BIG);
+			return *this;
+		}
+		uint32_t offset = 0;
+		op_begin_indexed_array(elements, offset);
+		for (uint32_t i = 0; i < elements; ++i)
+			op(data[i]);
+		return op_end_indexed_array(offset, elements);
+	}
+
+	template <typename T>
+	constexpr MaxSizeCounter &op_indexed_array(const std::vector<T> &arr)
+	{
+		if (arr.size() > MAX_ARRAY_ELEMENTS) {
+			set_error(ERROR_ARRAY_TOO_BIG);
+			return *this;
+		}
+		return op_indexed_array<T>(arr.data(), arr.size());
+	}
+
+	template <typename K, typename V>
+	constexpr MaxSizeCounter &op(const std::map<K, V> &map)
+	{
+		if (map.size() > MAX_ARRAY_ELEMENTS) {
+			set_error(ERROR_ARRAY_TOO_BIG);
+			return *this;
+		}
+		op_map_header(map.size());
+		for (const auto &[key, value] : map) {
+			op(key);
+			op(value);
+		}
+		return *this;
+	}
+
+	template <typename K, typename V>
+	constexpr MaxSizeCounter &op_sorted_map(const std::map<K, V> &map)
+	{
+		if (map.size() > MAX_ARRAY_ELEMENTS) {
+			set_error(ERROR_ARRAY_TOO_BIG);
+			return *this;
+		}
+		// bound of both map and sorted map
+		uint32_t offset = 0;
+		op_begin_sorted_map(map.size(), offset);
+		for (const auto &[key, value] : map) {
+			op(key);
+			op(value);
+		}
+		return *this;
+	}
+
+private:
+	constexpr MaxSizeCounter &_add(size_t bytes)
+	{
+		size += bytes;
+		return *this;
+	}
+
+public:
+	size_t size = 0;
+	bool fixed = true;
+	uint32_t errors = 0;
+};
+
+/*
+ * Serializer with the same interface as v2::ByteWriter, which computes exact
+ * number of bytes that v2::ByteWriter would produce, without writing them.
+ * Padding of aligned packed arrays depends on offset in output, it is
+ * computed as if `size` was the offset.
+ */
+class SizeCounter
+{
+public:
+	constexpr static int VERSION = 2;
+	constexpr static bool READER = false;
+	constexpr static bool WRITER = true;
+
+	template<typename TT>
+	constexpr SizeCounter &op(const TT &item)
+	{
+		using T = std::remove_cvref_t<decltype(item)>;
+		if constexpr (requires { item.serialize(*this); }) {
+			item.serialize(*this);
+		} else if constexpr (requires {
+								 bitscpp::serializer<SizeCounter, T>::op(*this,
+																		 item);
+							 }) {
+			bitscpp::serializer<SizeCounter, T>::op(*this, item);
+		} else if constexpr (requires { serialize(*this, item); }) {
+			serialize(*this, item);
+		} else {
+			static_assert(sizeof(T) == 0,
+				"Unimplemented bitscpp serialization function or method");
+		}
+		return *this;
+	}
+
+public:
+	inline constexpr uint32_t GetSize() const { return size; }
+
+	static constexpr size_t int_size(int64_t v)
+	{
+		if (v >= IMMEDIATE_INTEGER_VALUE_MIN &&
+			v <= IMMEDIATE_INTEGER_VALUE_MAX) {
+			return 1;
+		}
+		const uint64_t uv = ((uint64_t)v << 1) ^ (uint64_t)(v >> 63);
+		const uint32_t bits = std::bit_width(uv);
+		if (bits <= 12) {
+			return 2;
+		}
+		return 1 + ((bits + 7) >> 3);
+	}
+	static constexpr size_t var_uint_size(uint64_t v)
+	{
+		if (v <= 0x7F) {
+			return 1;
+		}
+		const uint32_t bits = std::bit_width(v);
+		return bits > 56 ? 9 : (bits + 6) / 7;
+	}
+	static constexpr size_t byte_array_header_size(uint32_t bytes)
+	{
+		if (bytes <= IMMEDIATE_STRING_MAX_SIZE) {
+			return 1;
+		}
+		return 1 + var_uint_size(bytes - IMMEDIATE_STRING_MAX_SIZE - 1);
+	}
+	static constexpr size_t array_header_size(uint32_t elements)
+	{
+		if (elements <= IMMEDIATE_ARRAY_MAX_SIZE) {
+			return 1;
+		}
+		return 1 + var_uint_size(elements - IMMEDIATE_ARRAY_MAX_SIZE - 1);
+	}
+	static constexpr size_t map_header_size(uint32_t elements)
+	{
+		if (elements == 0) {
+			return 1;
+		}
+		return 1 + var_uint_size(elements - 1);
+	}
+
+	// strings
+	constexpr SizeCounter &op_sized_byte_array_header(uint32_t bytes)
+	{
+		return _add(byte_array_header_size(bytes));
+	}
+	constexpr SizeCounter &op_sized_string_header(uint32_t bytes)
+	{
+		return op_sized_byte_array_header(bytes);
+	}
+
+	constexpr SizeCounter &op(const std::string &str)
+	{
+		return op_byte_array(nullptr, str.size());
+	}
+	constexpr SizeCounter &op(const std::string_view str)
+	{
+		return op_byte_array(nullptr, str.size());
+	}
+	constexpr SizeCounter &op(char const *str)
+	{
+		return op_byte_array(nullptr, std::char_traits<char>::length(str));
+	}
+	constexpr SizeCounter &op(char const *, uint32_t size)
+	{
+		return op_byte_array(nullptr, size);
+	}
+	constexpr SizeCounter &op(char *str)
+	{
+		return op_byte_array(nullptr, std::char_traits<char>::length(str));
+	}
+	constexpr SizeCounter &op(char *, uint32_t size)
+	{
+		return op_byte_array(nullptr, size);
+	}
+
+	// constant size byte array
+	constexpr SizeCounter &op_byte_array(const uint8_t *, uint32_t bytes)
+	{
+		return _add(byte_array_header_size(bytes) + bytes);
+	}
+	constexpr SizeCounter &op_byte_array(const std::vector<uint8_t> &data)
+	{
+		return op_byte_array(nullptr, data.size());
+	}
+	constexpr SizeCounter &op(const std::vector<uint8_t> &data)
+	{
+		return op_byte_array(data);
+	}
+	constexpr SizeCounter &op_byte_array(const std::vector<char> &data)
+	{
+		return op_byte_array(nullptr, data.size());
+	}
+	constexpr SizeCounter &op(const std::vector<char> &data)
+	{
+		return op_byte_array(data);
+	}
+	constexpr SizeCounter &op_byte_array_ref(const uint8_t *data, uint32_t bytes)
+	{
+		return op_byte_array(data, bytes);
+	}
+
+	// miscelanous
+	constexpr SizeCounter &op(bool) { return _add(1); }
+	constexpr SizeCounter &op_boolean(bool) { return _add(1); }
+	constexpr SizeCounter &op_false() { return _add(1); }
+	constexpr SizeCounter &op_true() { return _add(1); }
+	constexpr SizeCounter &op_begin_object() { return _add(1); }
+	constexpr SizeCounter &op_end_object() { return _add(1); }
+	constexpr SizeCounter &op_begin_sized_object(uint32_t &offset)
+	{
+		offset = 0;
+		return _add(1 + SIZED_OBJECT_LENGTH_BYTES);
+	}
+	constexpr SizeCounter &op_end_sized_object(uint32_t) { return _add(1); }
+
+	// integers
+	constexpr SizeCounter &op(uint8_t v) { return op_uint(v); }
+	constexpr SizeCounter &op(uint16_t v) { return op_uint(v); }
+	constexpr SizeCounter &op(uint32_t v) { return op_uint(v); }
+	constexpr SizeCounter &op(uint64_t v) { return op_uint(v); }
+	constexpr SizeCounter &op(int8_t v) { return op_int(v); }
+	constexpr SizeCounter &op(int16_t v) { return op_int(v); }
+	constexpr SizeCounter &op(int32_t v) { return op_int(v); }
+	constexpr SizeCounter &op(int64_t v) { return op_int(v); }
+	constexpr SizeCounter &op(char v) { return op_int(v); }
+
+	constexpr SizeCounter &op_uint(uint64_t v) { return op_int(v); }
+	constexpr SizeCounter &op_int(int64_t v) { return _add(int_size(v)); }
+
+	// floats
+	constexpr SizeCounter &op_half(float) { return _add(3); }
+	constexpr SizeCounter &op_bfloat(float) { return _add(3); }
+	constexpr SizeCounter &op_float(float) { return _add(5); }
+	constexpr SizeCounter &op_double(double) { return _add(9); }
+	constexpr SizeCounter &op(float) { return _add(5); }
+	constexpr SizeCounter &op(double) { return _add(9); }
+
+	// map
+	constexpr SizeCounter &op_map_header(uint32_t elements)
+	{
+		return _add(map_header_size(elements));
+	}
+	constexpr SizeCounter &op_begin_sorted_map(uint32_t entries,
+											   uint32_t &offset)
+	{
+		return op_begin_indexed_array(entries, offset);
+	}
+	constexpr SizeCounter &op_end_sorted_map_entry(uint32_t, uint32_t)
+	{
+		return *this;
+	}
+	constexpr SizeCounter &op_end_sorted_map(uint32_t offset, uint32_t entries)
+	{
+		return op_end_indexed_array(offset, entries);
+	}
+
+	// array
+	constexpr SizeCounter &op_array_header(uint32_t elements)
+	{
+		return _add(array_header_size(elements));
+	}
+	constexpr SizeCounter &op_begin_indexed_array(uint32_t elements,
+												  uint32_t &offset)
+	{
+		_add(1);
+		op_untyped_var_uint(elements);
+		_add(1);
+		offset = size;
+		return *this;
+	}
+	constexpr SizeCounter &op_end_indexed_array_element(uint32_t, uint32_t)
+	{
+		return *this;
+	}
+	// Width of table entries depends on size of elements counted since
+	// op_begin_indexed_array().
+	constexpr SizeCounter &op_end_indexed_array(uint32_t offset,
+												uint32_t elements)
+	{
+		const size_t total = size - offset;
+		const size_t width = total <= 0xFF ? 1 : total <= 0xFFFF ? 2 : 4;
+		return _add(width * elements);
+	}
+
+	// packed array
+	constexpr SizeCounter &op_packed_array_header(PackedArrayType type,
+												  uint32_t elements,
+												  bool aligned = false)
+	{
+		_add(2 + var_uint_size(elements));
+		if (aligned) {
+			_add(1 + packed_array_padding(type, size + 1));
+		}
+		return *this;
+	}
+	constexpr SizeCounter &op_packed_array(PackedArrayType type, const void *,
+										   uint32_t elements)
+	{
+		op_packed_array_header(type, elements);
+		return _add((size_t)elements * packed_array_element_size(type));
+	}
+	constexpr SizeCounter &op_aligned_packed_array(PackedArrayType type,
+												   const void *,
+												   uint32_t elements)
+	{
+		op_packed_array_header(type, elements, true);
+		return _add((size_t)elements * packed_array_element_size(type));
+	}
+	template <PackedElement T>
+	constexpr SizeCounter &op_packed_array(const T *data, uint32_t elements)
+	{
+		return op_packed_array(packed_array_type<T>::value, data, elements);
+	}
+	template <PackedElement T>
+	constexpr SizeCounter &op_packed_array(const std::vector<T> &arr)
+	{
+		return op_packed_array(arr.data(), arr.size());
+	}
+	template <PackedElement T>
+	constexpr SizeCounter &op_aligned_packed_array(const T *data,
+												   uint32_t elements)
+	{
+		return op_aligned_packed_array(packed_array_type<T>::value, data,
+									   elements);
+	}
+	template <PackedElement T>
+	constexpr SizeCounter &op_aligned_packed_array(const std::vector<T> &arr)
+	{
+		return op_aligned_packed_array(arr.data(), arr.size());
+	}
+	constexpr SizeCounter &op_half_array(const float *data, uint32_t elements)
+	{
+		return op_packed_array(PACKED_HALF, data, elements);
+	}
+	constexpr SizeCounter &op_half_array(const std::vector<float> &data)
+	{
+		return op_half_array(data.data(), data.size());
+	}
+
+	// bit array
+	constexpr SizeCounter &op_bit_array_header(uint32_t elements)
+	{
+		return _add(1 + var_uint_size(elements));
+	}
+	constexpr SizeCounter &op_bit_array(const bool *, uint32_t elements)
+	{
+		op_bit_array_header(elements);
+		return _add(((size_t)elements + 7) / 8);
+	}
+	constexpr SizeCounter &op_bit_array(const std::vector<bool> &data)
+	{
+		return op_bit_array(nullptr, data.size());
+	}
+	constexpr SizeCounter &op(const std::vector<bool> &data)
+	{
+		return op_bit_array(data);
+	}
+	template <size_t N>
+	constexpr SizeCounter &op(const std::bitset<N> &)
+	{
+		return op_bit_array(nullptr, N);
+	}
+
+	constexpr SizeCounter &op_untyped_var_uint(uint64_t value)
+	{
+		return _add(var_uint_size(value));
+	}
+	constexpr SizeCounter &op_untyped_var_int(int64_t value)
+	{
+		const uint64_t uvalue = value;
+		const uint64_t sign = uvalue >> 63;
+		const uint64_t abs = sign ? ~uvalue : uvalue;
+		return op_untyped_var_uint((abs << 1) | sign);
+	}
+
+	constexpr SizeCounter &op_untyped_uint32(uint32_t) { return _add(4); }
+
+	constexpr void set_error(Errors error) { errors |= error; }
+	constexpr Errors get_errors() const { return (Errors)errors; }
+
+public:
+	template <typename T>
+	constexpr SizeCounter &op(const T *data, uint32_t elements)
+	{
+		if (elements > MAX_ARRAY_ELEMENTS) {
+			set_error(ERROR_ARRAY_TOO_BIG);
+			return *this;
+		}
+		op_array_header(elements);
+		if constexpr (std::is_same_v<T, float>) {
+			_add(5 * (size_t)elements);
+		} else if constexpr (std::is_same_v<T, double>) {
+			_add(9 * (size_t)elements);
+		} else if constexpr (std::is_same_v<T, bool>) {
+			_add(elements);
+		} else {
+			for (uint32_t i = 0; i < elements; ++i)
+				op(data[i]);
+		}
+		return *this;
+	}
+
+	template <typename T>
+	constexpr SizeCounter &op(const std::vector<T> &arr)
+	{
+		if (arr.size() > MAX_ARRAY_ELEMENTS) {
+			set_error(ERROR_ARRAY_TOO_BIG);
+			return *this;
+		}
+		return op<T>(arr.data(), arr.size());
+	}
+
+	template <typename T>
+	constexpr SizeCounter &op_indexed_array(const T *data, uint32_t elements)
+	{
+		if (elements > MAX_ARRAY_ELEMENTS) {
+			set_error(ERROR_ARRAY_TOO_BIG);
+			return *this;
+		}
+		uint32_t offset = 0;
+		op_begin_indexed_array(elements, offset);
+		for (uint32_t i = 0; i < elements; ++i)
+			op(data[i]);
+		return op_end_indexed_array(offset, elements);
+	}
+
+	template <typename T>
+	constexpr SizeCounter &op_indexed_array(const std::vector<T> &arr)
+	{
+		if (arr.size() > MAX_ARRAY_ELEMENTS) {
+			set_error(ERROR_ARRAY_TOO_BIG);
+			return *this;
+		}
+		return op_indexed_array<T>(arr.data(), arr.size());
+	}
+
+	template <typename K, typename V>
+	constexpr SizeCounter &op(const std::map<K, V> &map)
+	{
+		if (map.size() > MAX_ARRAY_ELEMENTS) {
+			set_error(ERROR_ARRAY_TOO_BIG);
+			return *this;
+		}
+		op_map_header(map.size());
+		for (const auto &[key, value] : map) {
+			op(key);
+			op(value);
+		}
+		return *this;
+	}
+
+	template <typename K, typename V>
+	constexpr SizeCounter &op_sorted_map(const std::map<K, V> &map)
+	{
+		if (map.size() > MAX_ARRAY_ELEMENTS) {
+			set_error(ERROR_ARRAY_TOO_BIG);
+			return *this;
+		}
+		if (impl::writes_sorted_map(map) == false) {
+			return op(map);
+		}
+		uint32_t offset = 0;
+		op_begin_sorted_map(map.size(), offset);
+		for (const auto &[key, value] : map) {
+			op(key);
+			op(value);
+		}
+		return op_end_sorted_map(offset, map.size());
+	}
+
+private:
+	constexpr SizeCounter &_add(size_t bytes)
+	{
+		size += bytes;
+		return *this;
+	}
+
+public:
+	size_t size = 0;
+	uint32_t errors = 0;
+};
+
+// Exact number of bytes that v2::ByteWriter would produce for item written
+// at given offset of output.
+template<typename T>
+constexpr size_t encoded_size(const T &item, uint32_t offset = 0)
+{
+	SizeCounter counter;
+	counter.size = offset;
+	counter.op(item);
+	return counter.size - offset;
+}
+
+namespace impl
+{
+template<typename T>
+constexpr size_t _max_encoded_size()
+{
+	MaxSizeCounter counter;
+	counter.op(T{});
+	return counter.fixed && counter.errors == 0 ? counter.size : 0;
+}
+
+
+// Bound derived from T{} holds for every value only when encoded shape does
+// not depend on value. Numbers and bitsets have fixed shape, other classes
+// have to declare it.
+template<typename T>
+concept _fixed_shape = std::is_class_v<T> == false ||
+					   requires { requires T::FIXED_ENCODED_SIZE; } ||
+					   requires(const T &bits) {
+						   []<size_t N>(const std::bitset<N> &) {}(bits);
+					   };
+} // namespace impl
+
+template<typename T>
+concept FixedEncodedSize =
+	impl::_fixed_shape<T> && std::is_default_constructible_v<T> &&
+	std::is_trivially_destructible_v<T> &&
+	requires {
+		typename std::integral_constant<size_t,
+										impl::_max_encoded_size<T>()>;
+	} && impl::_max_encoded_size<T>() != 0;
+
+/*
+ * Upper bound of bytes produced by v2::ByteWriter for any value of T. Defined
+ * for numbers, bitsets and classes which declare
+ *
+ *   constexpr static bool FIXED_ENCODED_SIZE = true;
+ *
+ * for which it is derived from serialize() evaluated at compile time on T{}.
+ * This requires serialize() to be constexpr (as with
+ * BITSCPP_DEFINE_INLINE_SERIALIZE_METHOD) and to write the same set of fields
+ * for every value: no optional fields and no loops over counts stored in
+ * value, as ByteWriter writes such types without capacity checks. Can be
+ * specialized for other types.
+ */
+template<typename T>
+struct max_encoded_size {
+};
+
+template<FixedEncodedSize T>
+struct max_encoded_size<T> {
+	constexpr static size_t value = impl::_max_encoded_size<T>();
+};
+
+template<typename T>
+inline constexpr size_t max_encoded_size_v = max_encoded_size<T>::value;
+
+} // namespace v2
+} // namespace bitscpp
+
+#endif
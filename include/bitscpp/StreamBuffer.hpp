@@ -0,0 +1,158 @@
+// Copyright (C) 2026 Marek Zalewski aka Drwalin
+//
+// This file is part of bitscpp project under MIT License
+// You should have received a copy of the MIT License along with this program.
+
+#ifndef BITSCPP_STREAM_BUFFER_HPP
+#define BITSCPP_STREAM_BUFFER_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
+#include <functional>
+#include <memory>
+
+#if __has_include(<unistd.h>)
+#include <unistd.h>
+#include <cerrno>
+#define BITSCPP_HAS_UNISTD 1
+#endif
+
+/*
+ * Provides cursor interface of v2::ByteWriter (see ByteWriter_v2.hpp) over
+ * fixed size staging buffer, which is passed to sink whenever it is full.
+ * Memory usage does not depend on size of output and output is not limited
+ * by MAX_BUFFER_SIZE.
+ *
+ * Sink returns false on failure, then ByteWriter sets ERROR_BUFFER_TOO_SMALL
+ * and nothing more is passed to sink. Byte arrays bigger than staging buffer
+ * are passed to sink directly. ByteWriter requests windows of at most
+ * ByteWriter::UNLIMITED_SIZE_MAX_BOUND bytes, staging buffer smaller than
+ * that grows for such window and is reallocated back to its configured size
+ * on next flush.
+ *
+ * Usage:
+ *   bitscpp::StreamBuffer stream(bitscpp::StreamBuffer::FileDescriptorSink(fd));
+ *   bitscpp::v2::ByteWriter writer(&stream);
+ *   writer.op(...);
+ *   writer.Commit();
+ *   stream.flush();
+ */
+
+namespace bitscpp
+{
+class StreamBuffer {
+public:
+	using Sink = std::function<bool(const uint8_t *data, size_t bytes)>;
+
+	constexpr static bool UNLIMITED_SIZE = true;
+	constexpr static size_t DEFAULT_STAGING_SIZE = 64 * 1024;
+
+public:
+	inline StreamBuffer(Sink sink, size_t stagingSize = DEFAULT_STAGING_SIZE)
+		: sink(std::move(sink)), staging(new uint8_t[stagingSize]),
+		  capacity(stagingSize), stagingSize(stagingSize) {}
+	~StreamBuffer() = default;
+	StreamBuffer(StreamBuffer &o) = delete;
+	StreamBuffer(const StreamBuffer &o) = delete;
+	StreamBuffer &operator=(StreamBuffer &o) = delete;
+	StreamBuffer &operator=(const StreamBuffer &o) = delete;
+
+#ifdef BITSCPP_HAS_UNISTD
+	// Sink writing everything into file descriptor.
+	inline static Sink FileDescriptorSink(int fd) {
+		return [fd](const uint8_t *data, size_t bytes) -> bool {
+			while (bytes) {
+				const ssize_t written = ::write(fd, data, bytes);
+				if (written < 0) {
+					if (errno == EINTR) {
+						continue;
+					}
+					return false;
+				}
+				data += written;
+				bytes -= written;
+			}
+			return true;
+		};
+	}
+#endif
+
+	// Total number of bytes written, including not yet flushed.
+	inline size_t size() const {
+		return flushed + used;
+	}
+	inline size_t flushed_size() const {
+		return flushed;
+	}
+	inline bool failed() const {
+		return sinkFailed;
+	}
+
+	// Passes staged bytes to sink. Has to be called after
+	// ByteWriter::Commit() at the end of output.
+	inline bool flush() {
+		if (used && sinkFailed == false) {
+			sinkFailed = !sink(staging.get(), used);
+			if (sinkFailed == false) {
+				flushed += used;
+			}
+		}
+		used = 0;
+		if (capacity > stagingSize) {
+			[[unlikely]];
+			staging.reset(new uint8_t[stagingSize]);
+			capacity = stagingSize;
+		}
+		return !sinkFailed;
+	}
+
+	inline uint8_t *next_window(uint8_t *cursor, size_t bytes, uint8_t *&end) {
+		commit_window(cursor);
+		if (capacity - used < bytes) {
+			if (flush() == false) {
+				return nullptr;
+			}
+			if (capacity < bytes) {
+				[[unlikely]];
+				staging.reset(new uint8_t[bytes]);
+				capacity = bytes;
+			}
+		}
+		end = staging.get() + capacity;
+		return staging.get() + used;
+	}
+	inline void commit_window(uint8_t *cursor) {
+		if (cursor != nullptr) {
+			used = cursor - staging.get();
+		}
+	}
+	inline void write(const uint8_t *data, uint32_t bytes) {
+		if (capacity - used >= bytes) {
+			memcpy(staging.get() + used, data, bytes);
+			used += bytes;
+			return;
+		}
+		if (flush() == false) {
+			return;
+		}
+		sinkFailed = !sink(data, bytes);
+		if (sinkFailed == false) {
+			flushed += bytes;
+		}
+	}
+
+private:
+	Sink sink;
+	std::unique_ptr<uint8_t[]> staging;
+	size_t capacity = 0;
+	// configured size, restored after window bigger than it
+	size_t stagingSize = 0;
+	size_t used = 0;
+	size_t flushed = 0;
+	bool sinkFailed = false;
+};
+}
+
+#endif
@@ -0,0 +1,132 @@
+// Copyright (C) 2026 Marek Zalewski aka Drwalin
+//
+// This file is part of bitscpp project under MIT License
+// You should have received a copy of the MIT License along with this program.
+
+#ifndef BITSCPP_TAPE_V2_HPP
+#define BITSCPP_TAPE_V2_HPP
+
+#include <cstdint>
+
+#include <vector>
+
+#include "V2_Specification.hpp"
+#include "ByteReader_v2.hpp"
+
+/*
+ * Structural index of V2 buffer, for random access to values deep inside of
+ * it without decoding values before them.
+ *
+ * Tape::build() validates buffer with the same rules as v2::validate() and,
+ * in the same pass, records every value (except END_OBJECT) as TapeEntry in
+ * order of headers. Values nested in arrays, maps and objects follow entry
+ * of their container, and TapeEntry::next of every value points behind all
+ * values nested in it, so that siblings are reached in O(1). Arrays and maps
+ * additionally have table of tape indices of their elements, which allows
+ * TapeCursor to access element, key or value by index in O(1). Fields of
+ * objects are reached by iterating siblings.
+ *
+ * Values are decoded with ByteReader returned by TapeCursor::reader(). Tape
+ * does not own buffer, it has to outlive tape and its cursors.
+ *
+ * build() costs more than decoding whole buffer once (about 2x for rows of
+ * small structs), writes an entry per value and an element table for every
+ * array and map. Tape pays off when buffer is too big to decode for the few
+ * values needed, or when the same tape serves many lookups. For single
+ * sequential pass decode buffer with ByteReader instead.
+ */
+
+namespace bitscpp
+{
+namespace v2
+{
+struct TapeEntry {
+	// Offset of value header in buffer.
+	uint32_t offset;
+	// Index of first entry after this value and all values nested in it.
+	uint32_t next;
+	// Arrays, indexed arrays, maps and sorted maps (not packed or bit
+	// arrays): index in Tape::elements of number of elements (map entries),
+	// followed by tape indices of elements (keys and values of maps one after
+	// another). 0 for other values.
+	uint32_t elements;
+	// Detailed type of value, like ByteReader::get_next_detailed_type().
+	Type type;
+};
+
+class Tape;
+
+class TapeCursor
+{
+public:
+	TapeCursor() = default;
+	inline TapeCursor(const Tape *tape, uint32_t index, uint32_t end)
+		: tape(tape), index(index), end(end)
+	{
+	}
+
+	// False for cursors past last value of container or out of range.
+	bool is_valid() const;
+	Type get_type() const;
+	Type get_detailed_type() const;
+	uint32_t get_offset() const;
+	uint32_t get_tape_index() const;
+
+	// Number of elements of array or entries of map, 0 for other values.
+	uint32_t size() const;
+	// Element of array, key and value of map entry.
+	TapeCursor element(uint32_t i) const;
+	TapeCursor key(uint32_t i) const;
+	TapeCursor value(uint32_t i) const;
+	// First value nested in array, map or object.
+	TapeCursor first_child() const;
+	// Field of object by position, in O(i).
+	TapeCursor field(uint32_t i) const;
+	// Next value in the same container (or at top level).
+	TapeCursor next() const;
+
+	// Reader positioned at header of value.
+	ByteReader reader() const;
+
+private:
+	TapeCursor child(uint32_t slot) const;
+
+	const Tape *tape = nullptr;
+	uint32_t index = 0;
+	// Index behind last value of container of cursor.
+	uint32_t end = 0;
+};
+
+class Tape
+{
+public:
+	// Indexes whole buffer. On error tape is empty and errors of
+	// v2::validate() are returned.
+	Errors build(const uint8_t *buffer, uint32_t size);
+
+	void clear();
+
+	// Number of values at top level of buffer.
+	uint32_t size() const;
+	// Top level value by index, in O(1).
+	TapeCursor root(uint32_t i) const;
+	TapeCursor first() const;
+
+	const uint8_t *get_buffer() const;
+	uint32_t get_buffer_size() const;
+
+	std::vector<TapeEntry> entries;
+	std::vector<uint32_t> elements;
+	// Tape indices of top level values.
+	std::vector<uint32_t> roots;
+
+private:
+	const uint8_t *buffer = nullptr;
+	uint32_t bufferSize = 0;
+};
+} // namespace v2
+} // namespace bitscpp
+
+#include "../../src/Tape_v2.inl.hpp"
+
+#endif
@@ -43,6 +43,14 @@ enum Type : uint8_t {
 	V2_DETAIL_HALF = V2_FLOAT | 0x20,
 	V2_DETAIL_BFLOAT = V2_FLOAT | 0x60,
 	V2_DETAIL_DOUBLE = V2_FLOAT | 0x40,
+
+	V2_DETAIL_SIZED_OBJECT_BEGIN = V2_OBJECT_BEGIN | 0x20,
+
+	V2_DETAIL_PACKED_ARRAY = V2_ARRAY | 0x20,
+	V2_DETAIL_BIT_ARRAY = V2_ARRAY | 0x40,
+	V2_DETAIL_INDEXED_ARRAY = V2_ARRAY | 0x60,
+
+	V2_DETAIL_SORTED_MAP = V2_MAP | 0x20,
 };
 
 enum TypeHeader : uint8_t {
@@ -81,7 +89,14 @@ enum TypeHeader : uint8_t {
 	END_STRING_IMMEDIATE_SIZED = 0xF8, // inclusive
 	BEG_STRING_VAR_SIZED = 0xF9,
 
-	BEG_RESERVED = 0xFA,
+	BEG_SIZED_OBJECT = 0xFA,
+
+	BEG_PACKED_ARRAY = 0xFB,
+	BEG_BIT_ARRAY = 0xFC,
+	BEG_INDEXED_ARRAY = 0xFD,
+	BEG_SORTED_MAP = 0xFE,
+
+	BEG_RESERVED = 0xFF,
 	END_RESERVED = 0xFF, // inclusive
 };
 
@@ -96,6 +111,92 @@ static_assert(IMMEDIATE_STRING_MAX_SIZE == 36);
 static_assert(IMMEDIATE_INTEGER_MAX == 159);
 static_assert(IMMEDIATE_ARRAY_MAX_SIZE == 17);
 
+// Size of byte length following BEG_SIZED_OBJECT header.
+inline const static uint32_t SIZED_OBJECT_LENGTH_BYTES = 4;
+
+// Element type of packed array, stored in byte following BEG_PACKED_ARRAY
+// header. Lowest 2 bits are log2 of element size.
+enum PackedArrayType : uint8_t {
+	PACKED_INT8 = 0x00,
+	PACKED_INT16 = 0x01,
+	PACKED_INT32 = 0x02,
+	PACKED_INT64 = 0x03,
+	PACKED_UINT8 = 0x04,
+	PACKED_UINT16 = 0x05,
+	PACKED_UINT32 = 0x06,
+	PACKED_UINT64 = 0x07,
+	PACKED_HALF = 0x09,
+	PACKED_FLOAT = 0x0A,
+	PACKED_DOUBLE = 0x0B,
+};
+
+// Flag of element type byte. When set, element count is followed by byte with
+// number of padding bytes that follow it, so that data begins at offset from
+// beginning of buffer divisible by element size.
+inline const static uint8_t PACKED_ARRAY_ALIGNED = 0x80;
+inline const static uint32_t PACKED_ARRAY_MAX_PADDING = 7;
+
+// Valid byte widths of entries of offset table of indexed array.
+inline constexpr bool is_valid_indexed_array_width(uint8_t width)
+{
+	return width == 1 || width == 2 || width == 4;
+}
+
+inline constexpr uint32_t packed_array_element_size(uint8_t type)
+{
+	return 1u << (type & 0x03);
+}
+inline constexpr bool is_valid_packed_array_type(uint8_t type)
+{
+	return type <= PACKED_UINT64 || type == PACKED_HALF ||
+		   type == PACKED_FLOAT || type == PACKED_DOUBLE;
+}
+// Number of padding bytes needed for data starting at given offset.
+inline constexpr uint32_t packed_array_padding(uint8_t type, uint64_t offset)
+{
+	return (0 - offset) & (packed_array_element_size(type) - 1);
+}
+
+// Types which can be stored in packed array.
+template<typename T>
+struct packed_array_type {
+};
+template<> struct packed_array_type<int8_t> {
+	constexpr static PackedArrayType value = PACKED_INT8;
+};
+template<> struct packed_array_type<int16_t> {
+	constexpr static PackedArrayType value = PACKED_INT16;
+};
+template<> struct packed_array_type<int32_t> {
+	constexpr static PackedArrayType value = PACKED_INT32;
+};
+template<> struct packed_array_type<int64_t> {
+	constexpr static PackedArrayType value = PACKED_INT64;
+};
+template<> struct packed_array_type<uint8_t> {
+	constexpr static PackedArrayType value = PACKED_UINT8;
+};
+template<> struct packed_array_type<uint16_t> {
+	constexpr static PackedArrayType value = PACKED_UINT16;
+};
+template<> struct packed_array_type<uint32_t> {
+	constexpr static PackedArrayType value = PACKED_UINT32;
+};
+template<> struct packed_array_type<uint64_t> {
+	constexpr static PackedArrayType value = PACKED_UINT64;
+};
+template<> struct packed_array_type<float> {
+	constexpr static PackedArrayType value = PACKED_FLOAT;
+};
+template<> struct packed_array_type<double> {
+	constexpr static PackedArrayType value = PACKED_DOUBLE;
+};
+
+template<typename T>
+concept PackedElement = requires { packed_array_type<T>::value; } &&
+						sizeof(T) == packed_array_element_size(
+										 packed_array_type<T>::value);
+
 enum TypeHeader_ImmediateIntegerRanges : int64_t {
 	IMMEDIATE_INTEGER_VALUE_MIN = -31,
 	IMMEDIATE_INTEGER_VALUE_MAX = 128,
@@ -149,7 +250,14 @@ enum TypeHeader_ImmediateIntegerRanges : int64_t {
 	V2_STRING, V2_STRING, V2_STRING, V2_STRING, V2_STRING,
 	V2_STRING,
 
-	V2_RESERVED, V2_RESERVED, V2_RESERVED, V2_RESERVED, V2_RESERVED, V2_RESERVED,
+	V2_DETAIL_SIZED_OBJECT_BEGIN,
+
+	V2_DETAIL_PACKED_ARRAY,
+	V2_DETAIL_BIT_ARRAY,
+	V2_DETAIL_INDEXED_ARRAY,
+	V2_DETAIL_SORTED_MAP,
+
+	V2_RESERVED,
 };
 
 static_assert(headerTranslation[BEG_IMMEDIATE_INTEGER] == V2_INT);
@@ -181,6 +289,13 @@ static_assert(headerTranslation[BEG_STRING_IMMEDIATE_SIZED] == V2_STRING);
 static_assert(headerTranslation[END_STRING_IMMEDIATE_SIZED] == V2_STRING);
 static_assert(headerTranslation[BEG_STRING_VAR_SIZED] == V2_STRING);
 
+static_assert(headerTranslation[BEG_SIZED_OBJECT] == V2_DETAIL_SIZED_OBJECT_BEGIN);
+
+static_assert(headerTranslation[BEG_PACKED_ARRAY] == V2_DETAIL_PACKED_ARRAY);
+static_assert(headerTranslation[BEG_BIT_ARRAY] == V2_DETAIL_BIT_ARRAY);
+static_assert(headerTranslation[BEG_INDEXED_ARRAY] == V2_DETAIL_INDEXED_ARRAY);
+static_assert(headerTranslation[BEG_SORTED_MAP] == V2_DETAIL_SORTED_MAP);
+
 static_assert(headerTranslation[BEG_RESERVED] == V2_RESERVED);
 static_assert(headerTranslation[END_RESERVED] == V2_RESERVED);
 } // namespace v2
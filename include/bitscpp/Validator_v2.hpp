@@ -0,0 +1,60 @@
+// Copyright (C) 2026 Marek Zalewski aka Drwalin
+//
+// This file is part of bitscpp project under MIT License
+// You should have received a copy of the MIT License along with this program.
+
+#ifndef BITSCPP_VALIDATOR_V2_HPP
+#define BITSCPP_VALIDATOR_V2_HPP
+
+#include <cstdint>
+
+#include "V2_Specification.hpp"
+
+/*
+ * Structural validation of whole V2 buffer in single pass, without decoding
+ * values. Buffer is valid when it is a sequence of complete values, where:
+ *   - every header is not reserved,
+ *   - every payload, length, count and VAR_UINT fits inside buffer,
+ *   - counts of arrays, maps, strings, packed arrays and bit arrays are not
+ *     bigger than MAX_ARRAY_ELEMENTS,
+ *   - every begin object has matching end object and sized object ends
+ *     exactly at its stored length,
+ *   - offset tables of indexed arrays and sorted maps are strictly
+ *     increasing and every element (map entry) ends exactly at its offset,
+ *   - packed arrays have valid element type and padding.
+ *
+ * Returns ERROR_OK for valid buffer, otherwise flags of the first problem:
+ *   ERROR_BUFFER_TOO_SMALL - value, or unclosed object or array, is cut by
+ *                            end of buffer,
+ *   ERROR_TYPE_MISMATCH    - reserved header, unmatched end object, wrong
+ *                            sized object length, wrong packed array type or
+ *                            wrong offset table,
+ *   ERROR_ARRAY_TOO_BIG    - count above MAX_ARRAY_ELEMENTS,
+ *   ERROR_BUFFER_NULLPTR   - buffer is nullptr.
+ *
+ * Order of keys of sorted maps is not checked.
+ *
+ * Buffer accepted by validate() can be read by UncheckedByteReader without
+ * reads outside of buffer, as long as reading code follows the structure of
+ * buffer.
+ *
+ * Only runs of single byte values (immediate integers, booleans and empty
+ * strings) are classified with SIMD (SSE2, or AVX2 when enabled at compile
+ * time). Every other header is sized one by one, and position of the next
+ * header depends on it, as in decoding. validate() costs about as much as a
+ * checked decode, so validate() followed by UncheckedByteReader is not faster
+ * than ByteReader for single decode. It pays off only when validated buffer
+ * is read more than once.
+ */
+
+namespace bitscpp
+{
+namespace v2
+{
+Errors validate(const uint8_t *buffer, uint32_t size);
+} // namespace v2
+} // namespace bitscpp
+
+#include "../../src/Validator_v2.inl.hpp"
+
+#endif
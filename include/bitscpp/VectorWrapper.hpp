@@ -62,6 +62,9 @@ public:
 		}
 		vector.reserve((c*3)/2+32);
 	}
+	inline void reserve_exact(size_t c) {
+		vector.reserve(c);
+	}
 	inline void clear() {
 		vector.clear();
 	}
@@ -0,0 +1,100 @@
+// Copyright (C) 2026 Marek Zalewski aka Drwalin
+//
+// This file is part of bitscpp project under MIT License
+// You should have received a copy of the MIT License along with this program.
+
+#ifndef BITSCPP_BIT_ARRAY_V2_INL_HPP
+#define BITSCPP_BIT_ARRAY_V2_INL_HPP
+
+#include <cstdint>
+#include <cstring>
+
+#include "Simd.inl.hpp"
+
+#include "../include/bitscpp/Endianness.hpp"
+
+/*
+ * Packing of bool arrays into bit arrays, element i is stored in bit (i % 8)
+ * of byte (i / 8). 16 elements are converted at once with SSE2, remaining
+ * ones by 8 with 64-bit multiplication.
+ */
+
+namespace bitscpp
+{
+namespace v2
+{
+namespace impl
+{
+inline constexpr uint32_t bit_array_bytes(uint32_t elements)
+{
+	return (elements >> 3) + ((elements & 7) != 0);
+}
+
+// Unused bits of last byte are cleared.
+inline void pack_bits(uint8_t *dst, const bool *src, uint32_t elements)
+{
+	uint32_t i = 0;
+#ifdef BITSCPP_SSE2
+	for (; i + 16 <= elements; i += 16) {
+		// move lowest bit of every byte into its sign bit
+		const __m128i v = _mm_loadu_si128((const __m128i *)(src + i));
+		const uint16_t bits = _mm_movemask_epi8(_mm_slli_epi64(v, 7));
+		dst[0] = bits;
+		dst[1] = bits >> 8;
+		dst += 2;
+	}
+#endif
+	for (; i + 8 <= elements; i += 8) {
+		uint64_t x;
+		memcpy(&x, src + i, 8);
+		// byte j of x becomes bit j
+		x = NetworkToHostUint(x) & 0x0101010101010101llu;
+		*dst++ = (x * 0x0102040810204080llu) >> 56;
+	}
+	if (i < elements) {
+		uint8_t byte = 0;
+		for (uint32_t j = 0; i + j < elements; ++j) {
+			byte |= (uint8_t)src[i + j] << j;
+		}
+		*dst = byte;
+	}
+}
+
+inline void unpack_bits(bool *dst, const uint8_t *src, uint32_t elements)
+{
+	uint32_t i = 0;
+#ifdef BITSCPP_SSE2
+	const __m128i pattern =
+		_mm_set_epi8((char)0x80, 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01,
+					 (char)0x80, 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01);
+	for (; i + 16 <= elements; i += 16) {
+		// byte j of v is byte j / 8 of src, then bit j % 8 of it is tested
+		uint16_t bits;
+		memcpy(&bits, src, 2);
+		__m128i v = _mm_cvtsi32_si128(NetworkToHostUint(bits));
+		v = _mm_unpacklo_epi8(v, v);
+		v = _mm_unpacklo_epi16(v, v);
+		v = _mm_unpacklo_epi32(v, v);
+		const __m128i set =
+			_mm_cmpeq_epi8(_mm_and_si128(v, pattern), pattern);
+		_mm_storeu_si128((__m128i *)(dst + i),
+						 _mm_and_si128(set, _mm_set1_epi8(1)));
+		src += 2;
+	}
+#endif
+	for (; i + 8 <= elements; i += 8) {
+		// bit j becomes byte j of x
+		uint64_t x = (*src++ * 0x0101010101010101llu) & 0x8040201008040201llu;
+		x = ((x + 0x7F7F7F7F7F7F7F7Fllu) >> 7) & 0x0101010101010101llu;
+		x = HostToNetworkUint(x);
+		memcpy(dst + i, &x, 8);
+	}
+	for (uint32_t j = 0; i + j < elements; ++j) {
+		dst[i + j] = (*src >> j) & 1;
+	}
+}
+} // namespace impl
+} // namespace v2
+} // namespace bitscpp
+
+#endif
@@ -0,0 +1,1434 @@
+// Copyright (C) 2023-2026 Marek Zalewski aka Drwalin
+//
+// This file is part of bitscpp project under MIT License
+// You should have received a copy of the MIT License along with this program.
+
+#ifndef BITSCPP_BYTE_READER_V2_INL_HPP
+#define BITSCPP_BYTE_READER_V2_INL_HPP
+
+#include <cassert>
+#include <cstdint>
+
+#include <string>
+#include <string_view>
+
+#include "../include/bitscpp/Endianness.hpp"
+#include "../include/bitscpp/HalfFloat.hpp"
+#include "../include/bitscpp/V2_Specification.hpp"
+
+#include "../include/bitscpp/ByteReader_v2.hpp"
+
+#include "IntegerArray_v2.inl.hpp"
+#include "BitArray_v2.inl.hpp"
+#include "Validator_v2.inl.hpp"
+
+namespace bitscpp
+{
+namespace v2
+{
+template<bool CHECKED>
+inline Type BasicByteReader<CHECKED>::get_next_type() const
+{
+	return (Type)((uint8_t)get_next_detailed_type() & 0x1F);
+}
+template<bool CHECKED>
+inline Type BasicByteReader<CHECKED>::get_next_detailed_type() const
+{
+	if (ptr >= end) {
+		[[unlikely]];
+		return V2_ERROR;
+	} else {
+		return headerTranslation[*ptr];
+	}
+}
+
+template<bool CHECKED>
+bool BasicByteReader<CHECKED>::is_next_integer() const
+{
+	return get_next_detailed_type() == V2_INT;
+}
+template<bool CHECKED>
+bool BasicByteReader<CHECKED>::is_next_floating_point() const
+{
+	return get_next_type() == V2_FLOAT;
+}
+template<bool CHECKED>
+bool BasicByteReader<CHECKED>::is_next_float16() const
+{
+	return get_next_detailed_type() == V2_DETAIL_HALF;
+}
+template<bool CHECKED>
+bool BasicByteReader<CHECKED>::is_next_bfloat16() const
+{
+	return get_next_detailed_type() == V2_DETAIL_BFLOAT;
+}
+template<bool CHECKED>
+bool BasicByteReader<CHECKED>::is_next_float32() const
+{
+	return get_next_detailed_type() == V2_FLOAT;
+}
+template<bool CHECKED>
+bool BasicByteReader<CHECKED>::is_next_float64() const
+{
+	return get_next_detailed_type() == V2_DETAIL_DOUBLE;
+}
+template<bool CHECKED>
+bool BasicByteReader<CHECKED>::is_next_bool() const
+{
+	return get_next_detailed_type() == V2_BOOLEAN;
+}
+template<bool CHECKED>
+bool BasicByteReader<CHECKED>::is_next_string() const
+{
+	return get_next_detailed_type() == V2_STRING;
+}
+template<bool CHECKED>
+bool BasicByteReader<CHECKED>::is_next_map() const
+{
+	return get_next_type() == V2_MAP;
+}
+template<bool CHECKED>
+bool BasicByteReader<CHECKED>::is_next_sorted_map() const
+{
+	return get_next_detailed_type() == V2_DETAIL_SORTED_MAP;
+}
+template<bool CHECKED>
+bool BasicByteReader<CHECKED>::is_next_array() const
+{
+	const Type type = get_next_detailed_type();
+	return type == V2_ARRAY || type == V2_DETAIL_INDEXED_ARRAY;
+}
+template<bool CHECKED>
+bool BasicByteReader<CHECKED>::is_next_indexed_array() const
+{
+	return get_next_detailed_type() == V2_DETAIL_INDEXED_ARRAY;
+}
+template<bool CHECKED>
+bool BasicByteReader<CHECKED>::is_next_packed_array() const
+{
+	return get_next_detailed_type() == V2_DETAIL_PACKED_ARRAY;
+}
+template<bool CHECKED>
+bool BasicByteReader<CHECKED>::is_next_half_array() const
+{
+	return has_bytes_to_read(2) && ptr[0] == BEG_PACKED_ARRAY &&
+		   (ptr[1] & ~PACKED_ARRAY_ALIGNED) == PACKED_HALF;
+}
+template<bool CHECKED>
+bool BasicByteReader<CHECKED>::is_next_bit_array() const
+{
+	return get_next_detailed_type() == V2_DETAIL_BIT_ARRAY;
+}
+template<bool CHECKED>
+bool BasicByteReader<CHECKED>::is_next_beg_object() const
+{
+	return get_next_type() == V2_OBJECT_BEGIN;
+}
+template<bool CHECKED>
+bool BasicByteReader<CHECKED>::is_next_sized_object() const
+{
+	return get_next_detailed_type() == V2_DETAIL_SIZED_OBJECT_BEGIN;
+}
+template<bool CHECKED>
+bool BasicByteReader<CHECKED>::is_next_end_object() const
+{
+	return get_next_detailed_type() == V2_OBJECT_END;
+}
+
+// strings
+template<bool CHECKED>
+BasicByteReader<CHECKED> &
+BasicByteReader<CHECKED>::op_sized_byte_array_header(uint32_t &bytes)
+{
+	if (has_bytes_to_read(1) == false) {
+		[[unlikely]];
+		errors |= ERROR_BUFFER_TOO_SMALL;
+		bytes = 0;
+		return *this;
+	}
+
+	const uint8_t header = *ptr;
+	++ptr;
+	if (header < BEG_STRING_IMMEDIATE_SIZED) {
+		[[unlikely]];
+		errors |= ERROR_TYPE_MISMATCH;
+		bytes = 0;
+	} else if (header <= END_STRING_IMMEDIATE_SIZED) {
+		[[likely]];
+		bytes = header - BEG_STRING_IMMEDIATE_SIZED;
+	} else if (header == BEG_STRING_VAR_SIZED) {
+		uint64_t size = 0;
+		op_untyped_var_uint(size);
+		if (errors != 0) {
+			[[unlikely]];
+			bytes = 0;
+			return *this;
+		}
+		bytes = size + IMMEDIATE_STRING_MAX_SIZE + 1;
+		if (size > MAX_ARRAY_ELEMENTS - (IMMEDIATE_STRING_MAX_SIZE + 1)) {
+			[[unlikely]];
+			set_error(ERROR_ARRAY_TOO_BIG);
+			bytes = 0;
+			return *this;
+		}
+	} else {
+		[[unlikely]];
+		errors |= ERROR_TYPE_MISMATCH;
+		bytes = 0;
+	}
+
+	return *this;
+}
+template<bool CHECKED>
+BasicByteReader<CHECKED> &
+BasicByteReader<CHECKED>::op_sized_string_header(uint32_t &bytes)
+{
+	return op_sized_byte_array_header(bytes);
+}
+
+template<bool CHECKED>
+BasicByteReader<CHECKED> &BasicByteReader<CHECKED>::op(std::string &str)
+{
+	std::string_view sv;
+	op(sv);
+	str = sv;
+	return *this;
+}
+template<bool CHECKED>
+BasicByteReader<CHECKED> &BasicByteReader<CHECKED>::op(std::string_view &str)
+{
+	uint32_t size = 0;
+	op_sized_string_header(size);
+	if (errors != 0) {
+		[[unlikely]];
+		str = {};
+		return *this;
+	}
+	if (has_bytes_to_read(size)) {
+		str = std::string_view((const char *)ptr, size);
+		ptr += size;
+	} else {
+		[[unlikely]];
+		errors |= ERROR_BUFFER_TOO_SMALL;
+	}
+	return *this;
+}
+template<bool CHECKED>
+BasicByteReader<CHECKED> &
+BasicByteReader<CHECKED>::op_byte_array(char const **str, uint32_t &size)
+{
+	assert(str);
+	return op(*str, size);
+}
+template<bool CHECKED>
+BasicByteReader<CHECKED> &
+BasicByteReader<CHECKED>::op(char const *&str, uint32_t &size)
+{
+	std::string_view sv;
+	op(sv);
+	str = sv.data();
+	size = sv.size();
+	return *this;
+}
+
+// byte array
+template<bool CHECKED>
+BasicByteReader<CHECKED> &
+BasicByteReader<CHECKED>::op_byte_array(uint8_t const **data, uint32_t &bytes)
+{
+	assert(data);
+	return op_byte_array((char const **)data, bytes);
+}
+template<bool CHECKED>
+BasicByteReader<CHECKED> &
+BasicByteReader<CHECKED>::op_byte_array(uint8_t const *&data, uint32_t &bytes)
+{
+	uint8_t const **data_p = &data;
+	return op_byte_array(data_p, bytes);
+}
+template<bool CHECKED>
+BasicByteReader<CHECKED> &
+BasicByteReader<CHECKED>::op_byte_array(std::vector<uint8_t> &data)
+{
+	data.clear();
+	std::string_view sv;
+	op(sv);
+	if (errors == 0) {
+		[[unlikely]];
+		data.insert(data.end(), sv.begin(), sv.end());
+	}
+	return *this;
+}
+template<bool CHECKED>
+BasicByteReader<CHECKED> &
+BasicByteReader<CHECKED>::op(std::vector<uint8_t> &data)
+{
+	return op_byte_array(data);
+}
+template<bool CHECKED>
+BasicByteReader<CHECKED> &
+BasicByteReader<CHECKED>::op_byte_array(std::vector<char> &data)
+{
+	data.clear();
+	std::string_view sv;
+	op(sv);
+	if (errors == 0) {
+		[[unlikely]];
+		data.insert(data.end(), sv.begin(), sv.end());
+	}
+	return *this;
+}
+template<bool CHECKED>
+BasicByteReader<CHECKED> &BasicByteReader<CHECKED>::op(std::vector<char> &data)
+{
+	return op_byte_array(data);
+}
+
+// miscelanous
+template<bool CHECKED>
+inline BasicByteReader<CHECKED> &
+BasicByteReader<CHECKED>::op(bool &v) { return op_boolean(v); }
+template<bool CHECKED>
+inline BasicByteReader<CHECKED> &BasicByteReader<CHECKED>::op_boolean(bool &v)
+{
+	if (has_bytes_to_read(1) == false) {
+		[[unlikely]];
+		errors |= ERROR_BUFFER_TOO_SMALL;
+		return *this;
+	}
+	const uint8_t header = *ptr;
+	++ptr;
+	if (header == BOOLEAN_TRUE) {
+		v = true;
+		return *this;
+	} else if (header == BOOLEAN_FALSE) {
+		v = false;
+		return *this;
+	}
+	v = false;
+	errors |= ERROR_TYPE_MISMATCH;
+	return *this;
+}
+template<bool CHECKED>
+BasicByteReader<CHECKED> &BasicByteReader<CHECKED>::op_begin_object()
+{
+	if (has_bytes_to_read(1) == false) {
+		[[unlikely]];
+		errors |= ERROR_BUFFER_TOO_SMALL;
+		return *this;
+	}
+	if (*ptr == BEG_SIZED_OBJECT) {
+		uint32_t offset;
+		return op_begin_sized_object(offset);
+	}
+	const uint8_t header = *ptr;
+	++ptr;
+	if (header != BEG_OBJECT) {
+		[[unlikely]];
+		errors |= ERROR_TYPE_MISMATCH;
+	}
+	return *this;
+}
+template<bool CHECKED>
+BasicByteReader<CHECKED> &BasicByteReader<CHECKED>::op_end_object()
+{
+	if (has_bytes_to_read(1) == false) {
+		[[unlikely]];
+		errors |= ERROR_BUFFER_TOO_SMALL;
+		return *this;
+	}
+	const uint8_t header = *ptr;
+	++ptr;
+	if (header != END_OBJECT) {
+		[[unlikely]];
+		errors |= ERROR_TYPE_MISMATCH;
+	}
+	return *this;
+}
+template<bool CHECKED>
+BasicByteReader<CHECKED> &
+BasicByteReader<CHECKED>::op_begin_sized_object(uint32_t &offset)
+{
+	offset = 0;
+	if (has_bytes_to_read(1) == false) {
+		[[unlikely]];
+		errors |= ERROR_BUFFER_TOO_SMALL;
+		return *this;
+	}
+	if (*ptr != BEG_SIZED_OBJECT) {
+		return op_begin_object();
+	}
+	if (has_bytes_to_read(1 + SIZED_OBJECT_LENGTH_BYTES) == false) {
+		[[unlikely]];
+		errors |= ERROR_BUFFER_TOO_SMALL;
+		return *this;
+	}
+	const uint32_t length =
+		ReadBytesInNetworkOrder(ptr + 1, SIZED_OBJECT_LENGTH_BYTES);
+	ptr += 1 + SIZED_OBJECT_LENGTH_BYTES;
+	if (length == 0 || has_bytes_to_read(length) == false) {
+		[[unlikely]];
+		errors |= ERROR_BUFFER_TOO_SMALL;
+		return *this;
+	}
+	offset = get_offset() + length - 1;
+	return *this;
+}
+template<bool CHECKED>
+BasicByteReader<CHECKED> &
+BasicByteReader<CHECKED>::op_end_sized_object(uint32_t offset)
+{
+	if (offset != 0) {
+		const uint8_t *objectEnd = _buffer + offset;
+		if (ptr > objectEnd) {
+			[[unlikely]];
+			errors |= ERROR_TYPE_MISMATCH;
+			return *this;
+		}
+		ptr = objectEnd;
+	}
+	return op_end_object();
+}
+template<bool CHECKED>
+BasicByteReader<CHECKED> &BasicByteReader<CHECKED>::skip_object()
+{
+	if (is_next_sized_object() == false) {
+		[[unlikely]];
+		errors |= ERROR_TYPE_MISMATCH;
+		return *this;
+	}
+	uint32_t offset = 0;
+	op_begin_sized_object(offset);
+	if (errors) {
+		[[unlikely]];
+		return *this;
+	}
+	return op_end_sized_object(offset);
+}
+
+// integers
+template<bool CHECKED>
+inline BasicByteReader<CHECKED> &BasicByteReader<CHECKED>::op(uint8_t &v)
+{
+	uint64_t vv = 0;
+	op_uint(vv);
+	v = vv;
+	if (v != vv) {
+		set_error(ERROR_INTEGER_OVERFLOW);
+	}
+	return *this;
+}
+template<bool CHECKED>
+inline BasicByteReader<CHECKED> &BasicByteReader<CHECKED>::op(uint16_t &v)
+{
+	uint64_t vv = 0;
+	op_uint(vv);
+	v = vv;
+	if (v != vv) {
+		set_error(ERROR_INTEGER_OVERFLOW);
+	}
+	return *this;
+}
+template<bool CHECKED>
+inline BasicByteReader<CHECKED> &BasicByteReader<CHECKED>::op(uint32_t &v)
+{
+	uint64_t vv = 0;
+	op_uint(vv);
+	v = vv;
+	if (v != vv) {
+		set_error(ERROR_INTEGER_OVERFLOW);
+	}
+	return *this;
+}
+template<bool CHECKED>
+inline BasicByteReader<CHECKED> &BasicByteReader<CHECKED>::op(uint64_t &v)
+{
+	uint64_t vv = 0;
+	op_uint(vv);
+	v = vv;
+	if (v != vv) {
+		set_error(ERROR_INTEGER_OVERFLOW);
+	}
+	return *this;
+}
+template<bool CHECKED>
+inline BasicByteReader<CHECKED> &BasicByteReader<CHECKED>::op(int8_t &v)
+{
+	int64_t vv = 0;
+	op_int(vv);
+	v = vv;
+	if (v != vv) {
+		set_error(ERROR_INTEGER_OVERFLOW);
+	}
+	return *this;
+}
+template<bool CHECKED>
+inline BasicByteReader<CHECKED> &BasicByteReader<CHECKED>::op(int16_t &v)
+{
+	int64_t vv = 0;
+	op_int(vv);
+	v = vv;
+	if (v != vv) {
+		set_error(ERROR_INTEGER_OVERFLOW);
+	}
+	return *this;
+}
+template<bool CHECKED>
+inline BasicByteReader<CHECKED> &BasicByteReader<CHECKED>::op(int32_t &v)
+{
+	int64_t vv = 0;
+	op_int(vv);
+	v = vv;
+	if (v != vv) {
+		set_error(ERROR_INTEGER_OVERFLOW);
+	}
+	return *this;
+}
+template<bool CHECKED>
+inline BasicByteReader<CHECKED> &BasicByteReader<CHECKED>::op(int64_t &v)
+{
+	int64_t vv = 0;
+	op_int(vv);
+	v = vv;
+	if (v != vv) {
+		set_error(ERROR_INTEGER_OVERFLOW);
+	}
+	return *this;
+}
+template<bool CHECKED>
+inline BasicByteReader<CHECKED> &BasicByteReader<CHECKED>::op(char &v)
+{
+	int64_t vv = 0;
+	op_int(vv);
+	v = vv;
+	if (v != vv) {
+		set_error(ERROR_INTEGER_OVERFLOW);
+	}
+	return *this;
+}
+
+template<bool CHECKED>
+inline BasicByteReader<CHECKED> &BasicByteReader<CHECKED>::op_uint(uint64_t &v) {
+	int64_t vv = 0;
+	op_int(vv);
+	v = vv;
+	return *this;
+}
+template<bool CHECKED>
+inline BasicByteReader<CHECKED> &BasicByteReader<CHECKED>::op_int(int64_t &v)
+{
+	if (has_bytes_to_read(1) == false) {
+		[[unlikely]];
+		errors |= ERROR_BUFFER_TOO_SMALL;
+		return *this;
+	}
+	
+	const uint8_t header = *ptr;
+	++ptr;
+	uint64_t vv = 0;
+	if (header <= END_IMMEDIATE_INTEGER) {
+		v = (int64_t)(uint32_t)header + (int64_t)IMMEDIATE_INTEGER_VALUE_MIN;
+		return *this;
+	} else if (header <= END_12B_INTEGER) {
+		if (has_bytes_to_read(1) == false) {
+			[[unlikely]];
+			errors |= ERROR_BUFFER_TOO_SMALL;
+			return *this;
+		}
+		const uint8_t secondByte = *ptr;
+		++ptr;
+		vv = ((uint64_t)secondByte) << 4;
+		const uint8_t h = ((uint64_t)(header - BEG_12B_INTEGER));
+		assert(h < 16);
+		vv |= h;
+	} else if (header <= END_SIZED_INTEGER) {
+		const int bytes = header - BEG_SIZED_INTEGER + 2;
+		assert(bytes >= 2);
+		assert(bytes <= 8);
+		if (has_bytes_to_read(bytes) == false) {
+			[[unlikely]];
+			errors |= ERROR_BUFFER_TOO_SMALL;
+			return *this;
+		}
+		vv = _read_bytes(bytes);
+		ptr += bytes;
+	} else {
+		[[unlikely]];
+		errors |= ERROR_TYPE_MISMATCH;
+		return *this;
+	}
+	
+	const uint64_t sign = ((int64_t)(vv << 63)) >> 63;
+	assert((vv & 1) ? sign == -1ll : sign == 0);
+	const uint64_t abs = vv >> 1;
+	v = sign ^ abs;
+	static_assert(-1ll == (-10000000ll >> 63));
+	
+	return *this;
+}
+
+// floats
+template<bool CHECKED>
+BasicByteReader<CHECKED> &BasicByteReader<CHECKED>::op_half(float &v)
+{
+	if (has_bytes_to_read(3) == false) {
+		[[unlikely]];
+		errors |= ERROR_BUFFER_TOO_SMALL;
+		return *this;
+	}
+	if (ptr[0] != BEG_HALF) {
+		[[unlikely]];
+		errors |= ERROR_TYPE_MISMATCH;
+		return *this;
+	}
+	_read_half(ptr + 1, v);
+	ptr += 3;
+	return *this;
+}
+template<bool CHECKED>
+BasicByteReader<CHECKED> &BasicByteReader<CHECKED>::op_bfloat(float &v)
+{
+	if (has_bytes_to_read(3) == false) {
+		[[unlikely]];
+		errors |= ERROR_BUFFER_TOO_SMALL;
+		return *this;
+	}
+	if (ptr[0] != BEG_BFLOAT) {
+		[[unlikely]];
+		errors |= ERROR_TYPE_MISMATCH;
+		return *this;
+	}
+	_read_bfloat(ptr + 1, v);
+	ptr += 3;
+	return *this;
+}
+template<bool CHECKED>
+BasicByteReader<CHECKED> &BasicByteReader<CHECKED>::op_float(float &v)
+{
+	if (has_bytes_to_read(5) == false) {
+		[[unlikely]];
+		errors |= ERROR_BUFFER_TOO_SMALL;
+		return *this;
+	}
+	if (ptr[0] != BEG_FLOAT) {
+		[[unlikely]];
+		errors |= ERROR_TYPE_MISMATCH;
+		return *this;
+	}
+	_read_float(ptr + 1, v);
+	ptr += 5;
+	return *this;
+}
+template<bool CHECKED>
+BasicByteReader<CHECKED> &BasicByteReader<CHECKED>::op_double(double &v)
+{
+	if (has_bytes_to_read(9) == false) {
+		[[unlikely]];
+		errors |= ERROR_BUFFER_TOO_SMALL;
+		return *this;
+	}
+	if (ptr[0] != BEG_DOUBLE) {
+		[[unlikely]];
+		errors |= ERROR_TYPE_MISMATCH;
+		return *this;
+	}
+	_read_double(ptr + 1, v);
+	ptr += 9;
+	return *this;
+}
+template<bool CHECKED>
+inline BasicByteReader<CHECKED> &BasicByteReader<CHECKED>::op(float &v)
+{
+	if (has_bytes_to_read(1) == false) {
+		[[unlikely]];
+		errors |= ERROR_BUFFER_TOO_SMALL;
+		return *this;
+	}
+	const uint8_t header = *ptr;
+	++ptr;
+	double d = v;
+	switch (header) {
+	case BEG_HALF:
+		if (has_bytes_to_read(2) == false) {
+			[[unlikely]];
+			errors |= ERROR_BUFFER_TOO_SMALL;
+			return *this;
+		}
+		_read_half(ptr, v);
+		ptr += 2;
+		break;
+	case BEG_BFLOAT:
+		if (has_bytes_to_read(2) == false) {
+			[[unlikely]];
+			errors |= ERROR_BUFFER_TOO_SMALL;
+			return *this;
+		}
+		_read_bfloat(ptr, v);
+		ptr += 2;
+		break;
+	case BEG_FLOAT:
+		if (has_bytes_to_read(4) == false) {
+			[[unlikely]];
+			errors |= ERROR_BUFFER_TOO_SMALL;
+			return *this;
+		}
+		_read_float(ptr, v);
+		ptr += 4;
+		break;
+	case BEG_DOUBLE:
+		if (has_bytes_to_read(8) == false) {
+			[[unlikely]];
+			errors |= ERROR_BUFFER_TOO_SMALL;
+			return *this;
+		}
+		_read_double(ptr, d);
+		v = d;
+		ptr += 8;
+		break;
+	default:
+		[[unlikely]];
+		errors |= ERROR_TYPE_MISMATCH;
+		return *this;
+	}
+	return *this;
+}
+template<bool CHECKED>
+inline BasicByteReader<CHECKED> &BasicByteReader<CHECKED>::op(double &v)
+{
+	if (has_bytes_to_read(1) == false) {
+		[[unlikely]];
+		errors |= ERROR_BUFFER_TOO_SMALL;
+		return *this;
+	}
+	const uint8_t header = *ptr;
+	++ptr;
+	float f = v;
+	switch (header) {
+	case BEG_HALF:
+		if (has_bytes_to_read(2) == false) {
+			[[unlikely]];
+			errors |= ERROR_BUFFER_TOO_SMALL;
+			return *this;
+		}
+		_read_half(ptr, f);
+		v = f;
+		ptr += 2;
+		break;
+	case BEG_BFLOAT:
+		if (has_bytes_to_read(2) == false) {
+			[[unlikely]];
+			errors |= ERROR_BUFFER_TOO_SMALL;
+			return *this;
+		}
+		_read_bfloat(ptr, f);
+		v = f;
+		ptr += 2;
+		break;
+	case BEG_FLOAT:
+		if (has_bytes_to_read(4) == false) {
+			[[unlikely]];
+			errors |= ERROR_BUFFER_TOO_SMALL;
+			return *this;
+		}
+		_read_float(ptr, f);
+		v = f;
+		ptr += 4;
+		break;
+	case BEG_DOUBLE:
+		if (has_bytes_to_read(8) == false) {
+			[[unlikely]];
+			errors |= ERROR_BUFFER_TOO_SMALL;
+			return *this;
+		}
+		_read_double(ptr, v);
+		ptr += 8;
+		break;
+	default:
+		[[unlikely]];
+		errors |= ERROR_TYPE_MISMATCH;
+		return *this;
+	}
+	return *this;
+}
+template<bool CHECKED>
+inline void BasicByteReader<CHECKED>::_read_half(const uint8_t *ptr, float &v)
+{
+	v = HalfToFloat(ReadBytesInNetworkOrder(ptr, 2));
+}
+template<bool CHECKED>
+inline void BasicByteReader<CHECKED>::_read_bfloat(const uint8_t *ptr, float &v)
+{
+	const uint16_t bfloat = ReadBytesInNetworkOrder(ptr, 2);
+	uint32_t ffloat = ((uint32_t)bfloat) << 16;
+	v = std::bit_cast<float>(ffloat);
+}
+template<bool CHECKED>
+inline void BasicByteReader<CHECKED>::_read_float(const uint8_t *ptr, float &v)
+{
+	const uint32_t vv = ReadBytesInNetworkOrder(ptr, 4);
+	v = std::bit_cast<float>(vv);
+}
+template<bool CHECKED>
+inline void BasicByteReader<CHECKED>::_read_double(const uint8_t *ptr, double &v)
+{
+	const uint64_t vv = ReadBytesInNetworkOrder(ptr, 8);
+	v = std::bit_cast<double>(vv);
+}
+
+// map
+template<bool CHECKED>
+BasicByteReader<CHECKED> &
+BasicByteReader<CHECKED>::op_map_header(uint32_t &elements)
+{
+	if (has_bytes_to_read(1) == false) {
+		[[unlikely]];
+		errors |= ERROR_BUFFER_TOO_SMALL;
+		return *this;
+	}
+	const uint8_t header = *ptr;
+	++ptr;
+	if (header == BEG_MAP_SIZED) {
+		[[likely]];
+		uint64_t size;
+		op_untyped_var_uint(size);
+		if (errors != 0) {
+			[[unlikely]];
+			elements = 0;
+			return *this;
+		}
+		if (size > MAX_ARRAY_ELEMENTS - 1) {
+			[[unlikely]];
+			set_error(ERROR_ARRAY_TOO_BIG);
+			elements = 0;
+			return *this;
+		}
+		elements = size+1;
+		if (has_bytes_to_read(elements) == false) {
+			set_error(ERROR_ARRAY_TOO_BIG);
+			set_error(ERROR_TYPE_MISMATCH);
+			set_error(ERROR_BUFFER_TOO_SMALL);
+		}
+	} else if (header == BEG_MAP_EMPTY) {
+		elements = 0;
+	} else if (header == BEG_SORTED_MAP) {
+		IndexedArray map;
+		_op_offset_table(map, 2);
+		elements = map.elements;
+	} else {
+		[[unlikely]];
+		elements = 0;
+		errors |= ERROR_TYPE_MISMATCH;
+	}
+	return *this;
+
+}
+
+template<bool CHECKED>
+BasicByteReader<CHECKED> &
+BasicByteReader<CHECKED>::op_array_header(uint32_t &elements)
+{
+	if (has_bytes_to_read(1) == false) {
+		[[unlikely]];
+		errors |= ERROR_BUFFER_TOO_SMALL;
+		return *this;
+	}
+	const uint8_t header = *ptr;
+	++ptr;
+	
+	if (header < BEG_ARRAY_IMMEDIATE_SIZED) {
+		[[unlikely]];
+		errors |= ERROR_TYPE_MISMATCH;
+		elements = 0;
+	} else if (header <= END_ARRAY_IMMEDIATE_SIZED) {
+		[[likely]];
+		elements = header - BEG_ARRAY_IMMEDIATE_SIZED;
+	} else if (header == BEG_ARRAY_VAR_SIZED) {
+		uint64_t size = 0;
+		op_untyped_var_uint(size);
+		if (errors != 0) {
+			[[unlikely]];
+			elements = 0;
+			return *this;
+		}
+		elements = size + IMMEDIATE_ARRAY_MAX_SIZE + 1;
+		if (size > MAX_ARRAY_ELEMENTS - (IMMEDIATE_ARRAY_MAX_SIZE + 1)) {
+			[[unlikely]];
+			set_error(ERROR_ARRAY_TOO_BIG);
+			elements = 0;
+			return *this;
+		}
+		assert(elements == size + IMMEDIATE_ARRAY_MAX_SIZE + 1);
+		if (has_bytes_to_read(elements) == false) {
+			set_error(ERROR_ARRAY_TOO_BIG);
+			set_error(ERROR_TYPE_MISMATCH);
+			set_error(ERROR_BUFFER_TOO_SMALL);
+		}
+	} else if (header == BEG_INDEXED_ARRAY) {
+		IndexedArray array;
+		_op_offset_table(array, 1);
+		elements = array.elements;
+	} else {
+		[[unlikely]];
+		errors |= ERROR_TYPE_MISMATCH;
+		elements = 0;
+	}
+	return *this;
+}
+
+template<bool CHECKED>
+uint32_t BasicByteReader<CHECKED>::array_element_count() const
+{
+	BasicByteReader reader = *this;
+	uint32_t elements = 0;
+	reader.op_array_header(elements);
+	return reader.errors == errors ? elements : 0;
+}
+
+template<bool CHECKED>
+BasicByteReader<CHECKED> &
+BasicByteReader<CHECKED>::op_indexed_array_header(IndexedArray &array)
+{
+	array = {};
+	if (has_bytes_to_read(1) == false) {
+		[[unlikely]];
+		errors |= ERROR_BUFFER_TOO_SMALL;
+		return *this;
+	}
+	if (*ptr != BEG_INDEXED_ARRAY) {
+		op_array_header(array.elements);
+		array.table = array.data = get_offset();
+		return *this;
+	}
+	++ptr;
+	return _op_offset_table(array, 1);
+}
+
+template<bool CHECKED>
+BasicByteReader<CHECKED> &
+BasicByteReader<CHECKED>::_op_offset_table(IndexedArray &array,
+										   uint32_t valuesPerElement)
+{
+	array = {};
+	uint64_t size = 0;
+	op_untyped_var_uint(size);
+	if (errors != 0) {
+		[[unlikely]];
+		return *this;
+	}
+	if (size > MAX_ARRAY_ELEMENTS) {
+		[[unlikely]];
+		set_error(ERROR_ARRAY_TOO_BIG);
+		return *this;
+	}
+	if (has_bytes_to_read(1) == false) {
+		[[unlikely]];
+		set_error(ERROR_BUFFER_TOO_SMALL);
+		return *this;
+	}
+	const uint8_t width = *ptr;
+	if (is_valid_indexed_array_width(width) == false) {
+		[[unlikely]];
+		set_error(ERROR_TYPE_MISMATCH);
+		return *this;
+	}
+	++ptr;
+	// table and at least 1 byte per value
+	if constexpr (CHECKED) {
+		if (size * (width + valuesPerElement) > get_remaining_bytes()) {
+			[[unlikely]];
+			set_error(ERROR_BUFFER_TOO_SMALL);
+			return *this;
+		}
+	}
+	array.elements = size;
+	array.width = width;
+	array.table = get_offset();
+	ptr += size * width;
+	array.data = get_offset();
+	return *this;
+}
+
+template<bool CHECKED>
+BasicByteReader<CHECKED> &
+BasicByteReader<CHECKED>::seek_array_element(const IndexedArray &array,
+											 uint32_t i)
+{
+	if (errors != 0) {
+		[[unlikely]];
+		return *this;
+	}
+	if (i > array.elements) {
+		[[unlikely]];
+		set_error(ERROR_TYPE_MISMATCH);
+		return *this;
+	}
+	if (array.width == 0) {
+		ptr = _buffer + array.data;
+		return skip_values(i);
+	}
+	// entry i - 1 is end of previous element
+	uint32_t offset = 0;
+	if (i != 0) {
+		offset = ReadBytesInNetworkOrder(
+			_buffer + array.table + (i - 1) * array.width, array.width);
+	}
+	if constexpr (CHECKED) {
+		if (offset > total_size - array.data) {
+			[[unlikely]];
+			set_error(ERROR_BUFFER_TOO_SMALL);
+			return *this;
+		}
+	}
+	ptr = _buffer + array.data + offset;
+	return *this;
+}
+
+template<bool CHECKED>
+BasicByteReader<CHECKED> &
+BasicByteReader<CHECKED>::op_packed_array_header(PackedArrayType &type,
+												 uint32_t &elements)
+{
+	elements = 0;
+	if (has_bytes_to_read(2) == false) {
+		[[unlikely]];
+		errors |= ERROR_BUFFER_TOO_SMALL;
+		return *this;
+	}
+	const uint8_t t = ptr[1] & ~PACKED_ARRAY_ALIGNED;
+	if (ptr[0] != BEG_PACKED_ARRAY || is_valid_packed_array_type(t) == false) {
+		[[unlikely]];
+		errors |= ERROR_TYPE_MISMATCH;
+		return *this;
+	}
+	const bool aligned = ptr[1] & PACKED_ARRAY_ALIGNED;
+	type = (PackedArrayType)t;
+	ptr += 2;
+	uint64_t size = 0;
+	op_untyped_var_uint(size);
+	if (errors != 0) {
+		[[unlikely]];
+		return *this;
+	}
+	if (size > MAX_ARRAY_ELEMENTS) {
+		[[unlikely]];
+		set_error(ERROR_ARRAY_TOO_BIG);
+		return *this;
+	}
+	if (aligned) {
+		if (has_bytes_to_read(1) == false ||
+			has_bytes_to_read(1 + *ptr) == false) {
+			[[unlikely]];
+			set_error(ERROR_BUFFER_TOO_SMALL);
+			return *this;
+		}
+		if (*ptr > PACKED_ARRAY_MAX_PADDING) {
+			[[unlikely]];
+			set_error(ERROR_TYPE_MISMATCH);
+			return *this;
+		}
+		ptr += 1 + *ptr;
+	}
+	if (CHECKED &&
+		size * packed_array_element_size(type) > (uint64_t)(end - ptr)) {
+		[[unlikely]];
+		set_error(ERROR_BUFFER_TOO_SMALL);
+		return *this;
+	}
+	elements = size;
+	return *this;
+}
+template<bool CHECKED>
+BasicByteReader<CHECKED> &
+BasicByteReader<CHECKED>::op_packed_array(PackedArrayType type, void *data,
+										  uint32_t elements)
+{
+	PackedArrayType t;
+	uint32_t size = 0;
+	op_packed_array_header(t, size);
+	if (errors != 0) {
+		[[unlikely]];
+		return *this;
+	}
+	if (t != type || size != elements) {
+		[[unlikely]];
+		set_error(ERROR_TYPE_MISMATCH);
+		return *this;
+	}
+	return _read_packed_array_data(data, elements,
+								   packed_array_element_size(type));
+}
+template<bool CHECKED>
+BasicByteReader<CHECKED> &
+BasicByteReader<CHECKED>::op_half_array(float *data, uint32_t elements)
+{
+	PackedArrayType type;
+	uint32_t size = 0;
+	op_packed_array_header(type, size);
+	if (errors != 0) {
+		[[unlikely]];
+		return *this;
+	}
+	if (type != PACKED_HALF || size != elements) {
+		[[unlikely]];
+		set_error(ERROR_TYPE_MISMATCH);
+		return *this;
+	}
+	bitscpp::impl::half_array_to_float(data, ptr, elements);
+	ptr += (size_t)elements * 2;
+	return *this;
+}
+template<bool CHECKED>
+BasicByteReader<CHECKED> &
+BasicByteReader<CHECKED>::op_half_array(std::vector<float> &data)
+{
+	PackedArrayType type;
+	uint32_t elements = 0;
+	op_packed_array_header(type, elements);
+	if (errors != 0) {
+		[[unlikely]];
+		return *this;
+	}
+	if (type != PACKED_HALF) {
+		[[unlikely]];
+		set_error(ERROR_TYPE_MISMATCH);
+		return *this;
+	}
+	data.resize(elements);
+	bitscpp::impl::half_array_to_float(data.data(), ptr, elements);
+	ptr += (size_t)elements * 2;
+	return *this;
+}
+template<bool CHECKED>
+BasicByteReader<CHECKED> &
+BasicByteReader<CHECKED>::_read_packed_array_data(void *data, uint32_t elements,
+												  uint32_t elementSize)
+{
+	const size_t bytes = (size_t)elements * elementSize;
+	assert(bytes <= (size_t)(end - ptr));
+	if (bytes) {
+		CopyElementsInNetworkOrder((uint8_t *)data, ptr, elements, elementSize);
+		ptr += bytes;
+	}
+	return *this;
+}
+
+template<bool CHECKED>
+BasicByteReader<CHECKED> &
+BasicByteReader<CHECKED>::op_bit_array_header(uint32_t &elements)
+{
+	elements = 0;
+	if (has_bytes_to_read(1) == false) {
+		[[unlikely]];
+		errors |= ERROR_BUFFER_TOO_SMALL;
+		return *this;
+	}
+	if (*ptr != BEG_BIT_ARRAY) {
+		[[unlikely]];
+		errors |= ERROR_TYPE_MISMATCH;
+		return *this;
+	}
+	++ptr;
+	uint64_t size = 0;
+	op_untyped_var_uint(size);
+	if (errors != 0) {
+		[[unlikely]];
+		return *this;
+	}
+	if (size > MAX_ARRAY_ELEMENTS) {
+		[[unlikely]];
+		set_error(ERROR_ARRAY_TOO_BIG);
+		return *this;
+	}
+	if (has_bytes_to_read(impl::bit_array_bytes(size)) == false) {
+		[[unlikely]];
+		set_error(ERROR_BUFFER_TOO_SMALL);
+		return *this;
+	}
+	elements = size;
+	return *this;
+}
+template<bool CHECKED>
+BasicByteReader<CHECKED> &
+BasicByteReader<CHECKED>::op_bit_array(const uint8_t *&bits, uint32_t &elements)
+{
+	bits = nullptr;
+	op_bit_array_header(elements);
+	if (errors != 0) {
+		[[unlikely]];
+		return *this;
+	}
+	bits = ptr;
+	ptr += impl::bit_array_bytes(elements);
+	return *this;
+}
+template<bool CHECKED>
+BasicByteReader<CHECKED> &
+BasicByteReader<CHECKED>::op_bit_array(bool *data, uint32_t elements)
+{
+	const uint8_t *bits = nullptr;
+	uint32_t size = 0;
+	op_bit_array(bits, size);
+	if (errors != 0) {
+		[[unlikely]];
+		return *this;
+	}
+	if (size != elements) {
+		[[unlikely]];
+		set_error(ERROR_TYPE_MISMATCH);
+		return *this;
+	}
+	impl::unpack_bits(data, bits, elements);
+	return *this;
+}
+template<bool CHECKED>
+BasicByteReader<CHECKED> &
+BasicByteReader<CHECKED>::op_bit_array(std::vector<bool> &data)
+{
+	const uint8_t *bits = nullptr;
+	uint32_t elements = 0;
+	op_bit_array(bits, elements);
+	if (errors != 0) {
+		[[unlikely]];
+		data.clear();
+		return *this;
+	}
+	data.resize(elements);
+	for (uint32_t i = 0; i < elements; ++i) {
+		data[i] = (bits[i >> 3] >> (i & 7)) & 1;
+	}
+	return *this;
+}
+template<bool CHECKED>
+BasicByteReader<CHECKED> &BasicByteReader<CHECKED>::op(std::vector<bool> &data)
+{
+	if (is_next_bit_array()) {
+		return op_bit_array(data);
+	}
+	uint32_t elements = 0;
+	op_array_header(elements);
+	if (errors != 0) {
+		[[unlikely]];
+		data.clear();
+		return *this;
+	}
+	data.resize(elements);
+	for (uint32_t i = 0; i < elements && errors == 0; ++i) {
+		bool v = false;
+		op(v);
+		data[i] = v;
+	}
+	return *this;
+}
+
+template<bool CHECKED>
+inline BasicByteReader<CHECKED> &
+BasicByteReader<CHECKED>::op_untyped_var_uint(uint64_t &v)
+{
+	if (has_bytes_to_read(1) == false) {
+		[[unlikely]];
+		errors |= ERROR_BUFFER_TOO_SMALL;
+		return *this;
+	}
+	const uint8_t header = *ptr;
+	++ptr;
+	// Length is the count of leading ones, payload follows in network order,
+	// so there are no 7-bit groups for pext to gather. Branchless decode with
+	// payload always loaded was not faster: the next header position depends
+	// on this length either way, and 1-byte values lose most.
+	const int32_t bytes = std::countl_one(header);
+	if (bytes >= 1) {
+		constexpr uint8_t masks[] = {0x7F, 0x3F, 0x1F, 0x0F,
+									 0x07, 0x03, 0x01, 0x00, 0x00};
+		constexpr uint8_t shifts[] = {7, 6, 5, 4, 3, 2, 1, 0, 0};
+		if (has_bytes_to_read(bytes) == false) {
+			[[unlikely]];
+			errors |= ERROR_BUFFER_TOO_SMALL;
+			return *this;
+		}
+		v = _read_bytes(bytes) << shifts[bytes];
+		ptr += bytes;
+		v |= header & masks[bytes];
+	} else {
+		v = header;
+	}
+	return *this;
+}
+template<bool CHECKED>
+BasicByteReader<CHECKED> &
+BasicByteReader<CHECKED>::op_untyped_var_int(int64_t &v)
+{
+	uint64_t vv = 0;
+	op_untyped_var_uint(vv);
+	const uint64_t sign = vv & 1;
+	const uint64_t abs = vv >> 1;
+	vv = sign ? ~abs : abs;
+	v = vv;
+	return *this;
+}
+template<bool CHECKED>
+BasicByteReader<CHECKED> &
+BasicByteReader<CHECKED>::op_untyped_uint32(uint32_t &v)
+{
+	if (has_bytes_to_read(4)) {
+		[[likely]];
+		v = ReadBytesInNetworkOrder(ptr, 4);
+		ptr += 4;
+	} else {
+		errors |= ERROR_BUFFER_TOO_SMALL;
+	}
+	return *this;
+}
+
+template<bool CHECKED>
+BasicByteReader<CHECKED> &BasicByteReader<CHECKED>::skip(uint32_t bytes)
+{
+	if (has_bytes_to_read(bytes) == false) {
+		[[unlikely]];
+		errors |= ERROR_BUFFER_TOO_SMALL;
+		return *this;
+	}
+	ptr += bytes;
+	return *this;
+}
+template<bool CHECKED>
+inline BasicByteReader<CHECKED> &BasicByteReader<CHECKED>::skip_next_value()
+{
+	if (has_bytes_to_read(1)) {
+		[[likely]];
+		const uint32_t fixed = impl::fixedValueSizes[*ptr];
+		if (fixed != 0 && has_bytes_to_read(fixed)) {
+			ptr += fixed;
+			return *this;
+		}
+	}
+	return skip_values(1);
+}
+template<bool CHECKED>
+BasicByteReader<CHECKED> &BasicByteReader<CHECKED>::skip_values(uint32_t values)
+{
+	// leading values of size known from header do not need stack of walk
+	for (; values != 0 && has_bytes_to_read(1); --values) {
+		const uint32_t fixed = impl::fixedValueSizes[*ptr];
+		if (fixed == 0 || has_bytes_to_read(fixed) == false) {
+			break;
+		}
+		ptr += fixed;
+	}
+	const Errors error = impl::walk_values<true>(ptr, end, values);
+	if (error != ERROR_OK) {
+		[[unlikely]];
+		errors |= error;
+	}
+	return *this;
+}
+template<bool CHECKED>
+inline bool BasicByteReader<CHECKED>::is_valid() const { return errors == ERROR_OK; }
+template<bool CHECKED>
+inline Errors BasicByteReader<CHECKED>::get_errors() const { return (Errors)errors; }
+template<bool CHECKED>
+inline bool BasicByteReader<CHECKED>::has_any_more() const { return ptr != end; }
+template<bool CHECKED>
+inline uint32_t BasicByteReader<CHECKED>::get_offset() const { return ptr - _buffer; }
+template<bool CHECKED>
+const uint8_t *BasicByteReader<CHECKED>::get_buffer() const { return _buffer; }
+template<bool CHECKED>
+inline uint32_t BasicByteReader<CHECKED>::get_remaining_bytes() const { return end - ptr; }
+template<bool CHECKED>
+inline bool BasicByteReader<CHECKED>::has_bytes_to_read(uint32_t bytes) const
+{
+	if constexpr (CHECKED) {
+		return bytes <= end - ptr;
+	} else {
+		return true;
+	}
+}
+template<bool CHECKED>
+inline uint64_t BasicByteReader<CHECKED>::_read_bytes(int bytes) const
+{
+	if ((size_t)(end - ptr) + tail_padding >= 8) {
+		[[likely]];
+		// bytes past the value are masked out
+		return ReadWideBytesInNetworkOrder(ptr, bytes);
+	}
+	return ReadBytesInNetworkOrder(ptr, bytes);
+}
+
+template<bool CHECKED>
+template<typename T>
+BasicByteReader<CHECKED> &
+BasicByteReader<CHECKED>::_op_int_array_impl(T *data, uint32_t elements)
+{
+	bool overflow = false;
+	const uint8_t *p =
+		impl::decode_int_array(ptr, end, data, elements, overflow,
+							   tail_padding);
+	if (p == nullptr) {
+		[[unlikely]];
+		// find failing element
+		for (uint32_t i = 0; i < elements && errors == 0; ++i)
+			op(data[i]);
+		return *this;
+	}
+	ptr = p;
+	if (overflow) {
+		[[unlikely]];
+		set_error(ERROR_INTEGER_OVERFLOW);
+	}
+	return *this;
+}
+template<bool CHECKED>
+BasicByteReader<CHECKED> &
+BasicByteReader<CHECKED>::_op_int_array(int8_t *data, uint32_t elements)
+{
+	return _op_int_array_impl(data, elements);
+}
+template<bool CHECKED>
+BasicByteReader<CHECKED> &
+BasicByteReader<CHECKED>::_op_int_array(int16_t *data, uint32_t elements)
+{
+	return _op_int_array_impl(data, elements);
+}
+template<bool CHECKED>
+BasicByteReader<CHECKED> &
+BasicByteReader<CHECKED>::_op_int_array(int32_t *data, uint32_t elements)
+{
+	return _op_int_array_impl(data, elements);
+}
+template<bool CHECKED>
+BasicByteReader<CHECKED> &
+BasicByteReader<CHECKED>::_op_int_array(int64_t *data, uint32_t elements)
+{
+	return _op_int_array_impl(data, elements);
+}
+template<bool CHECKED>
+BasicByteReader<CHECKED> &
+BasicByteReader<CHECKED>::_op_int_array(uint8_t *data, uint32_t elements)
+{
+	return _op_int_array_impl(data, elements);
+}
+template<bool CHECKED>
+BasicByteReader<CHECKED> &
+BasicByteReader<CHECKED>::_op_int_array(uint16_t *data, uint32_t elements)
+{
+	return _op_int_array_impl(data, elements);
+}
+template<bool CHECKED>
+BasicByteReader<CHECKED> &
+BasicByteReader<CHECKED>::_op_int_array(uint32_t *data, uint32_t elements)
+{
+	return _op_int_array_impl(data, elements);
+}
+template<bool CHECKED>
+BasicByteReader<CHECKED> &
+BasicByteReader<CHECKED>::_op_int_array(uint64_t *data, uint32_t elements)
+{
+	return _op_int_array_impl(data, elements);
+}
+
+template<bool CHECKED>
+void BasicByteReader<CHECKED>::set_error(Errors error) { errors |= error; }
+
+} // namespace v2
+} // namespace bitscpp
+
+#endif
@@ -6,9 +6,8 @@
 #include <cassert>
 #include <cstring>
 
-#include "../thirdparty/half_float/HalfFloat.hpp"
-
 #include "../include/bitscpp/Endianness.hpp"
+#include "../include/bitscpp/HalfFloat.hpp"
 #include "../include/bitscpp/V2_Specification.hpp"
 
 #include "../include/bitscpp/ByteWriter_v2.hpp"
@@ -68,12 +67,26 @@ ByteWriter<BT> &ByteWriter<BT>::op(char *str, uint32_t size)
 template<typename BT>
 ByteWriter<BT> &ByteWriter<BT>::op_byte_array(const uint8_t *data, uint32_t bytes)
 {
-	_reserve_expand(bytes + 6);
+	if (CURSOR == false || bytes < CURSOR_DIRECT_WRITE_THRESHOLD) {
+		_reserve_expand(bytes + 6);
+	}
 	op_sized_byte_array_header(bytes);
 	_append(data, bytes);
 	return *this;
 }
 template<typename BT>
+ByteWriter<BT> &ByteWriter<BT>::op_byte_array_ref(const uint8_t *data, uint32_t bytes)
+{
+	if constexpr (requires { _buffer->write_reference(data, bytes); }) {
+		op_sized_byte_array_header(bytes);
+		Commit();
+		_buffer->write_reference(data, bytes);
+		return *this;
+	} else {
+		return op_byte_array(data, bytes);
+	}
+}
+template<typename BT>
 ByteWriter<BT> &ByteWriter<BT>::op_byte_array(const std::vector<uint8_t> &data)
 {
 	return op_byte_array(data.data(), data.size());
@@ -119,6 +132,28 @@ ByteWriter<BT> &ByteWriter<BT>::op_end_object()
 	return *this;
 }
 
+template<typename BT>
+ByteWriter<BT> &ByteWriter<BT>::op_begin_sized_object(uint32_t &offset)
+{
+	uint8_t *p = _expand(1 + SIZED_OBJECT_LENGTH_BYTES);
+	p[0] = BEG_SIZED_OBJECT;
+	offset = GetSize();
+	return *this;
+}
+template<typename BT>
+ByteWriter<BT> &ByteWriter<BT>::op_end_sized_object(uint32_t offset)
+{
+	_append_byte(END_OBJECT);
+	if (errors != 0) {
+		[[unlikely]];
+		return *this;
+	}
+	const uint32_t length = GetSize() - offset;
+	uint8_t *p = _data_at(offset - SIZED_OBJECT_LENGTH_BYTES);
+	WriteBytesInNetworkOrder(p, length, SIZED_OBJECT_LENGTH_BYTES);
+	return *this;
+}
+
 template<typename BT>
 ByteWriter<BT> &ByteWriter<BT>::op(uint8_t v) { return op_uint(v); }
 template<typename BT>
@@ -143,6 +178,11 @@ ByteWriter<BT> &ByteWriter<BT>::op_uint(uint64_t v) { return op_int(v); }
 template<typename BT>
 ByteWriter<BT> &ByteWriter<BT>::op_int(int64_t v)
 {
+	if (_has_wide_window()) {
+		[[likely]];
+		_ptr = impl::encode_int(_ptr, v);
+		return *this;
+	}
 	if (v >= IMMEDIATE_INTEGER_VALUE_MIN && v <= IMMEDIATE_INTEGER_VALUE_MAX) {
 		[[likely]];
 		v -= IMMEDIATE_INTEGER_VALUE_MIN;
@@ -184,7 +224,7 @@ ByteWriter<BT> &ByteWriter<BT>::op_half(float value)
 {
 	uint8_t *p = _expand(3);
 	*p = BEG_HALF;
-	WriteBytesInNetworkOrder(p + 1, Float32ToFloat16(value), 2);
+	WriteUintInNetworkOrder(p + 1, FloatToHalf(value));
 	return *this;
 }
 template<typename BT>
@@ -212,7 +252,7 @@ ByteWriter<BT> &ByteWriter<BT>::op_bfloat(float value)
 	} else {
 		[[likely]];
 		const uint16_t bfloat = bv32 >> 16;
-		WriteBytesInNetworkOrder(p + 1, bfloat, 2);
+		WriteUintInNetworkOrder(p + 1, bfloat);
 		return *this;
 	}
 }
@@ -226,7 +266,7 @@ ByteWriter<BT> &ByteWriter<BT>::op_float(float value)
 	const uint32_t bv32 = std::bit_cast<uint32_t>(value);
 	uint8_t *p = _expand(5);
 	p[0] = BEG_FLOAT;
-	WriteBytesInNetworkOrder(p + 1, bv32, 4);
+	WriteUintInNetworkOrder(p + 1, bv32);
 	return *this;
 }
 template<typename BT>
@@ -235,7 +275,7 @@ ByteWriter<BT> &ByteWriter<BT>::op_double(double value)
 	const uint64_t bv64 = std::bit_cast<uint64_t>(value);
 	uint8_t *p = _expand(9);
 	p[0] = BEG_DOUBLE;
-	WriteBytesInNetworkOrder(p + 1, bv64, 8);
+	WriteUintInNetworkOrder(p + 1, bv64);
 	return *this;
 }
 
@@ -252,6 +292,25 @@ ByteWriter<BT> &ByteWriter<BT>::op_map_header(uint32_t elements)
 	return *this;
 }
 
+template<typename BT>
+ByteWriter<BT> &ByteWriter<BT>::op_begin_sorted_map(uint32_t entries,
+													uint32_t &offset)
+{
+	return _op_begin_offset_table(BEG_SORTED_MAP, entries, offset);
+}
+template<typename BT>
+ByteWriter<BT> &ByteWriter<BT>::op_end_sorted_map_entry(uint32_t offset,
+														uint32_t i)
+{
+	return op_end_indexed_array_element(offset, i);
+}
+template<typename BT>
+ByteWriter<BT> &ByteWriter<BT>::op_end_sorted_map(uint32_t offset,
+												  uint32_t entries)
+{
+	return op_end_indexed_array(offset, entries);
+}
+
 template<typename BT>
 ByteWriter<BT> &ByteWriter<BT>::op_array_header(uint32_t elements)
 {
@@ -266,6 +325,224 @@ ByteWriter<BT> &ByteWriter<BT>::op_array_header(uint32_t elements)
 	return *this;
 }
 
+template<typename BT>
+ByteWriter<BT> &ByteWriter<BT>::op_begin_indexed_array(uint32_t elements,
+													   uint32_t &offset)
+{
+	return _op_begin_offset_table(BEG_INDEXED_ARRAY, elements, offset);
+}
+template<typename BT>
+ByteWriter<BT> &ByteWriter<BT>::op_end_indexed_array_element(uint32_t offset,
+															 uint32_t i)
+{
+	if (errors != 0) {
+		[[unlikely]];
+		return *this;
+	}
+	WriteBytesInNetworkOrder(_data_at(offset + i * 4), GetSize(), 4);
+	return *this;
+}
+template<typename BT>
+ByteWriter<BT> &ByteWriter<BT>::op_end_indexed_array(uint32_t offset,
+													 uint32_t elements)
+{
+	if (errors != 0) {
+		[[unlikely]];
+		return *this;
+	}
+	const uint32_t data = offset + elements * 4;
+	const uint32_t total = GetSize() - data;
+	const uint32_t width = total <= 0xFF ? 1 : total <= 0xFFFF ? 2 : 4;
+	uint8_t *table = _data_at(offset);
+	table[-1] = width;
+	// entry i is written over bytes of entries up to i, which were already
+	// read
+	for (uint32_t i = 0; i < elements; ++i) {
+		const uint32_t end = ReadBytesInNetworkOrder(table + i * 4, 4) - data;
+		WriteBytesInNetworkOrder(table + i * width, end, width);
+	}
+	if (width != 4) {
+		memmove(table + elements * width, table + elements * 4, total);
+		_shrink((4 - width) * (size_t)elements);
+	}
+	return *this;
+}
+
+template<typename BT>
+ByteWriter<BT> &ByteWriter<BT>::_op_begin_offset_table(uint8_t header,
+													   uint32_t elements,
+													   uint32_t &offset)
+{
+	offset = 0;
+	if (elements > MAX_ARRAY_ELEMENTS) {
+		[[unlikely]];
+		set_error(ERROR_ARRAY_TOO_BIG);
+		return *this;
+	}
+	_reserve_expand(11 + 4 * (size_t)elements);
+	_append_byte(header);
+	op_untyped_var_uint(elements);
+	_append_byte(4);
+	offset = GetSize();
+	// until end of array or map entries are 4 byte offsets in output
+	if (elements != 0) {
+		_try_expand(4 * (size_t)elements);
+	}
+	return *this;
+}
+
+template<typename BT>
+ByteWriter<BT> &ByteWriter<BT>::op_packed_array_header(PackedArrayType type,
+													   uint32_t elements,
+													   bool aligned)
+{
+	assert(is_valid_packed_array_type(type));
+	if (elements > MAX_ARRAY_ELEMENTS) {
+		[[unlikely]];
+		set_error(ERROR_ARRAY_TOO_BIG);
+		return *this;
+	}
+	_reserve_expand(2 + 9 + PACKED_ARRAY_MAX_PADDING + 1);
+	uint8_t *p = _expand(2);
+	p[0] = BEG_PACKED_ARRAY;
+	p[1] = aligned ? type | PACKED_ARRAY_ALIGNED : type;
+	op_untyped_var_uint(elements);
+	if (aligned) {
+		const uint32_t padding = packed_array_padding(type, GetSize() + 1);
+		p = _expand(1 + padding);
+		p[0] = padding;
+		memset(p + 1, 0, padding);
+	}
+	return *this;
+}
+template<typename BT>
+ByteWriter<BT> &ByteWriter<BT>::op_packed_array(PackedArrayType type,
+												const void *data,
+												uint32_t elements)
+{
+	return _op_packed_array(type, data, elements, false);
+}
+template<typename BT>
+ByteWriter<BT> &ByteWriter<BT>::op_aligned_packed_array(PackedArrayType type,
+														const void *data,
+														uint32_t elements)
+{
+	return _op_packed_array(type, data, elements, true);
+}
+template<typename BT>
+ByteWriter<BT> &ByteWriter<BT>::_op_packed_array(PackedArrayType type,
+												 const void *data,
+												 uint32_t elements,
+												 bool aligned)
+{
+	const uint32_t elementSize = packed_array_element_size(type);
+	const size_t bytes = (size_t)elements * elementSize;
+	if (elements > MAX_ARRAY_ELEMENTS || bytes > MAX_BUFFER_SIZE) {
+		[[unlikely]];
+		set_error(ERROR_ARRAY_TOO_BIG);
+		return *this;
+	}
+	if (CURSOR == false || bytes < CURSOR_DIRECT_WRITE_THRESHOLD) {
+		_reserve_expand(bytes + 2 + 9 + PACKED_ARRAY_MAX_PADDING + 1);
+	}
+	op_packed_array_header(type, elements, aligned);
+	if (bytes == 0) {
+		return *this;
+	}
+	if constexpr (Endian::little) {
+		_append((const uint8_t *)data, bytes);
+	} else {
+		uint8_t *p = _try_expand(bytes);
+		if (p != nullptr) {
+			[[likely]];
+			CopyElementsInNetworkOrder(p, (const uint8_t *)data, elements,
+									   elementSize);
+		}
+	}
+	return *this;
+}
+template<typename BT>
+ByteWriter<BT> &ByteWriter<BT>::op_half_array(const float *data,
+											  uint32_t elements)
+{
+	const size_t bytes = (size_t)elements * 2;
+	if (elements > MAX_ARRAY_ELEMENTS || bytes > MAX_BUFFER_SIZE) {
+		[[unlikely]];
+		set_error(ERROR_ARRAY_TOO_BIG);
+		return *this;
+	}
+	if (CURSOR == false || bytes < CURSOR_DIRECT_WRITE_THRESHOLD) {
+		_reserve_expand(bytes + 2 + 9);
+	}
+	op_packed_array_header(PACKED_HALF, elements);
+	// in chunks, so that cursor BT does not need window for whole array
+	constexpr uint32_t CHUNK = CURSOR_DIRECT_WRITE_THRESHOLD / 2;
+	for (uint32_t i = 0; i < elements; i += CHUNK) {
+		const uint32_t count = std::min(elements - i, CHUNK);
+		uint8_t *p = _try_expand((size_t)count * 2);
+		if (p == nullptr) {
+			[[unlikely]];
+			return *this;
+		}
+		bitscpp::impl::float_to_half_array(p, data + i, count);
+	}
+	return *this;
+}
+template<typename BT>
+ByteWriter<BT> &ByteWriter<BT>::op_half_array(const std::vector<float> &data)
+{
+	if (data.size() > MAX_ARRAY_ELEMENTS) {
+		[[unlikely]];
+		set_error(ERROR_ARRAY_TOO_BIG);
+		return *this;
+	}
+	return op_half_array(data.data(), data.size());
+}
+
+template<typename BT>
+ByteWriter<BT> &ByteWriter<BT>::op_bit_array_header(uint32_t elements)
+{
+	if (elements > MAX_ARRAY_ELEMENTS) {
+		[[unlikely]];
+		set_error(ERROR_ARRAY_TOO_BIG);
+		return *this;
+	}
+	_reserve_expand(10);
+	_append_byte(BEG_BIT_ARRAY);
+	op_untyped_var_uint(elements);
+	return *this;
+}
+template<typename BT>
+ByteWriter<BT> &ByteWriter<BT>::op_bit_array(const bool *data,
+											 uint32_t elements)
+{
+	return _op_bit_array(elements, [&](uint8_t *dst, uint32_t first,
+									   uint32_t count) {
+		impl::pack_bits(dst, data + first, count);
+	});
+}
+template<typename BT>
+ByteWriter<BT> &ByteWriter<BT>::op_bit_array(const std::vector<bool> &data)
+{
+	if (data.size() > MAX_ARRAY_ELEMENTS) {
+		[[unlikely]];
+		set_error(ERROR_ARRAY_TOO_BIG);
+		return *this;
+	}
+	return _op_bit_array(data.size(), [&](uint8_t *dst, uint32_t first,
+										  uint32_t count) {
+		memset(dst, 0, impl::bit_array_bytes(count));
+		for (uint32_t i = 0; i < count; ++i) {
+			dst[i >> 3] |= (uint8_t)data[first + i] << (i & 7);
+		}
+	});
+}
+template<typename BT>
+ByteWriter<BT> &ByteWriter<BT>::op(const std::vector<bool> &data)
+{
+	return op_bit_array(data);
+}
+
 template<typename BT>
 ByteWriter<BT> &ByteWriter<BT>::op_untyped_var_uint(uint64_t value)
 {
@@ -274,33 +551,20 @@ ByteWriter<BT> &ByteWriter<BT>::op_untyped_var_uint(uint64_t value)
 		uint8_t byte = (uint8_t)value;
 		assert(byte == value);
 		_append_byte(byte);
+	} else if (_has_wide_window()) {
+		_ptr = impl::encode_var_uint(_ptr, value);
 	} else {
 		const uint32_t bits = std::bit_width(value);
-		constexpr uint8_t _bytes[65] = {
-			1,1,1,1,1,1,1,
-			2,2,2,2,2,2,2,
-			3,3,3,3,3,3,3,
-			4,4,4,4,4,4,4,
-			5,5,5,5,5,5,5,
-			6,6,6,6,6,6,6,
-			7,7,7,7,7,7,7,
-			8,8,8,8,8,8,8,8,
-			9,9,9,9,9,9,9,9};
-		const uint32_t bytes = _bytes[bits];
-		assert(bytes == (bits + 6) / 7);
-
-		constexpr uint8_t masks[9] = {0x7F, 0x3F, 0x1F, 0x0F,
-									 0x07, 0x03, 0x01, 0x00, 0x00};
-		constexpr uint8_t ones[9] = {0x00, 0x80, 0xC0, 0xE0,
-									0xF0, 0xF8, 0xFC, 0xFE, 0xFF};
-		constexpr uint8_t shifts[9] = {7, 6, 5, 4, 3, 2, 1, 0, 0};
+		const uint32_t bytes = impl::VAR_UINT_BYTES[bits];
+		assert(bytes == (bits > 56 ? 9 : (bits + 6) / 7));
 
 		uint8_t *p = _expand(bytes);
 
-		const uint8_t header = (masks[bytes-1] & value) | ones[bytes-1];
+		const uint8_t header = (impl::VAR_UINT_MASKS[bytes-1] & value) |
+							   impl::VAR_UINT_ONES[bytes-1];
 		p[0] = header;
 
-		value >>= shifts[bytes-1];
+		value >>= impl::VAR_UINT_SHIFTS[bytes-1];
 		WriteBytesInNetworkOrder(p + 1, value, bytes - 1);
 	}
 	return *this;
@@ -318,30 +582,191 @@ template<typename BT>
 ByteWriter<BT> &ByteWriter<BT>::op_untyped_uint32(uint32_t v)
 {
 	uint8_t *ptr = _expand(4);
-	WriteBytesInNetworkOrder(ptr, v, 4);
+	WriteUintInNetworkOrder(ptr, v);
 	return *this;
 }
 
 template<typename BT>
-void ByteWriter<BT>::_append_byte(const uint8_t byte) { _buffer->push_back(byte); }
+void ByteWriter<BT>::Commit()
+{
+	if constexpr (CURSOR) {
+		if (_ptr != nullptr) {
+			_buffer->commit_window(_ptr);
+			_ptr = _end = _window = nullptr;
+		}
+	}
+}
+
+template<typename BT>
+void ByteWriter<BT>::_append_byte(const uint8_t byte)
+{
+	if constexpr (CURSOR) {
+		*_expand(1) = byte;
+	} else {
+		_buffer->push_back(byte);
+	}
+}
 template<typename BT>
 void ByteWriter<BT>::_append(const uint8_t *data, uint32_t bytes)
 {
-	_buffer->write(data, bytes);
+	if constexpr (UNCHECKED) {
+		assert((size_t)(_end - _ptr) >= bytes);
+		memcpy(_ptr, data, bytes);
+		_ptr += bytes;
+	} else if constexpr (CURSOR) {
+		if ((size_t)(_end - _ptr) < bytes && bytes >= CURSOR_DIRECT_WRITE_THRESHOLD) {
+			Commit();
+			const size_t oldSize = _buffer->size();
+			_buffer->write(data, bytes);
+			if (_buffer->size() != oldSize + bytes) {
+				[[unlikely]];
+				set_error(ERROR_BUFFER_TOO_SMALL);
+			}
+			return;
+		}
+		uint8_t *p = _try_expand(bytes);
+		if (p != nullptr) {
+			[[likely]];
+			memcpy(p, data, bytes);
+		}
+	} else {
+		_buffer->write(data, bytes);
+	}
+}
+template<typename BT>
+uint8_t *ByteWriter<BT>::_data_at(uint32_t offset)
+{
+	if constexpr (UNCHECKED) {
+		return _window + (offset - _windowOffset);
+	} else if constexpr (requires { _buffer->data(); }) {
+		return _buffer->data() + offset;
+	} else {
+		static_assert(sizeof(BT) == 0,
+					  "Random access to written data requires BT::data()");
+		return nullptr;
+	}
+}
+template<typename BT>
+bool ByteWriter<BT>::_has_wide_window()
+{
+	if constexpr (CURSOR) {
+		return (size_t)(_end - _ptr) >= impl::WIDE_STORE_BYTES;
+	} else {
+		return false;
+	}
 }
 template<typename BT>
 uint8_t *ByteWriter<BT>::_expand(size_t bytesToExpand)
 {
-	size_t oldSize = _buffer->size();
-	size_t newSize = oldSize + bytesToExpand;
-	_reserve(newSize);
-	_buffer->resize(newSize);
-	return _buffer->data() + oldSize;
+	if constexpr (UNCHECKED) {
+		assert((size_t)(_end - _ptr) >= bytesToExpand);
+		uint8_t *p = _ptr;
+		_ptr += bytesToExpand;
+		return p;
+	} else if constexpr (CURSOR) {
+		assert(bytesToExpand <= sizeof(_scratch));
+		if ((size_t)(_end - _ptr) < bytesToExpand) {
+			[[unlikely]];
+			if (_next_window(bytesToExpand) == false) {
+				return _scratch;
+			}
+		}
+		uint8_t *p = _ptr;
+		_ptr += bytesToExpand;
+		return p;
+	} else {
+		size_t oldSize = _buffer->size();
+		size_t newSize = oldSize + bytesToExpand;
+		_reserve(newSize);
+		_buffer->resize(newSize);
+		return _buffer->data() + oldSize;
+	}
+}
+template<typename BT>
+uint8_t *ByteWriter<BT>::_try_expand(size_t bytesToExpand)
+{
+	if constexpr (CURSOR && UNCHECKED == false) {
+		if ((size_t)(_end - _ptr) < bytesToExpand) {
+			[[unlikely]];
+			if (_next_window(bytesToExpand) == false) {
+				return nullptr;
+			}
+		}
+		uint8_t *p = _ptr;
+		_ptr += bytesToExpand;
+		return p;
+	} else {
+		return _expand(bytesToExpand);
+	}
+}
+template<typename BT>
+void ByteWriter<BT>::_shrink(size_t bytes)
+{
+	if constexpr (CURSOR) {
+		_ptr -= bytes;
+	} else {
+		_buffer->resize(_buffer->size() - bytes);
+	}
 }
 template<typename BT>
 void ByteWriter<BT>::_reserve_expand(size_t bytesToExpand)
 {
-	_reserve(_buffer->size() + bytesToExpand);
+	if constexpr (UNCHECKED) {
+		// space was already reserved by parent writer
+	} else if constexpr (CURSOR) {
+		if ((size_t)(_end - _ptr) < bytesToExpand &&
+			(UNLIMITED_SIZE == false ||
+			 bytesToExpand <= UNLIMITED_SIZE_MAX_BOUND)) {
+			[[unlikely]];
+			// only a hint, fixed size BT may still fit actual data
+			_next_window(bytesToExpand, false);
+		}
+	} else {
+		_reserve(_buffer->size() + bytesToExpand);
+	}
+}
+template<typename BT>
+void ByteWriter<BT>::_reserve_exact(size_t bytesToExpand)
+{
+	if constexpr (CURSOR) {
+		_reserve_expand(bytesToExpand);
+	} else {
+		const size_t newCapacity = _buffer->size() + bytesToExpand;
+		if (_buffer->capacity() < newCapacity) {
+			if (newCapacity > MAX_BUFFER_SIZE) {
+				[[unlikely]];
+				set_error(ERROR_BUFFER_TOO_SMALL);
+				return;
+			}
+			if constexpr (requires { _buffer->reserve_exact(newCapacity); }) {
+				_buffer->reserve_exact(newCapacity);
+			} else {
+				_buffer->reserve(newCapacity);
+			}
+		}
+	}
+}
+template<typename BT>
+bool ByteWriter<BT>::_next_window(size_t bytes, bool required)
+{
+	if (UNLIMITED_SIZE == false && (size_t)GetSize() + bytes > MAX_BUFFER_SIZE) {
+		[[unlikely]];
+		if (required) {
+			set_error(ERROR_BUFFER_TOO_SMALL);
+		}
+		return false;
+	}
+	uint8_t *window = _buffer->next_window(_ptr, bytes, _end);
+	if (window == nullptr) {
+		[[unlikely]];
+		_ptr = _end = _window = nullptr;
+		if (required) {
+			set_error(ERROR_BUFFER_TOO_SMALL);
+		}
+		return false;
+	}
+	_ptr = _window = window;
+	return true;
 }
 template<typename BT>
 void ByteWriter<BT>::_reserve(size_t newCapacity)
@@ -9,6 +9,7 @@
 
 #include <cassert>
 #include <cstdint>
+#include <cstring>
 
 #include <bit>
 
@@ -77,48 +78,25 @@ inline void WriteBytesInNetworkOrder(uint8_t *buffer, uint16_t value, int bytes)
 		*buffer = value;
 	}
 }
+inline void WriteUintInNetworkOrder(uint8_t *buffer, uint64_t value)
+{
+	value = HostToNetworkUint(value);
+	memcpy(buffer, &value, sizeof(value));
+}
+inline void WriteUintInNetworkOrder(uint8_t *buffer, uint32_t value)
+{
+	value = HostToNetworkUint(value);
+	memcpy(buffer, &value, sizeof(value));
+}
+inline void WriteUintInNetworkOrder(uint8_t *buffer, uint16_t value)
+{
+	value = HostToNetworkUint(value);
+	memcpy(buffer, &value, sizeof(value));
+}
 inline uint64_t ReadBytesInNetworkOrder(uint8_t const *buffer, int bytes)
 {
 	assert(bytes > 0 && bytes <= 8);
 
-	/*
-	uint64_t const *a = (uint64_t const *)(((intptr_t)buffer) & (~7lu));
-	uint64_t va = NetworkToHostUint(*a);
-
-	uint64_t const *b = (uint64_t const *)(((intptr_t)buffer + bytes - 1) & (~7lu));
-
-	assert((intptr_t)a <= (intptr_t)buffer);
-	assert((intptr_t)b >= (intptr_t)a);
-	
-	uint64_t v;
-
-	if (a == b) {
-		uint32_t of1 = buffer - (uint8_t const *)a;
-		uint32_t off1 = of1 << 3;
-		assert(off1 >= 0);
-		assert(off1 < 64);
-
-		v = (va >> off1);
-	} else {
-		uint64_t vb = NetworkToHostUint(*b);
-		uint32_t of1 = buffer - (uint8_t const *)a;
-		uint32_t of2 = (uint8_t const *)b - buffer;
-		uint32_t off1 = of1 << 3;
-		uint32_t off2 = of2 << 3;
-		assert(off1 >= 0);
-		assert(off1 < 64);
-		assert(off2 >= 0);
-		assert(off2 < 64);
-
-		v = (va >> off1) | (vb << off2);
-	}
-
-
-	v &= (~0lu) >> (64 - (bytes << 3));
-
-	return NetworkToHostUint(v);
-	*/
-
 	uint64_t v = 0;
 	switch(bytes) {
 	case 8:
@@ -162,6 +140,29 @@ inline uint64_t ReadBytesInNetworkOrder(uint8_t const *buffer, int bytes)
 	return value;
 	*/
 }
+inline uint64_t ReadWideBytesInNetworkOrder(uint8_t const *buffer, int bytes)
+{
+	assert(bytes > 0 && bytes <= 8);
+	uint64_t v;
+	memcpy(&v, buffer, 8);
+	return NetworkToHostUint(v) & (~0llu >> (64 - (bytes << 3)));
+}
+
+inline void CopyElementsInNetworkOrder(uint8_t *dst, const uint8_t *src,
+									   size_t elements, int elementSize)
+{
+	if constexpr (Endian::little) {
+		memcpy(dst, src, elements * elementSize);
+	} else {
+		for (size_t i = 0; i < elements; ++i) {
+			for (int j = 0; j < elementSize; ++j) {
+				dst[j] = src[elementSize - 1 - j];
+			}
+			dst += elementSize;
+			src += elementSize;
+		}
+	}
+}
 } // namespace bitscpp
 
 #endif
@@ -0,0 +1,282 @@
+// Copyright (C) 2026 Marek Zalewski aka Drwalin
+//
+// This file is part of bitscpp project under MIT License
+// You should have received a copy of the MIT License along with this program.
+
+#ifndef BITSCPP_HALF_FLOAT_INL_HPP
+#define BITSCPP_HALF_FLOAT_INL_HPP
+
+#include <cstdint>
+#include <cstring>
+
+#include <bit>
+
+#include "Simd.inl.hpp"
+
+#include "../include/bitscpp/Endianness.hpp"
+#include "../include/bitscpp/HalfFloat.hpp"
+
+/*
+ * Half to float uses tables from "Fast Half Float Conversions" by Jeroen van
+ * der Zijp. Float to half is based on public domain float_to_half_fast3_rtne
+ * by Fabian Giesen, with selects instead of branches. Without F16C, arrays
+ * are converted by 8 elements with SSE2 versions of the same arithmetic.
+ */
+
+namespace bitscpp
+{
+namespace impl
+{
+struct HalfToFloatTable {
+	// indexed by offset[exponent] + mantissa of half
+	uint32_t mantissa[2048];
+	// indexed by sign and exponent of half
+	uint32_t exponent[64];
+	uint16_t offset[64];
+};
+
+consteval HalfToFloatTable make_half_to_float_table()
+{
+	HalfToFloatTable t{};
+	t.mantissa[0] = 0;
+	for (uint32_t i = 1; i < 1024; ++i) {
+		// normalise denormal mantissa
+		uint32_t m = i << 13;
+		uint32_t e = 0;
+		while ((m & 0x00800000) == 0) {
+			e -= 0x00800000;
+			m <<= 1;
+		}
+		m &= ~0x00800000u;
+		e += 0x38800000;
+		t.mantissa[i] = m | e;
+	}
+	for (uint32_t i = 1024; i < 2048; ++i) {
+		t.mantissa[i] = 0x38000000 + ((i - 1024) << 13);
+	}
+	t.exponent[0] = 0;
+	t.exponent[31] = 0x47800000;
+	t.exponent[32] = 0x80000000;
+	t.exponent[63] = 0xC7800000;
+	for (uint32_t i = 1; i < 31; ++i) {
+		t.exponent[i] = i << 23;
+		t.exponent[i + 32] = 0x80000000 + (i << 23);
+	}
+	for (uint32_t i = 0; i < 64; ++i) {
+		t.offset[i] = (i == 0 || i == 32) ? 0 : 1024;
+	}
+	return t;
+}
+
+inline constexpr HalfToFloatTable halfToFloatTable =
+	make_half_to_float_table();
+
+inline float half_to_float_soft(uint16_t value)
+{
+	const uint32_t e = value >> 10;
+	uint32_t f = halfToFloatTable.mantissa[halfToFloatTable.offset[e] +
+										   (value & 0x3FF)] +
+				 halfToFloatTable.exponent[e];
+	// NaN is made quiet
+	f |= (uint32_t)((value & 0x7FFF) > 0x7C00) << 22;
+	return std::bit_cast<float>(f);
+}
+
+inline constexpr uint32_t FLOAT_INF = 0x7F800000;
+// smallest float rounded to half infinity is below it
+inline constexpr uint32_t HALF_OVERFLOW = (127 + 16) << 23;
+inline constexpr uint32_t HALF_MIN_NORMAL = (127 - 14) << 23;
+// 0.5f, its ulp is ulp of half denormal
+inline constexpr uint32_t DENORMAL_MAGIC = 126 << 23;
+inline constexpr uint32_t REBIAS = ((uint32_t)(15 - 127) << 23) + 0xFFF;
+
+inline uint16_t float_to_half_soft(float value)
+{
+	uint32_t f = std::bit_cast<uint32_t>(value);
+	const uint32_t sign = (f >> 16) & 0x8000;
+	f &= 0x7FFFFFFF;
+
+	// rounded by float addition
+	const uint32_t denormal =
+		std::bit_cast<uint32_t>(std::bit_cast<float>(f) +
+								std::bit_cast<float>(DENORMAL_MAGIC)) -
+		DENORMAL_MAGIC;
+	// rebias exponent and round to nearest even
+	const uint32_t normal = (f + REBIAS + ((f >> 13) & 1)) >> 13;
+	const uint32_t nan = 0 - (uint32_t)(f > FLOAT_INF);
+	const uint32_t special = 0x7C00 | (nan & (0x200 | (f >> 13)));
+
+	// masks instead of conditions, so that compiler does not emit branches
+	const uint32_t small = 0 - (uint32_t)(f < HALF_MIN_NORMAL);
+	const uint32_t big = 0 - (uint32_t)(f >= HALF_OVERFLOW);
+	uint32_t h = (denormal & small) | (normal & ~small);
+	h = (special & big) | (h & ~big);
+	return (h & 0x7FFF) | sign;
+}
+
+#ifdef BITSCPP_SSE2
+inline __m128i sse2_select(__m128i mask, __m128i a, __m128i b)
+{
+	return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+// Returns halves in lower 16 bits of 32-bit lanes.
+inline __m128i float_to_half_sse2(__m128 value)
+{
+	__m128i f = _mm_castps_si128(value);
+	const __m128i sign =
+		_mm_and_si128(_mm_srli_epi32(f, 16), _mm_set1_epi32(0x8000));
+	f = _mm_and_si128(f, _mm_set1_epi32(0x7FFFFFFF));
+
+	const __m128i magic = _mm_set1_epi32(DENORMAL_MAGIC);
+	const __m128i denormal = _mm_sub_epi32(
+		_mm_castps_si128(_mm_add_ps(_mm_castsi128_ps(f),
+									_mm_castsi128_ps(magic))),
+		magic);
+	const __m128i odd =
+		_mm_and_si128(_mm_srli_epi32(f, 13), _mm_set1_epi32(1));
+	const __m128i normal = _mm_srli_epi32(
+		_mm_add_epi32(_mm_add_epi32(f, _mm_set1_epi32(REBIAS)), odd), 13);
+	// lanes are not negative, so signed comparisons are enough
+	const __m128i nan = _mm_cmpgt_epi32(f, _mm_set1_epi32(FLOAT_INF));
+	const __m128i special = _mm_or_si128(
+		_mm_set1_epi32(0x7C00),
+		_mm_and_si128(nan, _mm_or_si128(_mm_set1_epi32(0x200),
+										_mm_srli_epi32(f, 13))));
+
+	const __m128i small = _mm_cmplt_epi32(f, _mm_set1_epi32(HALF_MIN_NORMAL));
+	const __m128i big = _mm_cmpgt_epi32(f, _mm_set1_epi32(HALF_OVERFLOW - 1));
+	__m128i h = sse2_select(small, denormal, normal);
+	h = sse2_select(big, special, h);
+	return _mm_or_si128(_mm_and_si128(h, _mm_set1_epi32(0x7FFF)), sign);
+}
+
+// Takes halves in lower 16 bits of 32-bit lanes.
+inline __m128 half_to_float_sse2(__m128i h)
+{
+	constexpr int32_t HALF_EXPONENT = 0x7C00 << 13;
+	const __m128i shifted =
+		_mm_slli_epi32(_mm_and_si128(h, _mm_set1_epi32(0x7FFF)), 13);
+	const __m128i exponent =
+		_mm_and_si128(shifted, _mm_set1_epi32(HALF_EXPONENT));
+	__m128i f = _mm_add_epi32(shifted, _mm_set1_epi32((127 - 15) << 23));
+
+	// infinity and NaN, NaN is made quiet
+	const __m128i special =
+		_mm_cmpeq_epi32(exponent, _mm_set1_epi32(HALF_EXPONENT));
+	const __m128i nan = _mm_cmpgt_epi32(shifted, _mm_set1_epi32(HALF_EXPONENT));
+	f = _mm_add_epi32(
+		f, _mm_and_si128(special, _mm_set1_epi32((128 - 16) << 23)));
+	f = _mm_or_si128(f, _mm_and_si128(nan, _mm_set1_epi32(0x400000)));
+
+	// zero and denormal, normalised by float subtraction
+	const __m128i zero = _mm_cmpeq_epi32(exponent, _mm_setzero_si128());
+	const __m128i minNormal = _mm_set1_epi32((127 - 14) << 23);
+	const __m128i denormal = _mm_castps_si128(
+		_mm_sub_ps(_mm_castsi128_ps(_mm_add_epi32(f, _mm_set1_epi32(1 << 23))),
+				   _mm_castsi128_ps(minNormal)));
+	f = sse2_select(zero, denormal, f);
+
+	const __m128i sign =
+		_mm_slli_epi32(_mm_and_si128(h, _mm_set1_epi32(0x8000)), 16);
+	return _mm_castsi128_ps(_mm_or_si128(f, sign));
+}
+#endif
+
+// dst receives elements * 2 bytes in network byte order.
+inline void float_to_half_array(uint8_t *dst, const float *src,
+								size_t elements)
+{
+	size_t i = 0;
+#ifdef BITSCPP_F16C
+	for (; i + 8 <= elements; i += 8) {
+		const __m128i h = _mm256_cvtps_ph(_mm256_loadu_ps(src + i),
+										  _MM_FROUND_TO_NEAREST_INT);
+		_mm_storeu_si128((__m128i *)(dst + i * 2), h);
+	}
+#elif defined(BITSCPP_SSE2)
+	for (; i + 8 <= elements; i += 8) {
+		const __m128i lo = float_to_half_sse2(_mm_loadu_ps(src + i));
+		const __m128i hi = float_to_half_sse2(_mm_loadu_ps(src + i + 4));
+		// sign extension, so that signed saturation keeps values
+		const __m128i h =
+			_mm_packs_epi32(_mm_srai_epi32(_mm_slli_epi32(lo, 16), 16),
+							_mm_srai_epi32(_mm_slli_epi32(hi, 16), 16));
+		_mm_storeu_si128((__m128i *)(dst + i * 2), h);
+	}
+#endif
+	for (; i < elements; ++i) {
+		const uint16_t h = HostToNetworkUint(FloatToHalf(src[i]));
+		memcpy(dst + i * 2, &h, 2);
+	}
+}
+
+// src contains elements * 2 bytes in network byte order.
+inline void half_array_to_float(float *dst, const uint8_t *src,
+								size_t elements)
+{
+	size_t i = 0;
+#ifdef BITSCPP_F16C
+	for (; i + 8 <= elements; i += 8) {
+		const __m128i h = _mm_loadu_si128((const __m128i *)(src + i * 2));
+		_mm256_storeu_ps(dst + i, _mm256_cvtph_ps(h));
+	}
+#elif defined(BITSCPP_SSE2)
+	for (; i + 8 <= elements; i += 8) {
+		const __m128i h = _mm_loadu_si128((const __m128i *)(src + i * 2));
+		const __m128i zero = _mm_setzero_si128();
+		_mm_storeu_ps(dst + i, half_to_float_sse2(_mm_unpacklo_epi16(h, zero)));
+		_mm_storeu_ps(dst + i + 4,
+					  half_to_float_sse2(_mm_unpackhi_epi16(h, zero)));
+	}
+#endif
+	for (; i < elements; ++i) {
+		uint16_t h;
+		memcpy(&h, src + i * 2, 2);
+		dst[i] = HalfToFloat(NetworkToHostUint(h));
+	}
+}
+} // namespace impl
+
+inline uint16_t FloatToHalf(float value)
+{
+#ifdef BITSCPP_F16C
+	return _cvtss_sh(value, _MM_FROUND_TO_NEAREST_INT);
+#else
+	return impl::float_to_half_soft(value);
+#endif
+}
+
+inline float HalfToFloat(uint16_t value)
+{
+#ifdef BITSCPP_F16C
+	return _cvtsh_ss(value);
+#else
+	return impl::half_to_float_soft(value);
+#endif
+}
+
+inline void FloatToHalf(uint16_t *dst, const float *src, size_t elements)
+{
+	if constexpr (Endian::little) {
+		impl::float_to_half_array((uint8_t *)dst, src, elements);
+	} else {
+		for (size_t i = 0; i < elements; ++i) {
+			dst[i] = FloatToHalf(src[i]);
+		}
+	}
+}
+
+inline void HalfToFloat(float *dst, const uint16_t *src, size_t elements)
+{
+	if constexpr (Endian::little) {
+		impl::half_array_to_float(dst, (const uint8_t *)src, elements);
+	} else {
+		for (size_t i = 0; i < elements; ++i) {
+			dst[i] = HalfToFloat(src[i]);
+		}
+	}
+}
+} // namespace bitscpp
+
+#endif
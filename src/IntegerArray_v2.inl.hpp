@@ -0,0 +1,396 @@
+// Copyright (C) 2026 Marek Zalewski aka Drwalin
+//
+// This file is part of bitscpp project under MIT License
+// You should have received a copy of the MIT License along with this program.
+
+#ifndef BITSCPP_INTEGER_ARRAY_V2_INL_HPP
+#define BITSCPP_INTEGER_ARRAY_V2_INL_HPP
+
+#include <cstdint>
+#include <cstring>
+
+#include <algorithm>
+#include <bit>
+#include <type_traits>
+
+#include "Simd.inl.hpp"
+
+#include "../include/bitscpp/Endianness.hpp"
+#include "../include/bitscpp/V2_Specification.hpp"
+
+/*
+ * Bulk encoding of integer arrays, producing the same bytes as encoding every
+ * element with ByteWriter::op_int().
+ *
+ * Values are processed in blocks of 16 elements. Block with all values in
+ * immediate integer range is classified with SIMD (SSE2, or AVX2 when
+ * enabled at compile time) and stored with single 16 byte store, other
+ * blocks are encoded element by element with 8 byte stores of payload.
+ *
+ * Bulk decoding reads 16 bytes at once: when all of them are immediate
+ * integers or they are 8 12-bit integers, they are decoded with SIMD, other
+ * values are decoded one by one with the same result as ByteReader::op().
+ *
+ * encode_int() and encode_var_uint() are also used by ByteWriter for single
+ * values, when its window has WIDE_STORE_BYTES writable bytes.
+ */
+
+namespace bitscpp
+{
+namespace v2
+{
+namespace impl
+{
+template<typename T>
+concept BatchInteger =
+	std::is_same_v<T, int8_t> || std::is_same_v<T, int16_t> ||
+	std::is_same_v<T, int32_t> || std::is_same_v<T, int64_t> ||
+	std::is_same_v<T, uint8_t> || std::is_same_v<T, uint16_t> ||
+	std::is_same_v<T, uint32_t> || std::is_same_v<T, uint64_t>;
+
+// Number of bytes that encode_int_array() may write past end of encoded data.
+constexpr inline size_t INT_ARRAY_SLACK = 16;
+
+constexpr inline uint32_t INT_ARRAY_BLOCK = 16;
+
+// Number of writable bytes needed by encode_int() and encode_var_uint(),
+// which store payload with single 8 byte store and may write up to 8 bytes
+// past end of encoded value.
+constexpr inline size_t WIDE_STORE_BYTES = 9;
+
+// Same bytes as ByteWriter::op_int().
+inline uint8_t *encode_int(uint8_t *p, int64_t v)
+{
+	if ((uint64_t)(v - IMMEDIATE_INTEGER_VALUE_MIN) <= IMMEDIATE_INTEGER_MAX) {
+		[[likely]];
+		*p = (uint8_t)(v - IMMEDIATE_INTEGER_VALUE_MIN);
+		return p + 1;
+	}
+	const uint64_t uv = ((uint64_t)v << 1) ^ (uint64_t)(v >> 63);
+	const uint32_t bits = std::bit_width(uv);
+	const uint32_t bytes = (bits + 7) >> 3;
+	// 12-bit or sized integer, selected without branches
+	const bool small = bits <= 12;
+	p[0] = small ? BEG_12B_INTEGER + (uint8_t)(uv & 0xF)
+				 : (uint8_t)(bytes + BEG_SIZED_INTEGER - 2);
+	WriteUintInNetworkOrder(p + 1, small ? uv >> 4 : uv);
+	return p + (small ? 2 : 1 + bytes);
+}
+
+// Tables of VAR_UINT encoding, indexed by number of bytes - 1.
+constexpr inline uint8_t VAR_UINT_MASKS[9] = {0x7F, 0x3F, 0x1F, 0x0F, 0x07,
+											  0x03, 0x01, 0x00, 0x00};
+constexpr inline uint8_t VAR_UINT_ONES[9] = {0x00, 0x80, 0xC0, 0xE0, 0xF0,
+											 0xF8, 0xFC, 0xFE, 0xFF};
+constexpr inline uint8_t VAR_UINT_SHIFTS[9] = {7, 6, 5, 4, 3, 2, 1, 0, 0};
+// Number of bytes indexed by bit width of value.
+constexpr inline uint8_t VAR_UINT_BYTES[65] = {
+	1, 1, 1, 1, 1, 1, 1, 1, 2, 2, 2, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 3,
+	4, 4, 4, 4, 4, 4, 4, 5, 5, 5, 5, 5, 5, 5, 6, 6, 6, 6, 6, 6, 6, 7,
+	7, 7, 7, 7, 7, 7, 8, 8, 8, 8, 8, 8, 8, 9, 9, 9, 9, 9, 9, 9, 9};
+
+// Same bytes as ByteWriter::op_untyped_var_uint(), without branches.
+inline uint8_t *encode_var_uint(uint8_t *p, uint64_t value)
+{
+	const uint32_t bytes = VAR_UINT_BYTES[std::bit_width(value)];
+	p[0] = (VAR_UINT_MASKS[bytes - 1] & value) | VAR_UINT_ONES[bytes - 1];
+	WriteUintInNetworkOrder(p + 1, value >> VAR_UINT_SHIFTS[bytes - 1]);
+	return p + bytes;
+}
+
+template<typename T>
+inline int64_t int_array_value(T v)
+{
+	if constexpr (std::is_unsigned_v<T>) {
+		// same as ByteWriter::op_uint()
+		return (int64_t)(uint64_t)v;
+	} else {
+		return v;
+	}
+}
+
+// Writes all 16 values of block as immediate integers and returns true when
+// all of them are in immediate range.
+template<typename T>
+inline bool encode_immediate_block(uint8_t *p, const T *data)
+{
+#ifdef BITSCPP_SSE2
+	if constexpr (sizeof(T) <= 4) {
+		// Values biased by -IMMEDIATE_INTEGER_VALUE_MIN are immediate when
+		// they are in <0, IMMEDIATE_INTEGER_MAX>. 32 bit values are narrowed
+		// to 16 bit with signed saturation, which keeps them out of range.
+		__m128i v16[2];
+		if constexpr (sizeof(T) == 4) {
+			__m128i v[4];
+			const __m128i bias = _mm_set1_epi32(-IMMEDIATE_INTEGER_VALUE_MIN);
+			for (int i = 0; i < 4; ++i) {
+				v[i] = _mm_loadu_si128((const __m128i *)(data + i * 4));
+				if constexpr (std::is_unsigned_v<T>) {
+					// values >= 2^31 are replaced by 2^31-1
+					v[i] = _mm_or_si128(
+						_mm_and_si128(v[i], _mm_set1_epi32(0x7FFFFFFF)),
+						_mm_srli_epi32(_mm_srai_epi32(v[i], 31), 1));
+				}
+				// values wrapped around by bias become negative
+				v[i] = _mm_add_epi32(v[i], bias);
+			}
+			v16[0] = _mm_packs_epi32(v[0], v[1]);
+			v16[1] = _mm_packs_epi32(v[2], v[3]);
+		} else if constexpr (sizeof(T) == 2) {
+			const __m128i bias = _mm_set1_epi16(-IMMEDIATE_INTEGER_VALUE_MIN);
+			for (int i = 0; i < 2; ++i) {
+				__m128i v = _mm_loadu_si128((const __m128i *)(data + i * 8));
+				if constexpr (std::is_unsigned_v<T>) {
+					v = _mm_or_si128(_mm_and_si128(v, _mm_set1_epi16(0x7FFF)),
+									 _mm_srli_epi16(_mm_srai_epi16(v, 15), 1));
+				}
+				v16[i] = _mm_add_epi16(v, bias);
+			}
+		} else {
+			const __m128i v = _mm_loadu_si128((const __m128i *)data);
+			if constexpr (std::is_unsigned_v<T>) {
+				v16[0] = _mm_unpacklo_epi8(v, _mm_setzero_si128());
+				v16[1] = _mm_unpackhi_epi8(v, _mm_setzero_si128());
+			} else {
+				v16[0] = _mm_srai_epi16(_mm_unpacklo_epi8(v, v), 8);
+				v16[1] = _mm_srai_epi16(_mm_unpackhi_epi8(v, v), 8);
+			}
+			const __m128i bias = _mm_set1_epi16(-IMMEDIATE_INTEGER_VALUE_MIN);
+			v16[0] = _mm_add_epi16(v16[0], bias);
+			v16[1] = _mm_add_epi16(v16[1], bias);
+		}
+		const __m128i max = _mm_set1_epi16(IMMEDIATE_INTEGER_MAX);
+		const __m128i invalid = _mm_or_si128(
+			_mm_or_si128(_mm_cmpgt_epi16(v16[0], max),
+						 _mm_cmpgt_epi16(v16[1], max)),
+			_mm_or_si128(_mm_cmplt_epi16(v16[0], _mm_setzero_si128()),
+						 _mm_cmplt_epi16(v16[1], _mm_setzero_si128())));
+		if (_mm_movemask_epi8(invalid) != 0) {
+			return false;
+		}
+		_mm_storeu_si128((__m128i *)p, _mm_packus_epi16(v16[0], v16[1]));
+		return true;
+	}
+#endif
+#ifdef BITSCPP_AVX2
+	if constexpr (sizeof(T) == 8) {
+		const __m256i bias = _mm256_set1_epi64x(-IMMEDIATE_INTEGER_VALUE_MIN);
+		const __m256i max = _mm256_set1_epi64x(IMMEDIATE_INTEGER_MAX);
+		__m256i invalid = _mm256_setzero_si256();
+		for (int i = 0; i < 4; ++i) {
+			__m256i v = _mm256_loadu_si256((const __m256i *)(data + i * 4));
+			v = _mm256_add_epi64(v, bias);
+			// unsigned comparison v > max
+			invalid = _mm256_or_si256(
+				invalid,
+				_mm256_cmpgt_epi64(
+					_mm256_xor_si256(v, _mm256_set1_epi64x(INT64_MIN)),
+					_mm256_xor_si256(max, _mm256_set1_epi64x(INT64_MIN))));
+		}
+		if (_mm256_testz_si256(invalid, invalid) == 0) {
+			return false;
+		}
+		for (uint32_t i = 0; i < INT_ARRAY_BLOCK; ++i) {
+			p[i] = (uint8_t)(data[i] - IMMEDIATE_INTEGER_VALUE_MIN);
+		}
+		return true;
+	}
+#endif
+	bool immediate = true;
+	for (uint32_t i = 0; i < INT_ARRAY_BLOCK; ++i) {
+		immediate &= (uint64_t)(int_array_value(data[i]) -
+								IMMEDIATE_INTEGER_VALUE_MIN) <=
+					 IMMEDIATE_INTEGER_MAX;
+	}
+	if (immediate == false) {
+		return false;
+	}
+	for (uint32_t i = 0; i < INT_ARRAY_BLOCK; ++i) {
+		p[i] = (uint8_t)(int_array_value(data[i]) - IMMEDIATE_INTEGER_VALUE_MIN);
+	}
+	return true;
+}
+
+// Destination has to have space for encoded data and INT_ARRAY_SLACK bytes.
+// Returns end of encoded data.
+template<typename T>
+inline uint8_t *encode_int_array(uint8_t *p, const T *data, uint32_t elements)
+{
+	uint32_t i = 0;
+	for (; i + INT_ARRAY_BLOCK <= elements; i += INT_ARRAY_BLOCK) {
+		if (encode_immediate_block(p, data + i)) {
+			p += INT_ARRAY_BLOCK;
+			continue;
+		}
+		for (uint32_t j = 0; j < INT_ARRAY_BLOCK; ++j) {
+			p = encode_int(p, int_array_value(data[i + j]));
+		}
+	}
+	for (; i < elements; ++i) {
+		p = encode_int(p, int_array_value(data[i]));
+	}
+	return p;
+}
+
+// Stores value into out with the same truncation as ByteReader::op(T &).
+// Returns true on overflow.
+template<typename T>
+inline bool decode_store(T &out, int64_t v)
+{
+	if constexpr (std::is_unsigned_v<T>) {
+		out = (T)(uint64_t)v;
+		return (uint64_t)out != (uint64_t)v;
+	} else {
+		out = (T)v;
+		return (int64_t)out != v;
+	}
+}
+
+// Decodes single integer, returns nullptr when it is not an integer or
+// buffer ends too early. Padding is number of readable bytes after end.
+inline const uint8_t *decode_int(const uint8_t *p, const uint8_t *end,
+								 int64_t &v, size_t padding = 0)
+{
+	const uint8_t header = *p;
+	uint64_t vv;
+	if (header <= END_IMMEDIATE_INTEGER) {
+		[[likely]];
+		v = (int64_t)header + IMMEDIATE_INTEGER_VALUE_MIN;
+		return p + 1;
+	} else if (header <= END_12B_INTEGER) {
+		if (end - p < 2) {
+			[[unlikely]];
+			return nullptr;
+		}
+		vv = ((uint64_t)p[1] << 4) | (uint64_t)(header - BEG_12B_INTEGER);
+		p += 2;
+	} else if (header <= END_SIZED_INTEGER) {
+		const int bytes = header - BEG_SIZED_INTEGER + 2;
+		if (end - p <= bytes) {
+			[[unlikely]];
+			return nullptr;
+		}
+		if ((size_t)(end - p) + padding > 8) {
+			[[likely]];
+			vv = ReadWideBytesInNetworkOrder(p + 1, bytes);
+		} else {
+			vv = ReadBytesInNetworkOrder(p + 1, bytes);
+		}
+		p += 1 + bytes;
+	} else {
+		[[unlikely]];
+		return nullptr;
+	}
+	v = (int64_t)((vv >> 1) ^ (0 - (vv & 1)));
+	return p;
+}
+
+#ifdef BITSCPP_SSE2
+// Stores 8 int16 values into out, returns true on overflow.
+template<typename T>
+inline bool decode_store_i16x8(T *out, __m128i v)
+{
+	const __m128i zero = _mm_setzero_si128();
+	__m128i invalid = zero;
+	// like ByteReader::op(uint64_t &), negative values wrap around silently
+	if constexpr (std::is_unsigned_v<T> && sizeof(T) < 8) {
+		invalid = _mm_cmplt_epi16(v, zero);
+	}
+	if constexpr (std::is_same_v<T, int8_t>) {
+		invalid = _mm_or_si128(_mm_cmpgt_epi16(v, _mm_set1_epi16(127)),
+							   _mm_cmplt_epi16(v, _mm_set1_epi16(-128)));
+	} else if constexpr (std::is_same_v<T, uint8_t>) {
+		invalid = _mm_or_si128(invalid,
+							   _mm_cmpgt_epi16(v, _mm_set1_epi16(255)));
+	}
+	if constexpr (sizeof(T) == 1) {
+		const __m128i bytes = _mm_and_si128(v, _mm_set1_epi16(0xFF));
+		_mm_storel_epi64((__m128i *)out, _mm_packus_epi16(bytes, bytes));
+	} else if constexpr (sizeof(T) == 2) {
+		_mm_storeu_si128((__m128i *)out, v);
+	} else {
+		const __m128i sign = _mm_srai_epi16(v, 15);
+		const __m128i lo = _mm_unpacklo_epi16(v, sign);
+		const __m128i hi = _mm_unpackhi_epi16(v, sign);
+		if constexpr (sizeof(T) == 4) {
+			_mm_storeu_si128((__m128i *)out, lo);
+			_mm_storeu_si128((__m128i *)(out + 4), hi);
+		} else {
+			const __m128i signLo = _mm_srai_epi32(lo, 31);
+			const __m128i signHi = _mm_srai_epi32(hi, 31);
+			_mm_storeu_si128((__m128i *)out, _mm_unpacklo_epi32(lo, signLo));
+			_mm_storeu_si128((__m128i *)(out + 2), _mm_unpackhi_epi32(lo, signLo));
+			_mm_storeu_si128((__m128i *)(out + 4), _mm_unpacklo_epi32(hi, signHi));
+			_mm_storeu_si128((__m128i *)(out + 6), _mm_unpackhi_epi32(hi, signHi));
+		}
+	}
+	return _mm_movemask_epi8(invalid) != 0;
+}
+#endif
+
+// Decodes elements integers from <p, end) into out. Returns end of decoded
+// data, or nullptr when some value is not an integer or buffer is too small.
+// Sets overflow when some value does not fit into T.
+template<typename T>
+inline const uint8_t *decode_int_array(const uint8_t *p, const uint8_t *end,
+									   T *out, uint32_t elements,
+									   bool &overflow, size_t padding = 0)
+{
+	uint32_t i = 0;
+	while (i < elements) {
+#ifdef BITSCPP_SSE2
+		if (elements - i >= INT_ARRAY_BLOCK && end - p >= 16) {
+			const __m128i b = _mm_loadu_si128((const __m128i *)p);
+			const __m128i maxImmediate = _mm_set1_epi8((char)END_IMMEDIATE_INTEGER);
+			if (_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_max_epu8(b, maxImmediate),
+												 maxImmediate)) == 0xFFFF) {
+				const __m128i bias = _mm_set1_epi16(-IMMEDIATE_INTEGER_VALUE_MIN);
+				const __m128i zero = _mm_setzero_si128();
+				overflow |= decode_store_i16x8(
+					out + i, _mm_sub_epi16(_mm_unpacklo_epi8(b, zero), bias));
+				overflow |= decode_store_i16x8(
+					out + i + 8, _mm_sub_epi16(_mm_unpackhi_epi8(b, zero), bias));
+				p += 16;
+				i += 16;
+				continue;
+			}
+			// 8 pairs of 12-bit integer header and second byte
+			if (_mm_movemask_epi8(_mm_cmpeq_epi16(
+					_mm_and_si128(b, _mm_set1_epi16(0xF0)),
+					_mm_set1_epi16(BEG_12B_INTEGER))) == 0xFFFF) {
+				const __m128i u = _mm_or_si128(
+					_mm_slli_epi16(_mm_srli_epi16(b, 8), 4),
+					_mm_and_si128(b, _mm_set1_epi16(0x0F)));
+				const __m128i v = _mm_xor_si128(
+					_mm_srli_epi16(u, 1),
+					_mm_sub_epi16(_mm_setzero_si128(),
+								  _mm_and_si128(u, _mm_set1_epi16(1))));
+				overflow |= decode_store_i16x8(out + i, v);
+				p += 16;
+				i += 8;
+				continue;
+			}
+		}
+#endif
+		const uint32_t count = std::min<uint32_t>(elements - i, INT_ARRAY_BLOCK);
+		for (uint32_t j = 0; j < count; ++j, ++i) {
+			if (p >= end) {
+				[[unlikely]];
+				return nullptr;
+			}
+			int64_t v;
+			p = decode_int(p, end, v, padding);
+			if (p == nullptr) {
+				[[unlikely]];
+				return nullptr;
+			}
+			overflow |= decode_store(out[i], v);
+		}
+	}
+	return p;
+}
+} // namespace impl
+} // namespace v2
+} // namespace bitscpp
+
+#endif
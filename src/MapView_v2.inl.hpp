@@ -0,0 +1,168 @@
+// Copyright (C) 2026 Marek Zalewski aka Drwalin
+//
+// This file is part of bitscpp project under MIT License
+// You should have received a copy of the MIT License along with this program.
+
+#ifndef BITSCPP_MAP_VIEW_V2_INL_HPP
+#define BITSCPP_MAP_VIEW_V2_INL_HPP
+
+#include <cstdint>
+
+#include <string_view>
+
+#include "../include/bitscpp/V2_Specification.hpp"
+#include "../include/bitscpp/ByteReader_v2.hpp"
+#include "../include/bitscpp/MapView_v2.hpp"
+
+namespace bitscpp
+{
+namespace v2
+{
+template<bool CHECKED>
+inline BasicMapView<CHECKED>::BasicMapView(Reader &reader) : first(reader)
+{
+	if (reader.has_bytes_to_read(1) && *reader.ptr == BEG_SORTED_MAP) {
+		++reader.ptr;
+		reader._op_offset_table(map, 2);
+		first = reader;
+		// after last entry
+		reader.seek_array_element(map, map.elements);
+	} else {
+		reader.op_map_header(map.elements);
+		first = reader;
+		reader.skip_values(map.elements * 2);
+	}
+	if (reader.get_errors() != ERROR_OK) {
+		[[unlikely]];
+		map = {};
+	}
+}
+
+template<bool CHECKED>
+inline uint32_t BasicMapView<CHECKED>::size() const
+{
+	return map.elements;
+}
+
+template<bool CHECKED>
+inline bool BasicMapView<CHECKED>::is_sorted() const
+{
+	return map.width != 0;
+}
+
+template<bool CHECKED>
+inline typename BasicMapView<CHECKED>::Iterator
+BasicMapView<CHECKED>::begin() const
+{
+	return {first, 0};
+}
+
+template<bool CHECKED>
+inline typename BasicMapView<CHECKED>::Iterator
+BasicMapView<CHECKED>::end() const
+{
+	return {first, map.elements};
+}
+
+template<bool CHECKED>
+inline typename BasicMapView<CHECKED>::Entry
+BasicMapView<CHECKED>::Iterator::operator*() const
+{
+	Reader value = key;
+	value.skip_next_value();
+	return {key, value};
+}
+
+template<bool CHECKED>
+inline typename BasicMapView<CHECKED>::Iterator &
+BasicMapView<CHECKED>::Iterator::operator++()
+{
+	key.skip_values(2);
+	++index;
+	return *this;
+}
+
+template<bool CHECKED>
+inline bool BasicMapView<CHECKED>::find(std::string_view key,
+										Reader &value) const
+{
+	return _find(key, value);
+}
+
+template<bool CHECKED>
+inline bool BasicMapView<CHECKED>::find(int64_t key, Reader &value) const
+{
+	return _find(key, value);
+}
+
+template<bool CHECKED>
+template<typename K>
+inline bool BasicMapView<CHECKED>::_find(K key, Reader &value) const
+{
+	if (map.width != 0) {
+		uint32_t low = 0;
+		uint32_t high = map.elements;
+		while (low < high) {
+			const uint32_t mid = low + (high - low) / 2;
+			Reader reader = first;
+			reader.seek_array_element(map, mid);
+			const int order = _compare_key(reader, key);
+			if (reader.get_errors() != ERROR_OK || order == KEY_TYPE_MISMATCH) {
+				[[unlikely]];
+				return false;
+			} else if (order < 0) {
+				low = mid + 1;
+			} else if (order > 0) {
+				high = mid;
+			} else {
+				value = reader;
+				return true;
+			}
+		}
+		return false;
+	}
+	Reader reader = first;
+	for (uint32_t i = 0; i < map.elements; ++i) {
+		const int order = _compare_key(reader, key);
+		if (reader.get_errors() != ERROR_OK) {
+			[[unlikely]];
+			return false;
+		} else if (order == 0) {
+			value = reader;
+			return true;
+		}
+		reader.skip_next_value();
+	}
+	return false;
+}
+
+template<bool CHECKED>
+inline int BasicMapView<CHECKED>::_compare_key(Reader &reader,
+											   std::string_view key)
+{
+	if (reader.is_next_string() == false) {
+		reader.skip_next_value();
+		return KEY_TYPE_MISMATCH;
+	}
+	std::string_view k;
+	reader.op(k);
+	// the same order as of sorted map, bytes are compared as unsigned
+	const int order = k.compare(key);
+	return order < 0 ? -1 : order > 0;
+}
+
+template<bool CHECKED>
+inline int BasicMapView<CHECKED>::_compare_key(Reader &reader, int64_t key)
+{
+	if (reader.is_next_integer() == false) {
+		reader.skip_next_value();
+		return KEY_TYPE_MISMATCH;
+	}
+	int64_t k = 0;
+	reader.op_int(k);
+	return (k > key) - (k < key);
+}
+} // namespace v2
+} // namespace bitscpp
+
+#endif
@@ -0,0 +1,23 @@
+// Copyright (C) 2026 Marek Zalewski aka Drwalin
+//
+// This file is part of bitscpp project under MIT License
+// You should have received a copy of the MIT License along with this program.
+
+#ifndef BITSCPP_SIMD_INL_HPP
+#define BITSCPP_SIMD_INL_HPP
+
+// BITSCPP_NO_SIMD disables use of SIMD intrinsics.
+#if !defined(BITSCPP_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64))
+#include <emmintrin.h>
+#define BITSCPP_SSE2 1
+#endif
+#if !defined(BITSCPP_NO_SIMD) && defined(__AVX2__)
+#include <immintrin.h>
+#define BITSCPP_AVX2 1
+#endif
+#if !defined(BITSCPP_NO_SIMD) && defined(__F16C__)
+#include <immintrin.h>
+#define BITSCPP_F16C 1
+#endif
+
+#endif
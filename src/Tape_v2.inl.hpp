@@ -0,0 +1,453 @@
+// Copyright (C) 2026 Marek Zalewski aka Drwalin
+//
+// This file is part of bitscpp project under MIT License
+// You should have received a copy of the MIT License along with this program.
+
+#ifndef BITSCPP_TAPE_V2_INL_HPP
+#define BITSCPP_TAPE_V2_INL_HPP
+
+#include <cstdint>
+
+#include <algorithm>
+#include <bit>
+#include <vector>
+
+#include "Validator_v2.inl.hpp"
+
+#include "../include/bitscpp/V2_Specification.hpp"
+#include "../include/bitscpp/ByteReader_v2.hpp"
+#include "../include/bitscpp/Tape_v2.hpp"
+
+/*
+ * Tape builder is the walk of validate() which additionally records entries.
+ * Runs of single byte values and of 12-bit integers are found with the same
+ * SIMD block classification as in validate() and are recorded in tight loops
+ * without classifying every header separately.
+ */
+
+namespace bitscpp
+{
+namespace v2
+{
+namespace impl
+{
+// Saved state of container enclosing the innermost one.
+struct TapeFrame {
+	// Values left in array or map (2 per map entry), 0 for objects.
+	uint32_t remaining;
+	// Offset after END_OBJECT of sized object, 0 for other frames.
+	uint32_t end;
+	// Tape index of container.
+	uint32_t container;
+	// Next slot of container in Tape::elements.
+	uint32_t slot;
+	// Offset at which element of indexed array has to end, 0 for other
+	// frames.
+	uint32_t expected;
+};
+} // namespace impl
+
+inline Errors Tape::build(const uint8_t *buffer, uint32_t size)
+{
+	clear();
+	if (buffer == nullptr) {
+		[[unlikely]];
+		return ERROR_BUFFER_NULLPTR;
+	}
+	// capacity of previous build is reused
+	entries.resize(entries.capacity());
+	const uint8_t *p = buffer;
+	const uint8_t *const end = buffer + size;
+	impl::FrameStack<impl::TapeFrame> stack;
+	// state of the innermost container, kept out of stack
+	uint32_t remaining = 0;
+	uint32_t objectEnd = 0;
+	uint32_t container = 0;
+	uint32_t slot = 0;
+	uint32_t expected = 0;
+	// impl::pending_values() of all frames on stack
+	uint64_t pending = 0;
+#ifdef BITSCPP_SSE2
+	// single byte values of block ending at singlesEnd
+	uint32_t singles = 0;
+	const uint8_t *singlesEnd = buffer;
+#endif
+	Errors error = ERROR_OK;
+	// entries are written by index into tape grown ahead, up to
+	// SINGLE_BYTE_BLOCK values are recorded in single step
+	constexpr uint32_t STEP_ENTRIES = 32;
+	uint32_t index = 0;
+	while (p < end) {
+		if (entries.size() - index < STEP_ENTRIES) {
+			entries.resize(std::max<size_t>(entries.size() * 2, 1024));
+		}
+		const uint8_t header = *p;
+		const uint32_t fixed = impl::fixedValueSizes[header];
+		if (fixed == 1) {
+			uint32_t run = 1;
+#ifdef BITSCPP_SSE2
+			if (end - p > 1 && impl::fixedValueSizes[p[1]] == 1) {
+				if (p >= singlesEnd &&
+					(uint32_t)(end - p) >= impl::SINGLE_BYTE_BLOCK) {
+					singles = impl::single_byte_mask(p);
+					singlesEnd = p + impl::SINGLE_BYTE_BLOCK;
+				}
+				if (p < singlesEnd) {
+					run = std::countr_one(
+						singles >> (impl::SINGLE_BYTE_BLOCK - (singlesEnd - p)));
+				}
+			}
+#endif
+			if (remaining) {
+				// last value of array is ended below, which closes it
+				run = std::min(run, remaining);
+				remaining -= run - 1;
+				for (uint32_t i = 0; i < run; ++i) {
+					elements[slot + i] = index + i;
+				}
+				slot += run;
+			}
+			const uint32_t offset = p - buffer;
+			TapeEntry *out = entries.data() + index;
+			for (uint32_t i = 0; i < run; ++i) {
+				out[i] = {offset + i, index + i + 1, 0, headerTranslation[p[i]]};
+			}
+			index += run;
+			p += run;
+		} else if (fixed == 2 && (remaining == 0 || remaining >= 8) &&
+				   end - p >= 16 && impl::is_12b_integer_block(p)) {
+			if (remaining) {
+				remaining -= 7;
+				for (uint32_t i = 0; i < 8; ++i) {
+					elements[slot + i] = index + i;
+				}
+				slot += 8;
+			}
+			const uint32_t offset = p - buffer;
+			TapeEntry *out = entries.data() + index;
+			for (uint32_t i = 0; i < 8; ++i) {
+				out[i] = {offset + i * 2, index + i + 1, 0, V2_INT};
+			}
+			index += 8;
+			p += 16;
+		} else if (fixed) {
+			if ((uint32_t)(end - p) < fixed) {
+				[[unlikely]];
+				error = ERROR_BUFFER_TOO_SMALL;
+				break;
+			}
+			if (remaining) {
+				elements[slot++] = index;
+			}
+			entries[index] = {(uint32_t)(p - buffer), index + 1, 0,
+							  headerTranslation[header]};
+			++index;
+			p += fixed;
+		} else {
+			const Type type = headerTranslation[header];
+			const uint32_t value = index;
+			if (type != V2_OBJECT_END) {
+				if (remaining) {
+					elements[slot++] = index;
+				}
+				entries[index] = {(uint32_t)(p - buffer), index + 1, 0, type};
+				++index;
+			}
+			++p;
+			switch (type) {
+			case V2_ARRAY:
+			case V2_MAP: {
+				uint32_t count = 0;
+				error = impl::walk_container_header(
+					p, end, header, pending + impl::pending_values(remaining),
+					count);
+				if (error) {
+					break;
+				}
+				const uint32_t first = elements.size();
+				entries[value].elements = first;
+				elements.resize(first + 1 + count);
+				elements[first] = type == V2_MAP ? count / 2 : count;
+				if (count == 0) {
+					break;
+				}
+				stack.push({remaining, objectEnd, container, slot, expected});
+				pending += impl::pending_values(remaining);
+				remaining = count;
+				objectEnd = 0;
+				container = value;
+				slot = first + 1;
+				expected = 0;
+				continue;
+			}
+			case V2_DETAIL_INDEXED_ARRAY:
+			case V2_DETAIL_SORTED_MAP: {
+				uint32_t count = 0;
+				uint32_t width = 0;
+				const uint8_t *table = nullptr;
+				error = impl::walk_offset_table(p, end, count, width, table);
+				if (error) {
+					break;
+				}
+				const uint32_t values = type == V2_DETAIL_SORTED_MAP ? 2 : 1;
+				const uint32_t first = elements.size();
+				entries[value].elements = first;
+				elements.resize(first + 1 + count * values);
+				elements[first] = count;
+				if (count == 0) {
+					break;
+				}
+				// elements are walked like in validate()
+				stack.push({remaining, objectEnd, container, slot, expected});
+				pending += impl::pending_values(remaining);
+				const uint32_t data = p - buffer;
+				for (uint32_t i = count - 1; i > 0; --i) {
+					stack.push({values + 1, 0, value, first + 1 + i * values,
+								data + (uint32_t)ReadBytesInNetworkOrder(
+										   table + i * width, width)});
+				}
+				pending += (uint64_t)(count - 1) * values;
+				remaining = values;
+				objectEnd = 0;
+				container = value;
+				slot = first + 1;
+				expected = data + ReadBytesInNetworkOrder(table, width);
+				continue;
+			}
+			case V2_OBJECT_BEGIN:
+				stack.push({remaining, objectEnd, container, slot, expected});
+				pending += impl::pending_values(remaining);
+				remaining = 0;
+				objectEnd = 0;
+				container = value;
+				expected = 0;
+				continue;
+			case V2_DETAIL_SIZED_OBJECT_BEGIN: {
+				uint32_t length = 0;
+				error = impl::walk_sized_object_header(p, end, length);
+				if (error) {
+					break;
+				}
+				stack.push({remaining, objectEnd, container, slot, expected});
+				pending += impl::pending_values(remaining);
+				remaining = 0;
+				objectEnd = (uint32_t)(p - buffer) + length;
+				container = value;
+				expected = 0;
+				continue;
+			}
+			case V2_OBJECT_END: {
+				if (stack.empty() || remaining != 0 ||
+					(objectEnd != 0 && objectEnd != (uint32_t)(p - buffer))) {
+					[[unlikely]];
+					error = ERROR_TYPE_MISMATCH;
+					break;
+				}
+				entries[container].next = index;
+				const impl::TapeFrame parent = stack.pop();
+				pending -= impl::pending_values(parent.remaining);
+				remaining = parent.remaining;
+				objectEnd = parent.end;
+				container = parent.container;
+				slot = parent.slot;
+				expected = parent.expected;
+			} break;
+			default:
+				error = impl::walk_sized_payload(p, end, type);
+				break;
+			}
+			if (error) {
+				[[unlikely]];
+				break;
+			}
+		}
+
+		// end of value closes completed arrays and maps, which in turn ends
+		// values in their parents
+		while (remaining && --remaining == 0) {
+			if (expected != 0 && expected != (uint32_t)(p - buffer)) {
+				[[unlikely]];
+				error = ERROR_TYPE_MISMATCH;
+				break;
+			}
+			entries[container].next = index;
+			const impl::TapeFrame parent = stack.pop();
+			pending -= impl::pending_values(parent.remaining);
+			remaining = parent.remaining;
+			objectEnd = parent.end;
+			container = parent.container;
+			slot = parent.slot;
+			expected = parent.expected;
+		}
+		if (error) {
+			[[unlikely]];
+			break;
+		}
+	}
+
+	if (error == ERROR_OK && stack.empty() == false) {
+		[[unlikely]];
+		error = ERROR_BUFFER_TOO_SMALL;
+	}
+	if (error) {
+		[[unlikely]];
+		clear();
+		return error;
+	}
+	entries.resize(index);
+	for (uint32_t i = 0; i < entries.size(); i = entries[i].next) {
+		roots.push_back(i);
+	}
+	this->buffer = buffer;
+	bufferSize = size;
+	return ERROR_OK;
+}
+
+inline void Tape::clear()
+{
+	entries.clear();
+	elements.clear();
+	roots.clear();
+	buffer = nullptr;
+	bufferSize = 0;
+}
+
+inline uint32_t Tape::size() const { return roots.size(); }
+
+inline TapeCursor Tape::root(uint32_t i) const
+{
+	if (i >= roots.size()) {
+		[[unlikely]];
+		return {};
+	}
+	return {this, roots[i], (uint32_t)entries.size()};
+}
+
+inline TapeCursor Tape::first() const
+{
+	return {this, 0, (uint32_t)entries.size()};
+}
+
+inline const uint8_t *Tape::get_buffer() const { return buffer; }
+inline uint32_t Tape::get_buffer_size() const { return bufferSize; }
+
+inline bool TapeCursor::is_valid() const
+{
+	return tape != nullptr && index < end;
+}
+
+inline Type TapeCursor::get_type() const
+{
+	return (Type)((uint8_t)get_detailed_type() & 0x1F);
+}
+
+inline Type TapeCursor::get_detailed_type() const
+{
+	if (is_valid() == false) {
+		[[unlikely]];
+		return V2_ERROR;
+	}
+	return tape->entries[index].type;
+}
+
+inline uint32_t TapeCursor::get_offset() const
+{
+	return is_valid() ? tape->entries[index].offset : 0;
+}
+
+inline uint32_t TapeCursor::get_tape_index() const { return index; }
+
+inline uint32_t TapeCursor::size() const
+{
+	const Type type = get_detailed_type();
+	if (type != V2_ARRAY && type != V2_DETAIL_INDEXED_ARRAY &&
+		type != V2_MAP && type != V2_DETAIL_SORTED_MAP) {
+		return 0;
+	}
+	return tape->elements[tape->entries[index].elements];
+}
+
+inline TapeCursor TapeCursor::element(uint32_t i) const
+{
+	const Type type = get_detailed_type();
+	if ((type != V2_ARRAY && type != V2_DETAIL_INDEXED_ARRAY) || i >= size()) {
+		[[unlikely]];
+		return {};
+	}
+	return child(tape->entries[index].elements + 1 + i);
+}
+
+inline TapeCursor TapeCursor::key(uint32_t i) const
+{
+	if (get_type() != V2_MAP || i >= size()) {
+		[[unlikely]];
+		return {};
+	}
+	return child(tape->entries[index].elements + 1 + i * 2);
+}
+
+inline TapeCursor TapeCursor::value(uint32_t i) const
+{
+	if (get_type() != V2_MAP || i >= size()) {
+		[[unlikely]];
+		return {};
+	}
+	return child(tape->entries[index].elements + 2 + i * 2);
+}
+
+inline TapeCursor TapeCursor::first_child() const
+{
+	// packed and bit arrays have no nested values
+	switch (get_detailed_type()) {
+	case V2_ARRAY:
+	case V2_DETAIL_INDEXED_ARRAY:
+	case V2_MAP:
+	case V2_DETAIL_SORTED_MAP:
+	case V2_OBJECT_BEGIN:
+	case V2_DETAIL_SIZED_OBJECT_BEGIN:
+		return {tape, index + 1, tape->entries[index].next};
+	default:
+		return {};
+	}
+}
+
+inline TapeCursor TapeCursor::field(uint32_t i) const
+{
+	if (get_type() != V2_OBJECT_BEGIN) {
+		[[unlikely]];
+		return {};
+	}
+	TapeCursor cursor = first_child();
+	for (; i > 0 && cursor.is_valid(); --i) {
+		cursor = cursor.next();
+	}
+	return cursor;
+}
+
+inline TapeCursor TapeCursor::next() const
+{
+	if (is_valid() == false) {
+		[[unlikely]];
+		return {};
+	}
+	return {tape, tape->entries[index].next, end};
+}
+
+inline ByteReader TapeCursor::reader() const
+{
+	if (is_valid() == false) {
+		[[unlikely]];
+		return {nullptr, 0};
+	}
+	return {tape->get_buffer(), tape->entries[index].offset,
+			tape->get_buffer_size()};
+}
+
+inline TapeCursor TapeCursor::child(uint32_t slot) const
+{
+	return {tape, tape->elements[slot], tape->entries[index].next};
+}
+} // namespace v2
+} // namespace bitscpp
+
+#endif
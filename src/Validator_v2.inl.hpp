@@ -0,0 +1,600 @@
+// Copyright (C) 2026 Marek Zalewski aka Drwalin
+//
+// This file is part of bitscpp project under MIT License
+// You should have received a copy of the MIT License along with this program.
+
+#ifndef BITSCPP_VALIDATOR_V2_INL_HPP
+#define BITSCPP_VALIDATOR_V2_INL_HPP
+
+#include <cstdint>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <vector>
+
+#include "IntegerArray_v2.inl.hpp"
+#include "Simd.inl.hpp"
+
+#include "../include/bitscpp/Endianness.hpp"
+#include "../include/bitscpp/V2_Specification.hpp"
+#include "../include/bitscpp/Validator_v2.hpp"
+
+/*
+ * Validator keeps explicit stack of open arrays, maps and objects instead of
+ * recursion, so that nesting depth of input is limited only by memory. First
+ * 32 levels are kept on the C++ stack. The same walk skips values in
+ * ByteReader::skip_values().
+ *
+ * Values of fixed size (numbers, booleans and short strings) are skipped
+ * using table of sizes built from headerTranslation. Other headers are
+ * classified by headerTranslation and checked one by one.
+ */
+
+namespace bitscpp
+{
+namespace v2
+{
+namespace impl
+{
+// Total encoded size of values with size known from header, 0 for others.
+consteval std::array<uint8_t, 256> make_fixed_value_sizes()
+{
+	std::array<uint8_t, 256> t{};
+	for (uint32_t h = 0; h < 256; ++h) {
+		switch (headerTranslation[h]) {
+		case V2_INT:
+			if (h <= END_IMMEDIATE_INTEGER) {
+				t[h] = 1;
+			} else if (h <= END_12B_INTEGER) {
+				t[h] = 2;
+			} else {
+				t[h] = h - BEG_SIZED_INTEGER + 3;
+			}
+			break;
+		case V2_BOOLEAN:
+			t[h] = 1;
+			break;
+		case V2_DETAIL_HALF:
+		case V2_DETAIL_BFLOAT:
+			t[h] = 3;
+			break;
+		case V2_FLOAT:
+			t[h] = 5;
+			break;
+		case V2_DETAIL_DOUBLE:
+			t[h] = 9;
+			break;
+		case V2_STRING:
+			if (h <= END_STRING_IMMEDIATE_SIZED) {
+				t[h] = h - BEG_STRING_IMMEDIATE_SIZED + 1;
+			}
+			break;
+		default:
+			break;
+		}
+	}
+	return t;
+}
+
+inline constexpr std::array<uint8_t, 256> fixedValueSizes =
+	make_fixed_value_sizes();
+
+#ifdef BITSCPP_AVX2
+inline constexpr uint32_t SINGLE_BYTE_BLOCK = 32;
+#elif defined(BITSCPP_SSE2)
+inline constexpr uint32_t SINGLE_BYTE_BLOCK = 16;
+#endif
+
+#ifdef BITSCPP_SSE2
+// Bit i is set when byte p[i] is single byte value (immediate integer,
+// boolean or empty string), p has to have SINGLE_BYTE_BLOCK readable bytes.
+inline uint32_t single_byte_mask(const uint8_t *p)
+{
+#ifdef BITSCPP_AVX2
+	const __m256i v = _mm256_loadu_si256((const __m256i *)p);
+	const __m256i imm = _mm256_cmpeq_epi8(
+		_mm256_min_epu8(v, _mm256_set1_epi8((char)END_IMMEDIATE_INTEGER)), v);
+	const __m256i b = _mm256_sub_epi8(v, _mm256_set1_epi8((char)BEG_BOOLEAN));
+	const __m256i boolean =
+		_mm256_cmpeq_epi8(_mm256_min_epu8(b, _mm256_set1_epi8(1)), b);
+	const __m256i empty = _mm256_cmpeq_epi8(
+		v, _mm256_set1_epi8((char)BEG_STRING_IMMEDIATE_SIZED));
+	return _mm256_movemask_epi8(
+		_mm256_or_si256(_mm256_or_si256(imm, boolean), empty));
+#else
+	const __m128i v = _mm_loadu_si128((const __m128i *)p);
+	const __m128i imm = _mm_cmpeq_epi8(
+		_mm_min_epu8(v, _mm_set1_epi8((char)END_IMMEDIATE_INTEGER)), v);
+	const __m128i b = _mm_sub_epi8(v, _mm_set1_epi8((char)BEG_BOOLEAN));
+	const __m128i boolean =
+		_mm_cmpeq_epi8(_mm_min_epu8(b, _mm_set1_epi8(1)), b);
+	const __m128i empty =
+		_mm_cmpeq_epi8(v, _mm_set1_epi8((char)BEG_STRING_IMMEDIATE_SIZED));
+	return (uint16_t)_mm_movemask_epi8(
+		_mm_or_si128(_mm_or_si128(imm, boolean), empty));
+#endif
+}
+#endif
+
+// True when 16 bytes at p are 8 12-bit integers.
+inline bool is_12b_integer_block(const uint8_t *p)
+{
+#ifdef BITSCPP_SSE2
+	const __m128i b = _mm_loadu_si128((const __m128i *)p);
+	return _mm_movemask_epi8(
+			   _mm_cmpeq_epi16(_mm_and_si128(b, _mm_set1_epi16(0xF0)),
+							   _mm_set1_epi16(BEG_12B_INTEGER))) == 0xFFFF;
+#else
+	// headers are at even bytes, which are lower bytes of 16-bit pairs
+	constexpr uint64_t mask = 0x00F000F000F000F0llu;
+	constexpr uint64_t headers = mask / 0xF0 * BEG_12B_INTEGER;
+	return (ReadBytesInNetworkOrder(p, 8) & mask) == headers &&
+		   (ReadBytesInNetworkOrder(p + 8, 8) & mask) == headers;
+#endif
+}
+
+// Reads VAR_UINT, returns nullptr when it does not fit before end.
+inline const uint8_t *validate_var_uint(const uint8_t *p, const uint8_t *end,
+										uint64_t &v)
+{
+	if (p >= end) {
+		[[unlikely]];
+		return nullptr;
+	}
+	const uint8_t header = *p;
+	const int32_t bytes = std::countl_one(header);
+	if (bytes == 0) {
+		v = header;
+		return p + 1;
+	}
+	if (end - p <= bytes) {
+		[[unlikely]];
+		return nullptr;
+	}
+	v = (ReadBytesInNetworkOrder(p + 1, bytes) << VAR_UINT_SHIFTS[bytes]) |
+		(header & VAR_UINT_MASKS[bytes]);
+	return p + 1 + bytes;
+}
+
+// Moves p after payload of string, packed array or bit array, which header
+// was at p - 1.
+inline Errors walk_sized_payload(const uint8_t *&p, const uint8_t *end,
+								 Type type)
+{
+	uint64_t count = 0;
+	switch (type) {
+	case V2_STRING:
+		p = validate_var_uint(p, end, count);
+		if (p == nullptr) {
+			[[unlikely]];
+			return ERROR_BUFFER_TOO_SMALL;
+		}
+		if (count > MAX_ARRAY_ELEMENTS - (IMMEDIATE_STRING_MAX_SIZE + 1)) {
+			[[unlikely]];
+			return ERROR_ARRAY_TOO_BIG;
+		}
+		count += IMMEDIATE_STRING_MAX_SIZE + 1;
+		break;
+	case V2_DETAIL_PACKED_ARRAY: {
+		if (p >= end) {
+			[[unlikely]];
+			return ERROR_BUFFER_TOO_SMALL;
+		}
+		const uint8_t packed = *p & ~PACKED_ARRAY_ALIGNED;
+		const bool aligned = *p & PACKED_ARRAY_ALIGNED;
+		if (is_valid_packed_array_type(packed) == false) {
+			[[unlikely]];
+			return ERROR_TYPE_MISMATCH;
+		}
+		p = validate_var_uint(p + 1, end, count);
+		if (p == nullptr) {
+			[[unlikely]];
+			return ERROR_BUFFER_TOO_SMALL;
+		}
+		if (count > MAX_ARRAY_ELEMENTS) {
+			[[unlikely]];
+			return ERROR_ARRAY_TOO_BIG;
+		}
+		count *= packed_array_element_size(packed);
+		if (aligned) {
+			if (p >= end) {
+				[[unlikely]];
+				return ERROR_BUFFER_TOO_SMALL;
+			}
+			if (*p > PACKED_ARRAY_MAX_PADDING) {
+				[[unlikely]];
+				return ERROR_TYPE_MISMATCH;
+			}
+			count += 1 + *p;
+		}
+	} break;
+	case V2_DETAIL_BIT_ARRAY:
+		p = validate_var_uint(p, end, count);
+		if (p == nullptr) {
+			[[unlikely]];
+			return ERROR_BUFFER_TOO_SMALL;
+		}
+		if (count > MAX_ARRAY_ELEMENTS) {
+			[[unlikely]];
+			return ERROR_ARRAY_TOO_BIG;
+		}
+		count = (count + 7) >> 3;
+		break;
+	default:
+		[[unlikely]];
+		return ERROR_TYPE_MISMATCH;
+	}
+	if (count > (uint64_t)(end - p)) {
+		[[unlikely]];
+		return ERROR_BUFFER_TOO_SMALL;
+	}
+	p += count;
+	return ERROR_OK;
+}
+
+// Values which container with given number of remaining values still
+// needs after its currently walked value.
+inline uint32_t pending_values(uint32_t remaining)
+{
+	return remaining ? remaining - 1 : 0;
+}
+
+// Reads number of values nested in array or map, which header was at p - 1.
+// Counts are 2 per map entry. Pending are values of enclosing containers
+// which follow this one, so that sum of counts claimed by nested containers
+// is bounded by size of buffer.
+inline Errors walk_container_header(const uint8_t *&p, const uint8_t *end,
+									uint8_t header, uint64_t pending,
+									uint32_t &count)
+{
+	if (header == BEG_MAP_EMPTY) {
+		count = 0;
+		return ERROR_OK;
+	} else if (header <= END_ARRAY_IMMEDIATE_SIZED &&
+			   header >= BEG_ARRAY_IMMEDIATE_SIZED) {
+		count = header - BEG_ARRAY_IMMEDIATE_SIZED;
+	} else {
+		uint64_t v = 0;
+		p = validate_var_uint(p, end, v);
+		if (p == nullptr) {
+			[[unlikely]];
+			return ERROR_BUFFER_TOO_SMALL;
+		}
+		const uint64_t offset =
+			header == BEG_MAP_SIZED ? 1 : IMMEDIATE_ARRAY_MAX_SIZE + 1;
+		if (v > MAX_ARRAY_ELEMENTS - offset) {
+			[[unlikely]];
+			return ERROR_ARRAY_TOO_BIG;
+		}
+		v += offset;
+		if (header == BEG_MAP_SIZED) {
+			v *= 2;
+		}
+		count = v;
+	}
+	// every value takes at least 1 byte
+	if (count + pending > (uint64_t)(end - p)) {
+		[[unlikely]];
+		return ERROR_BUFFER_TOO_SMALL;
+	}
+	return ERROR_OK;
+}
+
+// Reads length of sized object, which header was at p - 1.
+inline Errors walk_sized_object_header(const uint8_t *&p, const uint8_t *end,
+									   uint32_t &length)
+{
+	if ((uint32_t)(end - p) < SIZED_OBJECT_LENGTH_BYTES) {
+		[[unlikely]];
+		return ERROR_BUFFER_TOO_SMALL;
+	}
+	length = ReadBytesInNetworkOrder(p, SIZED_OBJECT_LENGTH_BYTES);
+	p += SIZED_OBJECT_LENGTH_BYTES;
+	if (length == 0 || length > (uint32_t)(end - p)) {
+		[[unlikely]];
+		return ERROR_BUFFER_TOO_SMALL;
+	}
+	return ERROR_OK;
+}
+
+// Reads count and offset table of indexed array or sorted map, which header
+// was at p - 1, and moves p to its first element. Entries have to be strictly
+// increasing and elements have to fit inside buffer.
+inline Errors walk_offset_table(const uint8_t *&p, const uint8_t *end,
+								uint32_t &count, uint32_t &width,
+								const uint8_t *&table)
+{
+	uint64_t v = 0;
+	p = validate_var_uint(p, end, v);
+	if (p == nullptr || p >= end) {
+		[[unlikely]];
+		return ERROR_BUFFER_TOO_SMALL;
+	}
+	if (v > MAX_ARRAY_ELEMENTS) {
+		[[unlikely]];
+		return ERROR_ARRAY_TOO_BIG;
+	}
+	if (is_valid_indexed_array_width(*p) == false) {
+		[[unlikely]];
+		return ERROR_TYPE_MISMATCH;
+	}
+	count = v;
+	width = *p;
+	++p;
+	if ((uint64_t)count * width > (uint64_t)(end - p)) {
+		[[unlikely]];
+		return ERROR_BUFFER_TOO_SMALL;
+	}
+	table = p;
+	p += count * width;
+	uint64_t previous = 0;
+	for (uint32_t i = 0; i < count; ++i) {
+		const uint64_t offset = ReadBytesInNetworkOrder(table + i * width, width);
+		if (offset <= previous) {
+			[[unlikely]];
+			return ERROR_TYPE_MISMATCH;
+		}
+		previous = offset;
+	}
+	if (previous > (uint64_t)(end - p)) {
+		[[unlikely]];
+		return ERROR_BUFFER_TOO_SMALL;
+	}
+	return ERROR_OK;
+}
+
+// Saved state of container enclosing the innermost one.
+struct ValidatorFrame {
+	// Values left in array or map (2 per map entry), 0 for objects.
+	uint32_t remaining;
+	// Offset after END_OBJECT of sized object, 0 for other frames.
+	uint32_t end;
+	// Offset at which element of indexed array has to end, 0 for other
+	// frames.
+	uint32_t expected;
+};
+
+// Stack of frames of open containers, first INLINE_FRAMES are not allocated.
+template<typename Frame>
+class FrameStack
+{
+public:
+	constexpr static uint32_t INLINE_FRAMES = 32;
+
+	inline bool empty() const { return depth == 0; }
+	inline void push(Frame frame)
+	{
+		if (depth == capacity) {
+			[[unlikely]];
+			if (frames == inlineFrames) {
+				spilled.assign(inlineFrames, inlineFrames + depth);
+			}
+			capacity *= 2;
+			spilled.resize(capacity);
+			frames = spilled.data();
+		}
+		frames[depth++] = frame;
+	}
+	inline Frame pop() { return frames[--depth]; }
+
+private:
+	Frame inlineFrames[INLINE_FRAMES];
+	std::vector<Frame> spilled;
+	Frame *frames = inlineFrames;
+	uint32_t capacity = INLINE_FRAMES;
+	uint32_t depth = 0;
+};
+
+// Walks values starting at cursor with all checks of validate(). When
+// COUNTED, stops after given number of top level values, otherwise walks all
+// values up to end. Cursor is moved after walked values only on success.
+template<bool COUNTED>
+inline Errors walk_values(const uint8_t *&cursor, const uint8_t *const end,
+						  uint32_t values)
+{
+	if constexpr (COUNTED) {
+		if (values == 0) {
+			return ERROR_OK;
+		}
+	}
+	const uint8_t *p = cursor;
+	// sized object lengths are checked as offsets from here
+	const uint8_t *const buffer = cursor;
+	FrameStack<ValidatorFrame> stack;
+	// state of the innermost container, kept out of stack, top level values
+	// are counted like elements of array
+	uint32_t remaining = COUNTED ? values : 0;
+	uint32_t objectEnd = 0;
+	uint32_t expected = 0;
+	// pending_values() of all frames on stack
+	uint64_t pending = 0;
+#ifdef BITSCPP_SSE2
+	// single byte values of block ending at singlesEnd
+	uint32_t singles = 0;
+	const uint8_t *singlesEnd = buffer;
+#endif
+	while (p < end) {
+		const uint8_t header = *p;
+		const uint32_t fixed = fixedValueSizes[header];
+		if (fixed == 1) {
+			uint32_t run = 1;
+#ifdef BITSCPP_SSE2
+			// single values between others take constant step, runs are
+			// measured with mask of block, which is reused inside of it
+			if (end - p > 1 && fixedValueSizes[p[1]] == 1) {
+				if (p >= singlesEnd &&
+					(uint32_t)(end - p) >= SINGLE_BYTE_BLOCK) {
+					singles = single_byte_mask(p);
+					singlesEnd = p + SINGLE_BYTE_BLOCK;
+				}
+				if (p < singlesEnd) {
+					run = std::countr_one(
+						singles >> (SINGLE_BYTE_BLOCK - (singlesEnd - p)));
+				}
+			}
+#endif
+			if (remaining) {
+				// last value of array is ended below, which closes it
+				run = std::min(run, remaining);
+				remaining -= run - 1;
+			}
+			p += run;
+		} else if (fixed == 2 && (remaining == 0 || remaining >= 8) &&
+				   end - p >= 16 && is_12b_integer_block(p)) {
+			// runs of 12-bit integers, like rows of small numbers, last one is
+			// ended below
+			if (remaining) {
+				remaining -= 7;
+			}
+			p += 16;
+		} else if (fixed) {
+			if ((uint32_t)(end - p) < fixed) {
+				[[unlikely]];
+				return ERROR_BUFFER_TOO_SMALL;
+			}
+			// constant steps are predicted together with branch, so that next
+			// header can be loaded before this one is classified
+			switch (fixed) {
+			case 2: p += 2; break;
+			case 3: p += 3; break;
+			case 4: p += 4; break;
+			case 5: p += 5; break;
+			case 6: p += 6; break;
+			case 7: p += 7; break;
+			case 8: p += 8; break;
+			case 9: p += 9; break;
+			default: p += fixed; break;
+			}
+		} else {
+			++p;
+			const Type type = headerTranslation[header];
+			Errors error = ERROR_OK;
+			switch (type) {
+			case V2_ARRAY:
+			case V2_MAP: {
+				uint32_t count = 0;
+				error = walk_container_header(
+					p, end, header, pending + pending_values(remaining), count);
+				if (error || count == 0) {
+					break;
+				}
+				stack.push({remaining, objectEnd, expected});
+				pending += pending_values(remaining);
+				remaining = count;
+				objectEnd = 0;
+				expected = 0;
+				continue;
+			}
+			case V2_DETAIL_INDEXED_ARRAY:
+			case V2_DETAIL_SORTED_MAP: {
+				uint32_t count = 0;
+				uint32_t width = 0;
+				const uint8_t *table = nullptr;
+				error = walk_offset_table(p, end, count, width, table);
+				if (error || count == 0) {
+					break;
+				}
+				// every element (map entry) is walked as array of 1 (2)
+				// values, which has to end at its offset, frames of following
+				// elements get 1 more value, as closing of previous element
+				// takes one
+				const uint32_t values = type == V2_DETAIL_SORTED_MAP ? 2 : 1;
+				stack.push({remaining, objectEnd, expected});
+				pending += pending_values(remaining);
+				const uint32_t data = p - buffer;
+				for (uint32_t i = count - 1; i > 0; --i) {
+					stack.push({values + 1, 0,
+								data + (uint32_t)ReadBytesInNetworkOrder(
+										   table + i * width, width)});
+				}
+				pending += (uint64_t)(count - 1) * values;
+				remaining = values;
+				objectEnd = 0;
+				expected = data + ReadBytesInNetworkOrder(table, width);
+				continue;
+			}
+			case V2_OBJECT_BEGIN:
+				stack.push({remaining, objectEnd, expected});
+				pending += pending_values(remaining);
+				remaining = 0;
+				objectEnd = 0;
+				expected = 0;
+				continue;
+			case V2_DETAIL_SIZED_OBJECT_BEGIN: {
+				uint32_t length = 0;
+				error = walk_sized_object_header(p, end, length);
+				if (error) {
+					break;
+				}
+				stack.push({remaining, objectEnd, expected});
+				pending += pending_values(remaining);
+				remaining = 0;
+				objectEnd = (uint32_t)(p - buffer) + length;
+				expected = 0;
+				continue;
+			}
+			case V2_OBJECT_END: {
+				if (stack.empty() || remaining != 0 ||
+					(objectEnd != 0 && objectEnd != (uint32_t)(p - buffer))) {
+					[[unlikely]];
+					return ERROR_TYPE_MISMATCH;
+				}
+				const ValidatorFrame parent = stack.pop();
+				pending -= pending_values(parent.remaining);
+				remaining = parent.remaining;
+				objectEnd = parent.end;
+				expected = parent.expected;
+			} break;
+			default:
+				error = walk_sized_payload(p, end, type);
+				break;
+			}
+			if (error) {
+				[[unlikely]];
+				return error;
+			}
+		}
+
+		// end of value closes completed arrays and maps, which in turn ends
+		// values in their parents
+		while (remaining && --remaining == 0) {
+			if (expected != 0 && expected != (uint32_t)(p - buffer)) {
+				[[unlikely]];
+				return ERROR_TYPE_MISMATCH;
+			}
+			if constexpr (COUNTED) {
+				if (stack.empty()) {
+					cursor = p;
+					return ERROR_OK;
+				}
+			}
+			const ValidatorFrame parent = stack.pop();
+			pending -= pending_values(parent.remaining);
+			remaining = parent.remaining;
+			objectEnd = parent.end;
+			expected = parent.expected;
+		}
+	}
+
+	if (stack.empty() == false || remaining) {
+		[[unlikely]];
+		return ERROR_BUFFER_TOO_SMALL;
+	}
+	cursor = p;
+	return ERROR_OK;
+}
+} // namespace impl
+
+inline Errors validate(const uint8_t *buffer, uint32_t size)
+{
+	if (buffer == nullptr) {
+		[[unlikely]];
+		return ERROR_BUFFER_NULLPTR;
+	}
+	return impl::walk_values<false>(buffer, buffer + size, 0);
+}
+} // namespace v2
+} // namespace bitscpp
+
+#endif
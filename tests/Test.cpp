@@ -1,11 +1,22 @@
 
 #include "../include/bitscpp/VectorWrapper.hpp" // IWYU pragma: keep
+#include "../include/bitscpp/CursorWrapper.hpp"
+#include "../include/bitscpp/FixedBufferWrapper.hpp"
+#include "../include/bitscpp/BufferPool.hpp"
+#include "../include/bitscpp/RawBufferWrapper.hpp"
+#include "../include/bitscpp/SegmentedBuffer.hpp"
+#include "../include/bitscpp/StreamBuffer.hpp"
 #include "../include/bitscpp/Endianness.hpp"
+#include "../include/bitscpp/HalfFloat.hpp"
+#include "../include/bitscpp/Validator_v2.hpp"
+#include "../include/bitscpp/Tape_v2.hpp"
+#include "../include/bitscpp/MapView_v2.hpp"
 #include "../include/bitscpp/ByteWriterExtensions.hpp" // IWYU pragma: keep
 #include "../include/bitscpp/ByteReaderExtensions.hpp" // IWYU pragma: keep
 #include "../src/ByteWriter_v2.inl.hpp"
 
 #include <iostream>
+#include <random>
 
 #include <cstdio>
 
@@ -431,6 +442,62 @@ int main() {
 }
 };
 
+// Values from one shared generator, for tests of writers and buffers.
+Test<bitscpp::v2::ByteReader, bitscpp::v2::ByteWriter<bitscpp::VectorWrapper>> &
+RandomGenerator() {
+	static Test<bitscpp::v2::ByteReader,
+				bitscpp::v2::ByteWriter<bitscpp::VectorWrapper>> t;
+	return t;
+}
+
+template<typename T>
+T RandomValue() {
+	T v;
+	RandomGenerator().Random(v);
+	return v;
+}
+
+// Value, blob and the same value again, written by most writer tests.
+template<typename Writer, typename T, typename Blob>
+void WriteWithBlob(Writer &writer, const T &value, const Blob &blob) {
+	writer.op(value);
+	writer.op(blob);
+	writer.op(value);
+}
+
+template<typename T, typename Blob>
+bitscpp::VectorWrapper ExpectedWithBlob(const T &value, const Blob &blob) {
+	bitscpp::VectorWrapper expected;
+	{
+		bitscpp::v2::ByteWriter writer(&expected);
+		WriteWithBlob(writer, value, blob);
+	}
+	return expected;
+}
+
+// Whether first value in buffer is read back equal to value.
+template<typename T>
+bool ReadsBack(const uint8_t *data, size_t size, const T &value) {
+	T v;
+	bitscpp::v2::ByteReader reader(data, size);
+	reader.op(v);
+	return reader.is_valid() && v == value;
+}
+
+void Report(const char *name, int i, bool success) {
+	printf(" %s: %i -> %s\n", name, i, success ? "true" : "false");
+	if (!success) {
+		totalErrors++;
+	}
+}
+
+void Report(const char *name, bool success) {
+	printf(" %s -> %s\n", name, success ? "true" : "false");
+	if (!success) {
+		totalErrors++;
+	}
+}
+
 void TestNetworkOrder() {
 	auto t = [](const uint64_t value) {
 		constexpr uint64_t sizes[9] = {0x0lu, 0xFFlu, 0xFFFFlu, 0xFFFFFFlu, 0xFFFFFFFFlu, 0xFFFFFFFFFFlu, 0xFFFFFFFFFFFFlu, 0xFFFFFFFFFFFFFFlu, 0xFFFFFFFFFFFFFFFFlu};
@@ -459,14 +526,2302 @@ void TestNetworkOrder() {
 	t(0x8070605040302010);
 }
 
+void TestCursorWriter() {
+	for (int i = 0; i < 16; ++i) {
+		const Struct s1 = RandomValue<Struct>();
+		const std::string blob(5000 + i, 'x');
+		bitscpp::VectorWrapper expected = ExpectedWithBlob(s1, blob);
+
+		bitscpp::VectorWrapper buffer;
+		bitscpp::CursorWrapper cursor(&buffer);
+		bitscpp::v2::ByteWriter writer(&cursor);
+		WriteWithBlob(writer, s1, blob);
+		const uint32_t size = writer.GetSize();
+		writer.Commit();
+
+		Report("cursor writer", i,
+			   size == buffer.size() && buffer.vector == expected.vector &&
+				   ReadsBack(buffer.data(), buffer.size(), s1));
+	}
+
+	// window of small message in reused buffer does not span its capacity
+	bitscpp::VectorWrapper reused;
+	reused.reserve_exact(1 << 20);
+	bool success = true;
+	for (int i = 0; i < 4; ++i) {
+		reused.clear();
+		bitscpp::CursorWrapper cursor(&reused);
+		bitscpp::v2::ByteWriter writer(&cursor);
+		writer.op(i);
+		success &= reused.size() <= cursor.MIN_WINDOW;
+		writer.Commit();
+		int value = 0;
+		bitscpp::v2::ByteReader(reused.data(), reused.size()).op(value);
+		success &= reused.size() == 1 && value == i &&
+				   reused.capacity() == 1 << 20;
+	}
+	Report("cursor writer: reused buffer", success);
+}
+
+void TestRawBufferWriter() {
+	for (int i = 0; i < 16; ++i) {
+		const Struct s1 = RandomValue<Struct>();
+		const std::string blob(100 << i, 'x');
+		bitscpp::VectorWrapper expected = ExpectedWithBlob(s1, blob);
+
+		bitscpp::RawBufferWrapper buffer;
+		{
+			bitscpp::v2::ByteWriter writer(&buffer);
+			WriteWithBlob(writer, s1, blob);
+		}
+		bitscpp::RawBufferWrapper cursorBuffer;
+		bitscpp::CursorWrapper cursor(&cursorBuffer);
+		{
+			bitscpp::v2::ByteWriter writer(&cursor);
+			WriteWithBlob(writer, s1, blob);
+			writer.Commit();
+		}
+
+		Report("raw buffer writer", i,
+			   buffer.size() == expected.size() &&
+				   cursorBuffer.size() == expected.size() &&
+				   memcmp(buffer.data(), expected.data(), expected.size()) == 0 &&
+				   memcmp(cursorBuffer.data(), expected.data(),
+						  expected.size()) == 0 &&
+				   ReadsBack(buffer.data(), buffer.size(), s1));
+	}
+}
+
+void TestSegmentedBufferWriter() {
+	bitscpp::SegmentedBuffer reused(256);
+	for (int i = 0; i < 16; ++i) {
+		std::vector<Struct> s1(i + 1);
+		for (Struct &s : s1) {
+			s = RandomValue<Struct>();
+		}
+		const std::string blob(10 << i, 'x');
+		bitscpp::VectorWrapper expected = ExpectedWithBlob(s1, blob);
+
+		bitscpp::SegmentedBuffer buffer(64 << (i & 7));
+		reused.clear();
+		bool success = true;
+		for (bitscpp::SegmentedBuffer *b : {&buffer, &reused}) {
+			{
+				bitscpp::v2::ByteWriter writer(b);
+				WriteWithBlob(writer, s1, blob);
+				writer.Commit();
+				success &= writer.GetSize() == expected.size();
+			}
+			std::vector<uint8_t> flat = b->flatten();
+			size_t segments = 0;
+			b->for_each_segment([&](const uint8_t *, size_t) { ++segments; });
+			success &= segments == b->segment_count();
+			size_t iovBytes = 0;
+#ifdef BITSCPP_HAS_IOVEC
+			std::vector<iovec> iov;
+			size_t position = 0;
+			success &= b->export_iovec(iov, position) == b->segment_count() &&
+					   iov.size() == b->segment_count() &&
+					   b->export_iovec(iov, position) == 0;
+			for (const iovec &v : iov) {
+				iovBytes += v.iov_len;
+			}
+			// batches cover the same segments
+			std::vector<iovec> batch;
+			position = 0;
+			for (size_t exported = 0;
+				 (exported = b->export_iovec(batch, position, 3)) != 0;) {
+				success &= exported == 3 || batch.size() == iov.size();
+			}
+			success &= batch.size() == iov.size() &&
+					   std::equal(batch.begin(), batch.end(), iov.begin(),
+								  [](const iovec &a, const iovec &b) {
+									  return a.iov_base == b.iov_base &&
+											 a.iov_len == b.iov_len;
+								  });
+#else
+			iovBytes = b->size();
+#endif
+			success &= flat == expected.vector && iovBytes == expected.size() &&
+					   ReadsBack(flat.data(), flat.size(), s1);
+		}
+		Report("segmented buffer writer", i, success);
+	}
+
+#if defined(BITSCPP_HAS_IOVEC) && defined(BITSCPP_HAS_UNISTD)
+	// more references than writev() accepts in single call
+	std::vector<uint8_t> bytes(3000);
+	for (size_t i = 0; i < bytes.size(); ++i) {
+		bytes[i] = i * 7;
+	}
+	bitscpp::SegmentedBuffer buffer(64, 1);
+	for (size_t i = 0; i < bytes.size(); i += 2) {
+		buffer.write_reference(bytes.data() + i, 2);
+	}
+	FILE *file = tmpfile();
+	bool success = buffer.segment_count() == bytes.size() / 2 &&
+				   buffer.segment_count() > buffer.MAX_IOVEC;
+	std::vector<iovec> iov;
+	for (size_t pos = 0; buffer.export_iovec(iov, pos) != 0; iov.clear()) {
+		success &= iov.size() <= buffer.MAX_IOVEC &&
+				   writev(fileno(file), iov.data(), iov.size()) > 0;
+	}
+	std::vector<uint8_t> fileData(bytes.size() + 1);
+	rewind(file);
+	fileData.resize(fread(fileData.data(), 1, fileData.size(), file));
+	fclose(file);
+	success &= fileData == bytes;
+	Report("segmented buffer writer: writev batches", success);
+#endif
+}
+
+void TestByteArrayReference() {
+	for (int i = 0; i < 16; ++i) {
+		const Struct s1 = RandomValue<Struct>();
+		std::vector<uint8_t> blob(100 << i);
+		for (uint8_t &b : blob) {
+			b = RandomValue<uint8_t>();
+		}
+
+		bitscpp::VectorWrapper expected;
+		{
+			bitscpp::v2::ByteWriter writer(&expected);
+			writer.op(s1);
+			writer.op_byte_array(blob);
+			writer.op_byte_array(blob);
+			writer.op(s1);
+		}
+
+		bitscpp::VectorWrapper copied;
+		bitscpp::SegmentedBuffer buffer(1024, 1000);
+		auto write = [&](auto &writer) {
+			writer.op(s1);
+			writer.op_byte_array_ref(blob.data(), blob.size());
+			writer.op_byte_array_ref(blob.data(), blob.size());
+			writer.op(s1);
+			writer.Commit();
+		};
+		{
+			bitscpp::v2::ByteWriter writer(&copied);
+			write(writer);
+			bitscpp::v2::ByteWriter writer2(&buffer);
+			write(writer2);
+		}
+		bool success = copied.vector == expected.vector &&
+					   buffer.flatten() == expected.vector;
+		size_t references = 0;
+		buffer.for_each_segment([&](const uint8_t *data, size_t bytes) {
+			references += data == blob.data() && bytes == blob.size();
+		});
+		success &= references == (blob.size() >= 1000 ? 2 : 0);
+		success &= ReadsBack(copied.data(), copied.size(), s1);
+		Report("byte array reference", i, success);
+	}
+}
+
+void TestStreamBufferWriter() {
+	for (int i = 0; i < 16; ++i) {
+		std::vector<Struct> s1(i * 3 + 1);
+		for (Struct &s : s1) {
+			s = RandomValue<Struct>();
+		}
+		const std::string blob(37 << i, 'x');
+		bitscpp::VectorWrapper expected = ExpectedWithBlob(s1, blob);
+
+		// sink fails after 2000 bytes
+		const bool fail = (i & 1) && expected.size() > 4000;
+		std::vector<uint8_t> output;
+		bitscpp::StreamBuffer stream(
+			[&](const uint8_t *data, size_t bytes) {
+				output.insert(output.end(), data, data + bytes);
+				return !fail || output.size() < 2000;
+			},
+			64 + i * 32);
+		bitscpp::v2::ByteWriter writer(&stream);
+		WriteWithBlob(writer, s1, blob);
+		writer.Commit();
+		const bool flushed = stream.flush();
+
+		bool success;
+		if (fail == false) {
+			success = flushed && output == expected.vector &&
+					  stream.size() == expected.size() &&
+					  writer.get_errors() == bitscpp::v2::ERROR_OK &&
+					  ReadsBack(output.data(), output.size(), s1);
+		} else {
+			// failure of last flush() is not seen by writer
+			// bytes of failed sink call are not counted
+			success = !flushed && stream.failed() &&
+					  stream.flushed_size() < output.size() &&
+					  (writer.get_errors() == bitscpp::v2::ERROR_BUFFER_TOO_SMALL ||
+					   i < 7);
+		}
+
+#ifdef BITSCPP_HAS_UNISTD
+		FILE *file = tmpfile();
+		{
+			bitscpp::StreamBuffer fileStream(
+				bitscpp::StreamBuffer::FileDescriptorSink(fileno(file)), 256);
+			bitscpp::v2::ByteWriter writer(&fileStream);
+			WriteWithBlob(writer, s1, blob);
+			writer.Commit();
+			success &= fileStream.flush();
+		}
+		std::vector<uint8_t> fileData(expected.size() + 1);
+		rewind(file);
+		fileData.resize(fread(fileData.data(), 1, fileData.size(), file));
+		fclose(file);
+		success &= fileData == expected.vector;
+#endif
+
+		Report("stream buffer writer", i, success);
+	}
+
+	// staging buffer does not grow with size of arrays and bounded items
+	std::vector<int64_t> ints(1 << 20, INT64_MIN);
+	std::vector<double> doubles(1 << 14, -0.1);
+	std::vector<std::string> strings(1 << 12, std::string(20, 's'));
+	bitscpp::VectorWrapper expected;
+	{
+		bitscpp::v2::ByteWriter writer(&expected);
+		writer.op(ints);
+		writer.op(doubles);
+		writer.op_bounded(strings);
+		writer.op_exact(strings);
+	}
+	std::vector<uint8_t> output;
+	size_t maxChunk = 0;
+	bitscpp::StreamBuffer stream(
+		[&](const uint8_t *data, size_t bytes) {
+			output.insert(output.end(), data, data + bytes);
+			maxChunk = std::max(maxChunk, bytes);
+			return true;
+		},
+		4096);
+	bitscpp::v2::ByteWriter writer(&stream);
+	writer.op(ints);
+	writer.op(doubles);
+	writer.op_bounded(strings);
+	writer.op_exact(strings);
+	writer.Commit();
+	const bool success =
+		stream.flush() && output == expected.vector &&
+		maxChunk <= 4096 + writer.UNLIMITED_SIZE_MAX_BOUND;
+	Report("stream buffer writer: big arrays", success);
+}
+
+void TestFixedBufferWriter() {
+	for (int i = 0; i < 16; ++i) {
+		const Struct s1 = RandomValue<Struct>();
+		const std::string blob((i & 1) ? 5000 : 50, 'x');
+
+		bitscpp::VectorWrapper expected;
+		{
+			bitscpp::v2::ByteWriter writer(&expected);
+			writer.op(s1);
+			writer.op(blob);
+		}
+
+		// fits exactly, too small by one byte and too small with spilling
+		uint8_t memory[8192];
+		const size_t capacities[3] = {expected.size(), expected.size() - 1,
+									  (size_t)i};
+		bool success = true;
+		for (int j = 0; j < 3; ++j) {
+			bitscpp::FixedBufferWrapper buffer(
+				std::span<uint8_t>(memory, capacities[j]), j == 2);
+			bitscpp::v2::ByteWriter writer(&buffer);
+			writer.op(s1);
+			writer.op(blob);
+			writer.Commit();
+			if (j == 1) {
+				success &= writer.get_errors() == bitscpp::v2::ERROR_BUFFER_TOO_SMALL;
+				success &= buffer.size() <= capacities[j];
+				continue;
+			}
+			success &= writer.get_errors() == bitscpp::v2::ERROR_OK &&
+					   ReadsBack(buffer.data(), buffer.size(), s1);
+			success &= buffer.size() == expected.size() &&
+					   memcmp(buffer.data(), expected.data(), expected.size()) == 0;
+			success &= buffer.spilled == (j == 2);
+		}
+		Report("fixed buffer writer", i, success);
+	}
+}
+
+struct Telemetry {
+	uint64_t timestamp = 0;
+	int32_t x = 0, y = 0, z = 0;
+	float speed = 0;
+	double heading = 0;
+	uint16_t flags = 0;
+	bool active = false;
+
+	constexpr static bool FIXED_ENCODED_SIZE = true;
+
+	bool operator==(const Telemetry &) const = default;
+
+	BITSCPP_DEFINE_INLINE_SERIALIZE_METHOD(s, {
+		s.op(timestamp);
+		s.op(x);
+		s.op(y);
+		s.op(z);
+		s.op(speed);
+		s.op(heading);
+		s.op(flags);
+		s.op(active);
+	});
+};
+
+static_assert(bitscpp::v2::max_encoded_size_v<int8_t> == 2);
+static_assert(bitscpp::v2::max_encoded_size_v<uint16_t> == 4);
+static_assert(bitscpp::v2::max_encoded_size_v<int32_t> == 5);
+static_assert(bitscpp::v2::max_encoded_size_v<uint32_t> == 6);
+static_assert(bitscpp::v2::max_encoded_size_v<double> == 9);
+static_assert(bitscpp::v2::max_encoded_size_v<Telemetry> == 9 + 5 * 3 + 5 + 9 + 4 + 1);
+static_assert(!bitscpp::v2::FixedEncodedSize<std::string>);
+static_assert(!bitscpp::v2::FixedEncodedSize<std::vector<int>>);
+static_assert(!bitscpp::v2::FixedEncodedSize<Struct>);
+
+// serialize() is constexpr, but number of fields depends on value
+struct CountedValues {
+	uint8_t n = 0;
+	int64_t v[8] = {};
+
+	BITSCPP_DEFINE_INLINE_SERIALIZE_METHOD(s, {
+		s.op(n);
+		for (int i = 0; i < n; ++i) {
+			s.op(v[i]);
+		}
+	});
+};
+
+static_assert(!bitscpp::v2::FixedEncodedSize<CountedValues>);
+
+void TestBoundedWriter() {
+	for (int i = 0; i < 16; ++i) {
+		Telemetry tm;
+		tm.timestamp = RandomValue<uint64_t>();
+		tm.x = RandomValue<int32_t>();
+		tm.y = RandomValue<int32_t>();
+		tm.z = -i;
+		tm.speed = i * 0.25f;
+		tm.heading = i * -3.5;
+		tm.flags = RandomValue<uint16_t>();
+		tm.active = i & 1;
+		std::vector<Telemetry> tms(i * 7, tm);
+		const Struct s1 = RandomValue<Struct>();
+
+		bitscpp::VectorWrapper expected;
+		{
+			bitscpp::v2::ByteWriter writer(&expected);
+			tm.serialize(writer);
+			writer.op_array_header(tms.size());
+			for (const Telemetry &e : tms) {
+				e.serialize(writer);
+			}
+			s1.serialize(writer);
+		}
+
+		bitscpp::VectorWrapper buffer;
+		{
+			bitscpp::v2::ByteWriter writer(&buffer);
+			writer.op(tm);
+			writer.op(tms);
+			writer.op_bounded(s1);
+		}
+
+		bitscpp::VectorWrapper cursorBuffer;
+		bitscpp::CursorWrapper cursor(&cursorBuffer);
+		{
+			bitscpp::v2::ByteWriter writer(&cursor);
+			writer.op_bounded(tm);
+			writer.op_bounded(tms);
+			writer.op_bounded(s1);
+			writer.Commit();
+		}
+
+		// bounds do not fit into exactly sized fixed buffer
+		std::vector<uint8_t> memory(expected.size());
+		bitscpp::FixedBufferWrapper fixed(memory);
+		{
+			bitscpp::v2::ByteWriter writer(&fixed);
+			writer.op(tm);
+			writer.op(tms);
+			writer.op_bounded(s1);
+			writer.Commit();
+		}
+
+		Telemetry tm2;
+		std::vector<Telemetry> tms2;
+		Struct s2;
+		bitscpp::v2::ByteReader reader(buffer.data(), buffer.size());
+		reader.op(tm2);
+		reader.op(tms2);
+		reader.op(s2);
+		CountedValues counted;
+		counted.n = i % 9;
+		for (int64_t &v : counted.v) {
+			v = INT64_MIN;
+		}
+		bitscpp::VectorWrapper countedBuffer;
+		bitscpp::v2::ByteWriter(&countedBuffer).op(counted);
+		CountedValues counted2;
+		bitscpp::v2::ByteReader countedReader(countedBuffer.data(),
+											  countedBuffer.size());
+		counted2.serialize(countedReader);
+
+		const bool success = countedReader.is_valid() &&
+							 counted2.n == counted.n &&
+							 std::equal(counted.v, counted.v + counted.n,
+										counted2.v) &&
+							 buffer.vector == expected.vector &&
+							 cursorBuffer.vector == expected.vector &&
+							 memory == expected.vector &&
+							 fixed.size() == memory.size() &&
+							 reader.is_valid() && !reader.has_any_more() &&
+							 tm == tm2 && tms == tms2 && s1 == s2;
+		Report("bounded writer", i, success);
+	}
+}
+
+void TestVarUintLength() {
+	// Values of bit width w need (w + 6) / 7 bytes, at most 9. Widths being
+	// multiple of 7 are the edges where one more byte was selected before.
+	uint64_t errors = 0;
+	for (uint32_t w = 0; w <= 64; ++w) {
+		const uint64_t last = w == 64 ? ~0llu : (1llu << w) - 1;
+		const uint64_t values[2] = {w == 0 ? 0 : (1llu << (w - 1)), last};
+		const size_t bytes = w > 56 ? 9 : w <= 7 ? 1 : (w + 6) / 7;
+		for (uint64_t v : values) {
+			// fixed buffer of exact size writes through byte count table,
+			// reserved vector through wide store
+			uint8_t memory[16];
+			bitscpp::FixedBufferWrapper fixed(std::span<uint8_t>(memory, bytes),
+											  false);
+			bitscpp::VectorWrapper vector;
+			vector.reserve(64);
+			{
+				bitscpp::v2::ByteWriter writer(&fixed);
+				writer.op_untyped_var_uint(v);
+				writer.Commit();
+				if (writer.get_errors() != bitscpp::v2::ERROR_OK) {
+					errors++;
+				}
+			}
+			{
+				bitscpp::v2::ByteWriter writer(&vector);
+				writer.op_untyped_var_uint(v);
+			}
+			bitscpp::v2::SizeCounter counter;
+			counter.op_untyped_var_uint(v);
+
+			uint64_t v2 = 0;
+			bitscpp::v2::ByteReader reader(memory, bytes);
+			reader.op_untyped_var_uint(v2);
+			if (fixed.size() != bytes || vector.size() != bytes ||
+				counter.size != bytes || v2 != v || !reader.is_valid() ||
+				reader.get_offset() != bytes || memcmp(memory, vector.data(), bytes) != 0) {
+				errors++;
+			}
+		}
+	}
+
+	printf(" var uint length errors: %lu\n", errors);
+	totalErrors += errors;
+}
+
+void TestSizeCounter() {
+	uint64_t errors = 0;
+	auto check = [&](auto &&write) {
+		bitscpp::VectorWrapper buffer;
+		bitscpp::v2::ByteWriter writer(&buffer);
+		bitscpp::v2::SizeCounter counter;
+		write(writer);
+		write(counter);
+		if (counter.size != buffer.size()) {
+			errors++;
+		}
+	};
+
+	for (int i = 0; i < 16; ++i) {
+		const Struct s1 = RandomValue<Struct>();
+		check([&](auto &s) { s.op(s1); });
+
+		bitscpp::VectorWrapper buffer;
+		bitscpp::v2::ByteWriter writer(&buffer);
+		writer.op_exact(s1);
+		if (buffer.size() != bitscpp::v2::encoded_size(s1) ||
+			buffer.capacity() != buffer.size()) {
+			errors++;
+		}
+	}
+	for (uint32_t i = 0; i < 300; ++i) {
+		check([&](auto &s) { s.op(std::string(i, 'a')); });
+		check([&](auto &s) { s.op_array_header(i * i * i); });
+		check([&](auto &s) { s.op_map_header(i * i * i); });
+	}
+	for (int bits = 0; bits < 64; ++bits) {
+		for (int64_t d = -2; d <= 2; ++d) {
+			const uint64_t v = (1llu << bits) + d;
+			check([&](auto &s) { s.op_int(v); });
+			check([&](auto &s) { s.op_int((int64_t)(0 - v)); });
+			check([&](auto &s) { s.op_untyped_var_uint(v); });
+			check([&](auto &s) { s.op_untyped_var_int((int64_t)(0 - v)); });
+		}
+	}
+	{
+		std::vector<std::set<int>> vs = {{13,123},{12345}, {}, {-1000000}};
+		check([&](auto &s) { s.op(vs); });
+	}
+
+	printf(" size counter errors: %lu\n", errors);
+	totalErrors += errors;
+}
+
+void TestBufferPool() {
+	bitscpp::BufferPool pool({1024, 64 * 1024, 2});
+	bool success = true;
+	{
+		bitscpp::BufferPool::Lease a = pool.Acquire();
+		bitscpp::v2::ByteWriter writer(a.get());
+		writer.op(std::string(100, 'x'));
+		success &= a->size() > 100 && a->capacity() >= 1024;
+	}
+	success &= pool.FreeBuffers() == 1 && pool.GetStats().misses == 1;
+	{
+		bitscpp::BufferPool::Lease a = pool.Acquire();
+		success &= a->size() == 0 && a->capacity() >= 1024;
+		success &= pool.GetStats().hits == 1 && pool.FreeBuffers() == 0;
+		a->resize(1024 * 1024);
+		a.Release();
+		success &= pool.GetStats().trimmed == 1 && pool.FreeBuffers() == 1;
+		bitscpp::BufferPool::Lease b = pool.Acquire();
+		success &= b->capacity() <= 64 * 1024;
+		bitscpp::BufferPool::Lease c = pool.Acquire();
+		bitscpp::BufferPool::Lease d = std::move(c);
+		bitscpp::BufferPool::Lease e = pool.Acquire();
+	}
+	const bitscpp::BufferPool::Stats &stats = pool.GetStats();
+	success &= pool.FreeBuffers() == 2 && stats.dropped == 1 &&
+			   stats.misses == 3 && stats.hits == 2;
+	success &= stats.bytesRetained >= 1024 * 2 &&
+			   stats.bytesRetained <= 64 * 1024 * 2;
+	pool.Clear();
+	success &= pool.FreeBuffers() == 0 && stats.bytesRetained == 0;
+	success &= &bitscpp::BufferPool::ThreadLocal() ==
+			   &bitscpp::BufferPool::ThreadLocal();
+
+	printf(" buffer pool: %s\n", success ? "true" : "false");
+	if (!success) {
+		totalErrors++;
+	}
+}
+
+struct SizedObject {
+	Telemetry telemetry;
+	std::string name;
+	std::vector<int32_t> values;
+	// present only in newer version
+	bool extended = false;
+	std::vector<Telemetry> extra;
+
+	bool operator==(const SizedObject &) const = default;
+
+	BITSCPP_DEFINE_INLINE_SERIALIZE_METHOD(s, {
+		uint32_t object;
+		s.op_begin_sized_object(object);
+		s.op(telemetry);
+		s.op(name);
+		s.op(values);
+		if (extended) {
+			s.op(extra);
+		}
+		s.op_end_sized_object(object);
+	});
+};
+
+void TestSizedObject() {
+	for (int i = 0; i < 16; ++i) {
+		SizedObject o1, o2;
+		o1.telemetry.timestamp = RandomValue<uint64_t>();
+		o1.telemetry.x = RandomValue<int32_t>();
+		o1.name = std::string(i * 11, 'n');
+		o1.values.resize(i * i * 7, -i);
+		o1.extended = i & 1;
+		o1.extra.resize(i * 3, o1.telemetry);
+		o2.extended = false;
+
+		auto write = [&](auto &writer) {
+			writer.op(o1);
+			if constexpr (requires { writer.op_bounded(o1); }) {
+				writer.op_bounded(o1);
+			} else {
+				writer.op(o1);
+			}
+			writer.op_begin_object();
+			writer.op(i);
+			writer.op_end_object();
+			writer.op(o1);
+			writer.op(i);
+		};
+		bitscpp::VectorWrapper buffer;
+		{
+			bitscpp::v2::ByteWriter writer(&buffer);
+			write(writer);
+		}
+		bitscpp::VectorWrapper cursorBuffer;
+		bitscpp::CursorWrapper cursor(&cursorBuffer);
+		{
+			bitscpp::v2::ByteWriter writer(&cursor);
+			write(writer);
+			writer.Commit();
+		}
+		bitscpp::v2::SizeCounter counter;
+		write(counter);
+
+		int32_t i2 = -1;
+		bitscpp::v2::ByteReader reader(buffer.data(), buffer.size());
+		bool success = cursorBuffer.vector == buffer.vector &&
+					   counter.size == buffer.size();
+		success &= reader.is_next_sized_object() && reader.is_next_beg_object();
+		reader.op(o2);
+		success &= o2.telemetry == o1.telemetry && o2.name == o1.name &&
+				   o2.values == o1.values;
+		// o2 does not read extra, which is skipped by op_end_sized_object()
+		success &= reader.is_valid();
+		reader.skip_object();
+		success &= reader.is_valid() && reader.is_next_beg_object() &&
+				   reader.is_next_sized_object() == false;
+		// object without size cannot be skipped
+		bitscpp::v2::ByteReader tmp = reader;
+		tmp.skip_object();
+		success &= tmp.get_errors() == bitscpp::v2::ERROR_TYPE_MISMATCH;
+		reader.op_begin_object().op(i2).op_end_object();
+		success &= i2 == i;
+		reader.skip_object();
+		reader.op(i2);
+		success &= reader.is_valid() && !reader.has_any_more() && i2 == i;
+
+		Report("sized object", i, success);
+	}
+}
+
+template<typename T>
+uint64_t TestIntegerArrayType(std::mt19937_64 &rng) {
+	uint64_t errors = 0;
+	const int64_t boundaries[] = {-2049, -2048, -33, -32, -31, -30, 0, 1,
+								  127, 128, 129, 159, 160, 2047, 2048};
+	for (int i = 0; i < 200; ++i) {
+		std::vector<T> values(rng() % (i < 100 ? 80 : 3000));
+		const int mode = rng() % 4;
+		for (T &v : values) {
+			switch (mode) {
+			case 0: // immediate integers only
+				v = (T)(int64_t)(rng() % 160 - 31);
+				break;
+			case 1:
+				v = (T)boundaries[rng() % std::size(boundaries)];
+				break;
+			case 2:
+				v = (T)(rng() >> (rng() % 64));
+				break;
+			default:
+				v = (rng() % 8) ? (T)(rng() % 100) : (T)rng();
+			}
+		}
+
+		bitscpp::VectorWrapper expected;
+		{
+			bitscpp::v2::ByteWriter writer(&expected);
+			writer.op_array_header(values.size());
+			for (T v : values) {
+				if constexpr (std::is_unsigned_v<T>) {
+					writer.op_uint(v);
+				} else {
+					writer.op_int(v);
+				}
+			}
+		}
+		bitscpp::VectorWrapper buffer;
+		{
+			bitscpp::v2::ByteWriter writer(&buffer);
+			writer.op(values.data(), values.size());
+		}
+		std::vector<uint8_t> memory(expected.size());
+		bitscpp::FixedBufferWrapper fixed(memory);
+		{
+			bitscpp::v2::ByteWriter writer(&fixed);
+			writer.op(values.data(), values.size());
+			writer.Commit();
+		}
+		// std::vector<uint8_t> is byte array
+		std::vector<T> read(values.size());
+		bitscpp::v2::ByteReader reader(buffer.data(), buffer.size());
+		reader.op(read.data(), read.size());
+		if (buffer.vector != expected.vector || memory != expected.vector ||
+			fixed.size() != memory.size() || read != values ||
+			!reader.is_valid()) {
+			errors++;
+		}
+	}
+	return errors;
+}
+
+template<typename T>
+uint64_t TestIntegerArrayDecodeType(std::mt19937_64 &rng) {
+	uint64_t errors = 0;
+	for (int i = 0; i < 300; ++i) {
+		std::vector<int64_t> values(rng() % (i < 100 ? 80 : 1000));
+		const int mode = rng() % 4;
+		for (int64_t &v : values) {
+			switch (mode) {
+			case 0: // immediate integers only
+				v = (int64_t)(rng() % 160) - 31;
+				break;
+			case 1: // 12-bit integers only
+				v = (int64_t)(rng() % 4096) - 2048;
+				break;
+			case 2:
+				v = (int64_t)(rng() >> (rng() % 64));
+				break;
+			default:
+				v = (rng() % 8) ? (int64_t)(rng() % 100) : (int64_t)rng();
+			}
+		}
+
+		bitscpp::VectorWrapper buffer;
+		{
+			bitscpp::v2::ByteWriter writer(&buffer);
+			writer.op_array_header(values.size());
+			const uint32_t bad = (i % 5 == 4 && values.size())
+									 ? rng() % values.size()
+									 : values.size();
+			for (uint32_t j = 0; j < values.size(); ++j) {
+				if (j == bad) {
+					writer.op(1.5f);
+				} else {
+					writer.op_int(values[j]);
+				}
+			}
+		}
+		size_t size = buffer.size();
+		if (i % 7 == 6) {
+			size = rng() % (size + 1);
+		}
+
+		std::vector<T> expected(values.size());
+		bitscpp::v2::ByteReader expectedReader(buffer.data(), size);
+		uint32_t elements = 0;
+		expectedReader.op_array_header(elements);
+		if (elements != values.size()) {
+			expectedReader.set_error(bitscpp::v2::ERROR_TYPE_MISMATCH);
+		}
+		for (uint32_t j = 0; j < elements && expectedReader.is_valid(); ++j) {
+			expectedReader.op(expected[j]);
+		}
+
+		std::vector<T> read(values.size());
+		bitscpp::v2::ByteReader reader(buffer.data(), size);
+		reader.op(read.data(), read.size());
+		if (reader.is_valid() != expectedReader.is_valid()) {
+			errors++;
+		} else if (reader.is_valid() &&
+				   (read != expected ||
+					reader.get_offset() != expectedReader.get_offset())) {
+			errors++;
+		}
+	}
+	return errors;
+}
+
+void TestIntegerArray() {
+	std::mt19937_64 rng(12345);
+	uint64_t errors = 0;
+	errors += TestIntegerArrayType<int8_t>(rng);
+	errors += TestIntegerArrayType<int16_t>(rng);
+	errors += TestIntegerArrayType<int32_t>(rng);
+	errors += TestIntegerArrayType<int64_t>(rng);
+	errors += TestIntegerArrayType<uint8_t>(rng);
+	errors += TestIntegerArrayType<uint16_t>(rng);
+	errors += TestIntegerArrayType<uint32_t>(rng);
+	errors += TestIntegerArrayType<uint64_t>(rng);
+	printf(" integer array errors: %lu\n", errors);
+	totalErrors += errors;
+
+	errors = 0;
+	errors += TestIntegerArrayDecodeType<int8_t>(rng);
+	errors += TestIntegerArrayDecodeType<int16_t>(rng);
+	errors += TestIntegerArrayDecodeType<int32_t>(rng);
+	errors += TestIntegerArrayDecodeType<int64_t>(rng);
+	errors += TestIntegerArrayDecodeType<uint8_t>(rng);
+	errors += TestIntegerArrayDecodeType<uint16_t>(rng);
+	errors += TestIntegerArrayDecodeType<uint32_t>(rng);
+	errors += TestIntegerArrayDecodeType<uint64_t>(rng);
+	printf(" integer array decode errors: %lu\n", errors);
+	totalErrors += errors;
+
+	// var uint of every width, also at the end of buffer
+	errors = 0;
+	for (int bits = 0; bits <= 64; ++bits) {
+		const uint64_t value = bits == 64 ? ~0llu : (1llu << bits) - 1;
+		for (int padding = 0; padding < 10; ++padding) {
+			bitscpp::VectorWrapper buffer;
+			{
+				bitscpp::v2::ByteWriter writer(&buffer);
+				writer.op_untyped_var_uint(value);
+				writer.op_untyped_var_uint(value >> 1);
+			}
+			buffer.resize(buffer.size() + padding);
+			uint64_t a = 0, b = 0;
+			bitscpp::v2::ByteReader reader(buffer.data(),
+										   buffer.size() - padding);
+			reader.op_untyped_var_uint(a);
+			reader.op_untyped_var_uint(b);
+			if (a != value || b != (value >> 1) || !reader.is_valid() ||
+				reader.get_offset() != buffer.size() - padding) {
+				errors++;
+			}
+		}
+	}
+	printf(" var uint errors: %lu\n", errors);
+	totalErrors += errors;
+}
+
+template<typename T, typename Other>
+uint64_t TestPackedArrayType(std::mt19937_64 &rng) {
+	uint64_t errors = 0;
+	for (int i = 0; i < 40; ++i) {
+		std::vector<T> values(i < 30 ? i : rng() % 100000);
+		for (T &v : values) {
+			const uint64_t r = rng();
+			memcpy(&v, &r, sizeof(T));
+			if constexpr (std::is_floating_point_v<T>) {
+				if (v != v) {
+					v = (T)(int64_t)r;
+				}
+			}
+		}
+
+		auto write = [&](auto &writer) {
+			writer.op_packed_array(values);
+			writer.op(i);
+			writer.op_packed_array(values.data(), values.size());
+		};
+		bitscpp::VectorWrapper buffer;
+		{
+			bitscpp::v2::ByteWriter writer(&buffer);
+			write(writer);
+		}
+		bitscpp::VectorWrapper cursorBuffer;
+		bitscpp::CursorWrapper cursor(&cursorBuffer);
+		{
+			bitscpp::v2::ByteWriter writer(&cursor);
+			write(writer);
+			writer.Commit();
+		}
+		bitscpp::v2::SizeCounter counter;
+		write(counter);
+		bitscpp::v2::MaxSizeCounter maxCounter;
+		write(maxCounter);
+
+		bool success = cursorBuffer.vector == buffer.vector &&
+					   counter.size == buffer.size() &&
+					   maxCounter.size >= buffer.size();
+		success &= buffer.data()[0] == bitscpp::v2::BEG_PACKED_ARRAY &&
+				   buffer.data()[1] ==
+					   bitscpp::v2::packed_array_type<T>::value;
+
+		std::vector<T> a, b(values.size());
+		int32_t i2 = -1;
+		bitscpp::v2::ByteReader reader(buffer.data(), buffer.size());
+		success &= reader.is_next_packed_array() &&
+				   reader.get_next_type() == bitscpp::v2::V2_ARRAY;
+		reader.op_packed_array(a);
+		reader.op(i2);
+		// generic array reading accepts packed array
+		reader.op(b.data(), b.size());
+		success &= reader.is_valid() && !reader.has_any_more() && i2 == i &&
+				   a == values && b == values;
+
+		// different element type
+		std::vector<Other> other;
+		bitscpp::v2::ByteReader otherReader(buffer.data(), buffer.size());
+		otherReader.op_packed_array(other);
+		success &= otherReader.get_errors() == bitscpp::v2::ERROR_TYPE_MISMATCH;
+
+		// truncated data
+		if (values.size()) {
+			bitscpp::v2::ByteReader truncated(buffer.data(),
+											  counter.size / 2 - 1);
+			truncated.op(a);
+			success &= truncated.is_valid() == false;
+		}
+
+		if (!success) {
+			errors++;
+		}
+	}
+	return errors;
+}
+
+void TestPackedArray() {
+	std::mt19937_64 rng(54321);
+	uint64_t errors = 0;
+	errors += TestPackedArrayType<int8_t, uint8_t>(rng);
+	errors += TestPackedArrayType<int16_t, uint16_t>(rng);
+	errors += TestPackedArrayType<int32_t, float>(rng);
+	errors += TestPackedArrayType<int64_t, double>(rng);
+	errors += TestPackedArrayType<uint8_t, int8_t>(rng);
+	errors += TestPackedArrayType<uint16_t, int16_t>(rng);
+	errors += TestPackedArrayType<uint32_t, int32_t>(rng);
+	errors += TestPackedArrayType<uint64_t, int64_t>(rng);
+	errors += TestPackedArrayType<float, int32_t>(rng);
+	errors += TestPackedArrayType<double, uint64_t>(rng);
+	printf(" packed array errors: %lu\n", errors);
+	totalErrors += errors;
+}
+
+struct Mesh {
+	std::string name;
+	std::vector<double> weights;
+	std::vector<float> vertices;
+	std::vector<uint16_t> indices;
+
+	bool operator==(const Mesh &) const = default;
+
+	BITSCPP_DEFINE_INLINE_SERIALIZE_METHOD(s, {
+		uint32_t object;
+		s.op_begin_sized_object(object);
+		s.op(name);
+		s.op_aligned_packed_array(weights);
+		s.op_aligned_packed_array(vertices);
+		s.op_aligned_packed_array(indices);
+		s.op_end_sized_object(object);
+	});
+};
+
+void TestAlignedPackedArray() {
+	for (int i = 0; i < 24; ++i) {
+		Mesh m1, m2;
+		m1.name = std::string(i, 'm');
+		for (int j = 0; j < i * 13; ++j) {
+			m1.weights.push_back(j / 7.0);
+			m1.vertices.push_back(j * 0.5f);
+			m1.indices.push_back(j * 3 + i);
+		}
+
+		auto write = [&](auto &writer) {
+			writer.op(i);
+			writer.op(m1);
+			if constexpr (requires { writer.op_bounded(m1); }) {
+				writer.op_bounded(m1);
+				writer.op_exact(m1);
+			} else {
+				writer.op(m1);
+				writer.op(m1);
+			}
+			writer.op_aligned_packed_array(m1.weights);
+		};
+		bitscpp::VectorWrapper buffer;
+		{
+			bitscpp::v2::ByteWriter writer(&buffer);
+			write(writer);
+		}
+		bitscpp::VectorWrapper cursorBuffer;
+		bitscpp::CursorWrapper cursor(&cursorBuffer);
+		{
+			bitscpp::v2::ByteWriter writer(&cursor);
+			write(writer);
+			writer.Commit();
+		}
+		bitscpp::v2::SizeCounter counter;
+		write(counter);
+		bitscpp::v2::MaxSizeCounter maxCounter;
+		write(maxCounter);
+
+		bool success = cursorBuffer.vector == buffer.vector &&
+					   counter.size == buffer.size() &&
+					   maxCounter.size >= buffer.size();
+
+		int32_t i2 = -1;
+		bitscpp::v2::ByteReader reader(buffer.data(), buffer.size());
+		reader.op(i2);
+		for (int j = 0; j < 3; ++j) {
+			reader.op(m2);
+			success &= m2 == m1;
+		}
+		// views point into buffer
+		std::span<const double> view;
+		std::vector<double> storage;
+		reader.op_packed_array_view(view, storage);
+		success &= reader.is_valid() && !reader.has_any_more() && i2 == i &&
+				   std::equal(view.begin(), view.end(), m1.weights.begin(),
+							  m1.weights.end());
+		if constexpr (bitscpp::Endian::little) {
+			success &= storage.empty() &&
+					   (view.empty() ||
+						(view.data() >= (const double *)buffer.data() &&
+						 view.data() < (const double *)(buffer.data() +
+														buffer.size())));
+		}
+
+		// misaligned buffer falls back to copy
+		std::vector<uint8_t> shifted(buffer.size() + 1);
+		memcpy(shifted.data() + 1, buffer.data(), buffer.size());
+		bitscpp::v2::ByteReader shiftedReader(shifted.data() + 1,
+											  buffer.size());
+		shiftedReader.op(i2).op(m2).op(m2).op(m2);
+		success &= m2 == m1;
+		shiftedReader.op_packed_array_view(view, storage);
+		success &= shiftedReader.is_valid() &&
+				   std::equal(view.begin(), view.end(), m1.weights.begin(),
+							  m1.weights.end()) &&
+				   (view.empty() || view.data() == storage.data());
+
+		printf(" aligned packed array: %i -> %s\n", i,
+			   success ? "true" : "false");
+		if (!success) {
+			totalErrors++;
+		}
+	}
+}
+
+void TestBitArray() {
+	static_assert(bitscpp::v2::max_encoded_size_v<std::bitset<100>> ==
+				  1 + 9 + 13);
+	std::mt19937_64 rng(777);
+	for (int i = 0; i < 40; ++i) {
+		const uint32_t elements = i < 30 ? i : rng() % 100000;
+		std::unique_ptr<bool[]> bools(new bool[elements + 1]);
+		std::vector<bool> vec(elements);
+		std::bitset<13> small;
+		std::bitset<200> big;
+		for (uint32_t j = 0; j < elements; ++j) {
+			bools[j] = vec[j] = rng() & 1;
+		}
+		small = rng();
+		for (int j = 0; j < 200; ++j) {
+			big[j] = rng() % 3 == 0;
+		}
+
+		auto write = [&](auto &writer) {
+			writer.op_bit_array(bools.get(), elements);
+			writer.op(vec);
+			writer.op(small);
+			writer.op(big);
+			// regular array of booleans
+			writer.op(bools.get(), elements);
+		};
+		bitscpp::VectorWrapper buffer;
+		{
+			bitscpp::v2::ByteWriter writer(&buffer);
+			write(writer);
+		}
+		bitscpp::VectorWrapper cursorBuffer;
+		bitscpp::CursorWrapper cursor(&cursorBuffer);
+		{
+			bitscpp::v2::ByteWriter writer(&cursor);
+			write(writer);
+			writer.Commit();
+		}
+		std::vector<uint8_t> streamed;
+		bitscpp::StreamBuffer stream(
+			[&](const uint8_t *data, size_t bytes) {
+				streamed.insert(streamed.end(), data, data + bytes);
+				return true;
+			},
+			1024);
+		{
+			bitscpp::v2::ByteWriter writer(&stream);
+			write(writer);
+			writer.Commit();
+			stream.flush();
+		}
+		bitscpp::v2::SizeCounter counter;
+		write(counter);
+
+		bool success = cursorBuffer.vector == buffer.vector &&
+					   streamed == buffer.vector &&
+					   counter.size == buffer.size();
+
+		std::unique_ptr<bool[]> bools2(new bool[elements + 1]);
+		std::vector<bool> vec2, vec3;
+		std::bitset<13> small2;
+		std::bitset<200> big2;
+		bitscpp::v2::ByteReader reader(buffer.data(), buffer.size());
+		success &= reader.is_next_bit_array() &&
+				   reader.get_next_type() == bitscpp::v2::V2_ARRAY;
+		// generic array reading accepts bit array
+		reader.op(bools2.get(), elements);
+		reader.op(vec2);
+		reader.op(small2);
+		reader.op(big2);
+		// std::vector<bool> accepts regular array of booleans
+		reader.op(vec3);
+		success &= reader.is_valid() && !reader.has_any_more() &&
+				   std::equal(bools.get(), bools.get() + elements,
+							  bools2.get()) &&
+				   vec2 == vec && vec3 == vec && small2 == small && big2 == big;
+
+		// bitset of different size
+		std::bitset<14> other;
+		bitscpp::v2::ByteReader otherReader(buffer.data(), buffer.size());
+		otherReader.op_bit_array(vec2);
+		otherReader.op(vec2);
+		otherReader.op(other);
+		success &= otherReader.get_errors() == bitscpp::v2::ERROR_TYPE_MISMATCH;
+
+		printf(" bit array: %i -> %s\n", i, success ? "true" : "false");
+		if (!success) {
+			totalErrors++;
+		}
+	}
+
+	// element i is bit (i % 8) of byte i / 8
+	const bool bools[] = {true, false, true, true, false, false, false, false,
+						  true};
+	bitscpp::VectorWrapper buffer;
+	{
+		bitscpp::v2::ByteWriter writer(&buffer);
+		writer.op_bit_array(bools, 9);
+	}
+	const std::vector<uint8_t> expected = {bitscpp::v2::BEG_BIT_ARRAY, 9, 0x0D,
+										   0x01};
+	const bool success = buffer.vector == expected;
+	printf(" bit array layout -> %s\n", success ? "true" : "false");
+	if (!success) {
+		totalErrors++;
+	}
+}
+
+void TestHalfFloat() {
+	uint64_t errors = 0;
+	std::vector<uint16_t> halves(65536);
+	std::vector<float> floats(65536);
+	for (uint32_t h = 0; h < 65536; ++h) {
+		halves[h] = h;
+	}
+	bitscpp::HalfToFloat(floats.data(), halves.data(), halves.size());
+	for (uint32_t h = 0; h < 65536; ++h) {
+		const float f = bitscpp::HalfToFloat(h);
+		// F16C and table give the same result
+		if (std::bit_cast<uint32_t>(f) !=
+				std::bit_cast<uint32_t>(bitscpp::impl::half_to_float_soft(h)) ||
+			std::bit_cast<uint32_t>(f) != std::bit_cast<uint32_t>(floats[h])) {
+			errors++;
+		}
+		const uint16_t back = bitscpp::FloatToHalf(f);
+		if (f != f ? (back & 0x7FFF) <= 0x7C00 : back != h) {
+			errors++;
+		}
+	}
+	printf(" half to float errors: %lu\n", errors);
+	totalErrors += errors;
+
+	errors = 0;
+	std::mt19937_64 rng(1616);
+	for (uint32_t i = 0; i < 65536; ++i) {
+		floats[i] = std::bit_cast<float>((uint32_t)rng());
+	}
+	bitscpp::FloatToHalf(halves.data(), floats.data(), floats.size());
+	for (uint32_t i = 0; i < 65536; ++i) {
+		const uint16_t h = bitscpp::FloatToHalf(floats[i]);
+		if (h != halves[i] ||
+			h != bitscpp::impl::float_to_half_soft(floats[i])) {
+			errors++;
+		}
+	}
+	// rounding to nearest even
+	const std::pair<float, uint16_t> rounding[] = {
+		{1.0f, 0x3C00},
+		{1.0f + 0x1p-11f, 0x3C00},
+		{1.0f + 0x3p-11f, 0x3C02},
+		{-1.0f - 0x1p-11f - 0x1p-20f, 0xBC01},
+		{65504.0f, 0x7BFF},
+		{65519.0f, 0x7BFF},
+		{65520.0f, 0x7C00},
+		{1e10f, 0x7C00},
+		{0x1p-24f, 0x0001},
+		{0x1p-25f, 0x0000},
+		{0x1p-25f + 0x1p-35f, 0x0001},
+		{0x3p-25f, 0x0002},
+		{-0.0f, 0x8000},
+		{std::bit_cast<float>(0x7F800000u), 0x7C00},
+		{std::bit_cast<float>(0xFFC00000u), 0xFE00},
+	};
+	for (auto [f, h] : rounding) {
+		if (bitscpp::FloatToHalf(f) != h) {
+			errors++;
+		}
+	}
+	printf(" float to half errors: %lu\n", errors);
+	totalErrors += errors;
+
+	for (int i = 0; i < 24; ++i) {
+		const uint32_t elements = i < 20 ? i : rng() % 10000;
+		std::vector<float> values(elements);
+		for (float &v : values) {
+			// exactly representable by half
+			v = bitscpp::HalfToFloat(rng() % 0x7C00 | (rng() & 0x8000));
+		}
+
+		auto write = [&](auto &writer) {
+			writer.op_half_array(values);
+			writer.op_half_array(values.data(), values.size());
+			writer.op_half_array(values);
+		};
+		bitscpp::VectorWrapper buffer;
+		{
+			bitscpp::v2::ByteWriter writer(&buffer);
+			write(writer);
+		}
+		bitscpp::VectorWrapper cursorBuffer;
+		bitscpp::CursorWrapper cursor(&cursorBuffer);
+		{
+			bitscpp::v2::ByteWriter writer(&cursor);
+			write(writer);
+			writer.Commit();
+		}
+		std::vector<uint8_t> streamed;
+		bitscpp::StreamBuffer stream(
+			[&](const uint8_t *data, size_t bytes) {
+				streamed.insert(streamed.end(), data, data + bytes);
+				return true;
+			},
+			1024);
+		{
+			bitscpp::v2::ByteWriter writer(&stream);
+			write(writer);
+			writer.Commit();
+			stream.flush();
+		}
+		bitscpp::v2::SizeCounter counter;
+		write(counter);
+		bitscpp::v2::MaxSizeCounter maxCounter;
+		write(maxCounter);
+
+		bool success = cursorBuffer.vector == buffer.vector &&
+					   streamed == buffer.vector &&
+					   counter.size == buffer.size() &&
+					   maxCounter.size >= buffer.size();
+
+		std::vector<float> a, b, c(elements);
+		bitscpp::v2::ByteReader reader(buffer.data(), buffer.size());
+		success &= reader.is_next_half_array() &&
+				   reader.is_next_packed_array();
+		reader.op_half_array(a);
+		// generic float array reading accepts array of halves
+		reader.op(b);
+		reader.op(c.data(), c.size());
+		success &= reader.is_valid() && !reader.has_any_more() &&
+				   a == values && b == values && c == values;
+
+		// not array of floats
+		std::vector<float> other;
+		bitscpp::v2::ByteReader otherReader(buffer.data(), buffer.size());
+		otherReader.op_packed_array(other);
+		success &= otherReader.get_errors() == bitscpp::v2::ERROR_TYPE_MISMATCH;
+
+		printf(" half array: %i -> %s\n", i, success ? "true" : "false");
+		if (!success) {
+			totalErrors++;
+		}
+	}
+
+	const float values[] = {1.0f, -2.0f};
+	bitscpp::VectorWrapper buffer;
+	{
+		bitscpp::v2::ByteWriter writer(&buffer);
+		writer.op_half_array(values, 2);
+	}
+	const std::vector<uint8_t> expected = {bitscpp::v2::BEG_PACKED_ARRAY,
+										   bitscpp::v2::PACKED_HALF,
+										   2,
+										   0x00,
+										   0x3C,
+										   0x00,
+										   0xC0};
+	const bool success = buffer.vector == expected;
+	printf(" half array layout -> %s\n", success ? "true" : "false");
+	if (!success) {
+		totalErrors++;
+	}
+}
+
+void TestWideStore() {
+	std::mt19937_64 rng(1717);
+	for (int i = 0; i < 16; ++i) {
+		const uint32_t elements = i < 8 ? i : rng() % 3000;
+		std::vector<int64_t> ints(elements);
+		std::vector<uint64_t> uints(elements);
+		std::vector<double> doubles(elements);
+		for (uint32_t j = 0; j < elements; ++j) {
+			// every bit width is equally likely
+			ints[j] = (int64_t)(rng() >> (rng() % 64));
+			if (rng() & 1) {
+				ints[j] = ~ints[j];
+			}
+			uints[j] = rng() >> (rng() % 64);
+			doubles[j] = (double)ints[j] / (double)(uints[j] | 1);
+		}
+
+		auto write = [&](auto &writer) {
+			for (uint32_t j = 0; j < elements; ++j) {
+				writer.op(ints[j]);
+				writer.op_untyped_var_uint(uints[j]);
+				writer.op_untyped_var_int(ints[j]);
+				writer.op_float((float)doubles[j]);
+				writer.op_double(doubles[j]);
+				writer.op_half(1.0f);
+			}
+			if constexpr (requires { writer.op_exact(uints); }) {
+				writer.op_bounded(ints);
+				writer.op_exact(uints);
+			} else {
+				writer.op(ints);
+				writer.op(uints);
+			}
+		};
+		bitscpp::VectorWrapper buffer;
+		{
+			bitscpp::v2::ByteWriter writer(&buffer);
+			write(writer);
+		}
+		bitscpp::VectorWrapper cursorBuffer;
+		bitscpp::CursorWrapper cursor(&cursorBuffer);
+		{
+			bitscpp::v2::ByteWriter writer(&cursor);
+			write(writer);
+			writer.Commit();
+		}
+		// small staging buffer, windows often end in the middle of value
+		std::vector<uint8_t> streamed;
+		bitscpp::StreamBuffer stream(
+			[&](const uint8_t *data, size_t bytes) {
+				streamed.insert(streamed.end(), data, data + bytes);
+				return true;
+			},
+			61);
+		{
+			bitscpp::v2::ByteWriter writer(&stream);
+			write(writer);
+			writer.Commit();
+			stream.flush();
+		}
+		// no space for wide stores at the end
+		std::vector<uint8_t> memory(buffer.size());
+		bitscpp::FixedBufferWrapper fixed(memory);
+		{
+			bitscpp::v2::ByteWriter writer(&fixed);
+			write(writer);
+			writer.Commit();
+		}
+		bitscpp::v2::SizeCounter counter;
+		write(counter);
+
+		bool success = cursorBuffer.vector == buffer.vector &&
+					   streamed == buffer.vector && memory == buffer.vector &&
+					   fixed.size() == buffer.size() &&
+					   counter.size == buffer.size();
+
+		bitscpp::v2::ByteReader reader(buffer.data(), buffer.size());
+		for (uint32_t j = 0; j < elements; ++j) {
+			int64_t a, b;
+			uint64_t u;
+			float f, h;
+			double d;
+			reader.op(a);
+			reader.op_untyped_var_uint(u);
+			reader.op_untyped_var_int(b);
+			reader.op_float(f);
+			reader.op_double(d);
+			reader.op_half(h);
+			success &= a == ints[j] && b == ints[j] && u == uints[j] &&
+					   f == (float)doubles[j] && d == doubles[j] && h == 1.0f;
+		}
+		std::vector<int64_t> ints2;
+		std::vector<uint64_t> uints2;
+		reader.op(ints2);
+		reader.op(uints2);
+		success &= reader.is_valid() && !reader.has_any_more() &&
+				   ints2 == ints && uints2 == uints;
+
+		printf(" wide store: %i -> %s\n", i, success ? "true" : "false");
+		if (!success) {
+			totalErrors++;
+		}
+	}
+}
+
+void TestPaddedReader() {
+	std::mt19937_64 rng(1818);
+	for (int i = 0; i < 16; ++i) {
+		const uint32_t elements = i < 8 ? i + 1 : rng() % 1000 + 1;
+		std::vector<int64_t> ints(elements);
+		std::vector<uint64_t> uints(elements);
+		for (uint32_t j = 0; j < elements; ++j) {
+			ints[j] = (int64_t)(rng() >> (rng() % 64));
+			if (rng() & 1) {
+				ints[j] = ~ints[j];
+			}
+			uints[j] = rng() >> (rng() % 64);
+		}
+		bitscpp::VectorWrapper buffer;
+		{
+			bitscpp::v2::ByteWriter writer(&buffer);
+			writer.op(ints);
+			for (uint32_t j = 0; j < elements; ++j) {
+				writer.op_untyped_var_uint(uints[j]);
+				writer.op(ints[j]);
+			}
+		}
+		// padding bytes are not masked out by accident
+		std::vector<uint8_t> padded = buffer.vector;
+		padded.resize(buffer.size() + bitscpp::v2::ByteReader::INPUT_PADDING,
+					  0xFF);
+
+		std::vector<int64_t> ints2;
+		bitscpp::v2::ByteReader reader(padded.data(), buffer.size(),
+									   bitscpp::v2::ByteReader::Padded{});
+		reader.op(ints2);
+		bool success = ints2 == ints;
+		for (uint32_t j = 0; j < elements; ++j) {
+			uint64_t u = 0;
+			int64_t v = 0;
+			reader.op_untyped_var_uint(u);
+			reader.op(v);
+			success &= u == uints[j] && v == ints[j];
+		}
+		success &= reader.is_valid() && !reader.has_any_more();
+
+		// truncated data gives the same errors as without padding
+		auto readAll = [&](bitscpp::v2::ByteReader &r) {
+			r.op(ints2);
+			for (uint32_t j = 0; j < elements; ++j) {
+				uint64_t u = 0;
+				int64_t v = 0;
+				r.op_untyped_var_uint(u);
+				r.op(v);
+			}
+			return r.get_errors();
+		};
+		for (uint32_t cut = 1; cut < 9 && cut < buffer.size(); ++cut) {
+			bitscpp::v2::ByteReader truncated(
+				padded.data(), buffer.size() - cut,
+				bitscpp::v2::ByteReader::Padded{});
+			bitscpp::v2::ByteReader exact(padded.data(), buffer.size() - cut);
+			const auto errors = readAll(truncated);
+			success &= errors == readAll(exact) &&
+					   (errors & bitscpp::v2::ERROR_BUFFER_TOO_SMALL);
+		}
+
+		printf(" padded reader: %i -> %s\n", i, success ? "true" : "false");
+		if (!success) {
+			totalErrors++;
+		}
+	}
+}
+
+void TestValidator() {
+	using namespace bitscpp::v2;
+	std::mt19937_64 rng(2020);
+	for (int i = 0; i < 16; ++i) {
+		bitscpp::VectorWrapper buffer;
+		{
+			ByteWriter writer(&buffer);
+			// every strict prefix of single object is invalid
+			writer.op_begin_object();
+			SizedObject sized;
+			sized.telemetry.timestamp = rng();
+			sized.telemetry.heading = i * 0.25;
+			sized.name.assign(rng() % 100, 'n');
+			sized.extended = i & 1;
+			sized.extra.resize(i);
+			for (int j = 0; j < i * 10; ++j) {
+				sized.values.push_back((int32_t)(rng() >> (rng() % 64)));
+			}
+			writer.op(sized);
+			Mesh mesh{"mesh", std::vector<double>(i, 1.5),
+					  std::vector<float>(i * 3, 2.5f),
+					  std::vector<uint16_t>(i * 2, 7)};
+			writer.op(mesh);
+			writer.op_map_header(i);
+			for (int j = 0; j < i; ++j) {
+				writer.op(std::to_string(j));
+				writer.op(j % 3 == 0);
+			}
+			std::vector<bool> bools(i * 13);
+			for (uint32_t j = 0; j < bools.size(); ++j) {
+				bools[j] = rng() & 1;
+			}
+			writer.op_bit_array(bools);
+			writer.op_half_array(std::vector<float>(i, 0.5f));
+			writer.op_half(1.5f);
+			writer.op_bfloat(2.5f);
+			// runs of single byte values crossing ends of arrays
+			std::vector<std::vector<int>> small(i);
+			for (int j = 0; j < i; ++j) {
+				small[j].resize(rng() % 40, j);
+			}
+			writer.op(small);
+			// nesting deeper than inline stack of validator
+			const uint32_t depth = 20 + i * 4;
+			for (uint32_t j = 0; j < depth; ++j) {
+				if (j & 1) {
+					writer.op_begin_object();
+				} else {
+					writer.op_array_header(1);
+				}
+			}
+			writer.op(true);
+			for (uint32_t j = depth; j > 0; --j) {
+				if ((j - 1) & 1) {
+					writer.op_end_object();
+				}
+			}
+			writer.op_array_header(0);
+			writer.op_end_object();
+		}
+		const uint8_t *data = buffer.data();
+		const uint32_t size = buffer.size();
+
+		bool success = validate(data, size) == ERROR_OK;
+		for (uint32_t cut = 1; cut < size; ++cut) {
+			success &= validate(data, cut) != ERROR_OK;
+		}
+
+		std::vector<uint8_t> bytes = buffer.vector;
+		bytes.resize(size);
+		bytes.push_back(END_OBJECT);
+		success &= validate(bytes.data(), bytes.size()) == ERROR_TYPE_MISMATCH;
+		for (uint32_t h = BEG_RESERVED; h <= END_RESERVED; ++h) {
+			bytes.back() = h;
+			success &= validate(bytes.data(), bytes.size()) ==
+					   ERROR_TYPE_MISMATCH;
+		}
+		success &= validate(nullptr, 0) == ERROR_BUFFER_NULLPTR;
+
+		// corrupted buffers are rejected or accepted, but never overread
+		for (int j = 0; j < 1000; ++j) {
+			std::vector<uint8_t> corrupted(buffer.vector.begin(),
+										   buffer.vector.begin() + size);
+			for (int k = rng() % 4; k >= 0; --k) {
+				corrupted[rng() % size] = rng();
+			}
+			const uint32_t cut = rng() % (size + 1);
+			std::vector<uint8_t> exact(corrupted.begin(),
+									   corrupted.begin() + cut);
+			validate(exact.data(), exact.size());
+		}
+
+		printf(" validator: %i -> %s\n", i, success ? "true" : "false");
+		if (!success) {
+			totalErrors++;
+		}
+	}
+}
+
+template<typename Reader>
+void TestSkipValue(const char *name) {
+	using namespace bitscpp::v2;
+	std::mt19937_64 rng(2022);
+	for (int i = 0; i < 8; ++i) {
+		bitscpp::VectorWrapper buffer;
+		uint32_t values = 0;
+		{
+			ByteWriter writer(&buffer);
+			writer.op((int64_t)(rng() >> (rng() % 64)));
+			writer.op(std::string(rng() % 300, 's'));
+			writer.op(i * 0.5);
+			writer.op_half(0.25f);
+			writer.op(i & 1);
+			SizedObject sized;
+			sized.name = "sized";
+			sized.values.resize(i * 7, -i);
+			sized.extended = true;
+			sized.extra.resize(i);
+			writer.op(sized);
+			writer.op(Mesh{"mesh", std::vector<double>(i, 1.5), {}, {}});
+			std::vector<std::vector<int>> small(i * 5, std::vector<int>(i, 3));
+			writer.op(small);
+			writer.op_map_header(i);
+			for (int j = 0; j < i; ++j) {
+				writer.op(std::to_string(j));
+				writer.op(std::vector<bool>(j * 9, true));
+			}
+			// unsized object with unknown trailing fields
+			writer.op_begin_object();
+			writer.op(i);
+			writer.op(std::vector<std::string>(i, "field"));
+			writer.op_end_object();
+			values = 10;
+			writer.op(0x12345);
+		}
+		const uint8_t *data = buffer.data();
+		const uint32_t size = buffer.size();
+
+		bool success = true;
+		{
+			Reader reader(data, size);
+			for (uint32_t j = 0; j < values; ++j) {
+				reader.skip_next_value();
+			}
+			int marker = 0;
+			reader.op(marker);
+			success &= reader.is_valid() && marker == 0x12345 &&
+					   reader.has_any_more() == false;
+		}
+		{
+			Reader reader(data, size);
+			reader.skip_values(values);
+			int marker = 0;
+			reader.op(marker);
+			success &= reader.is_valid() && marker == 0x12345;
+		}
+		{
+			// skipping rest of object fields
+			Reader reader(data, size);
+			reader.skip_values(values - 1);
+			int first = -1;
+			reader.op_begin_object();
+			reader.op(first);
+			reader.skip_values(1);
+			reader.op_end_object();
+			success &= reader.is_valid() && first == i;
+		}
+		if constexpr (std::is_same_v<Reader, ByteReader>) {
+			// cut values are reported
+			for (uint32_t cut = 1; cut < size; ++cut) {
+				Reader reader(data, cut);
+				reader.skip_values(values + 1);
+				success &= reader.get_errors() == ERROR_BUFFER_TOO_SMALL;
+			}
+			Reader reader(data, size);
+			reader.skip_values(values + 2);
+			success &= reader.get_errors() == ERROR_BUFFER_TOO_SMALL;
+		}
+
+		// second bytes of 12-bit integers look like headers of 12-bit
+		// integers, values are shifted by immediate integer
+		std::vector<uint8_t> shifted = {BEG_ARRAY_IMMEDIATE_SIZED + 9,
+										BEG_12B_INTEGER, BEG_12B_INTEGER, 5};
+		for (int j = 0; j < 7; ++j) {
+			shifted.push_back(BEG_12B_INTEGER);
+			shifted.push_back(j < 6 ? 5 : BEG_FLOAT);
+		}
+		shifted.push_back(BOOLEAN_TRUE);
+		{
+			Reader reader(shifted.data(), shifted.size());
+			reader.skip_next_value();
+			bool last = false;
+			reader.op(last);
+			success &= reader.is_valid() && last;
+		}
+
+		// nesting deeper than C++ stack would allow for recursion
+		std::vector<uint8_t> deep(100000 + i, BEG_ARRAY_IMMEDIATE_SIZED + 1);
+		deep.push_back(BEG_BOOLEAN);
+		deep.push_back(BEG_BOOLEAN);
+		{
+			Reader reader(deep.data(), deep.size());
+			reader.skip_next_value();
+			bool last = true;
+			reader.op(last);
+			success &= reader.is_valid() && reader.has_any_more() == false;
+		}
+
+		printf(" %s: %i -> %s\n", name, i, success ? "true" : "false");
+		if (!success) {
+			totalErrors++;
+		}
+	}
+}
+
+void TestTape() {
+	using namespace bitscpp::v2;
+	std::mt19937_64 rng(2023);
+	for (int i = 0; i < 8; ++i) {
+		const uint32_t rows = 10 + i * 30;
+		bitscpp::VectorWrapper buffer;
+		{
+			ByteWriter writer(&buffer);
+			writer.op(-i);
+			writer.op_array_header(rows);
+			for (uint32_t j = 0; j < rows; ++j) {
+				writer.op_begin_object();
+				writer.op(j);
+				writer.op(std::to_string(j * 7));
+				writer.op(std::vector<int>(j % 40, j));
+				writer.op_end_object();
+			}
+			writer.op_map_header(i);
+			for (int j = 0; j < i; ++j) {
+				writer.op(std::to_string(j));
+				writer.op(j * 1000);
+			}
+			SizedObject sized;
+			sized.name = "sized";
+			sized.values.resize(i, 5);
+			writer.op(sized);
+			writer.op_packed_array(std::vector<uint16_t>(i, 3));
+			writer.op_bit_array(std::vector<bool>(i, true));
+			writer.op(std::vector<std::vector<int>>(i));
+			writer.op(0x777);
+		}
+		const uint8_t *data = buffer.data();
+		const uint32_t size = buffer.size();
+
+		Tape tape;
+		bool success = tape.build(data, size) == ERROR_OK && tape.size() == 8;
+		// top level values are at the same offsets as with skip_values()
+		for (uint32_t j = 0; j < tape.size() && success; ++j) {
+			ByteReader reader(data, size);
+			reader.skip_values(j);
+			success &= tape.root(j).get_offset() == reader.get_offset();
+		}
+		success &= tape.root(8).is_valid() == false;
+
+		const TapeCursor array = tape.root(1);
+		success &= array.get_type() == V2_ARRAY && array.size() == rows;
+		for (uint32_t j = 0; j < 50 && success; ++j) {
+			const uint32_t row = rng() % rows;
+			const TapeCursor object = array.element(row);
+			uint32_t id = 0;
+			std::string name;
+			std::vector<int> values;
+			object.field(0).reader().op(id);
+			object.field(1).reader().op(name);
+			object.field(2).reader().op(values);
+			success &= object.get_type() == V2_OBJECT_BEGIN && id == row &&
+					   name == std::to_string(row * 7) &&
+					   values == std::vector<int>(row % 40, row) &&
+					   object.field(3).is_valid() == false;
+			const TapeCursor last = object.field(2).element(row % 40 - 1);
+			int value = 0;
+			last.reader().op(value);
+			success &= row % 40 == 0 ? last.is_valid() == false
+									 : value == (int)row;
+		}
+		success &= array.element(rows).is_valid() == false;
+
+		const TapeCursor map = tape.root(2);
+		success &= map.get_type() == V2_MAP && map.size() == (uint32_t)i;
+		for (int j = 0; j < i; ++j) {
+			std::string key;
+			int value = 0;
+			map.key(j).reader().op(key);
+			map.value(j).reader().op(value);
+			success &= key == std::to_string(j) && value == j * 1000;
+		}
+
+		const TapeCursor object = tape.root(3);
+		std::string name;
+		// fields of telemetry are written without object
+		object.field(8).reader().op(name);
+		success &= object.get_detailed_type() == V2_DETAIL_SIZED_OBJECT_BEGIN &&
+				   name == "sized" &&
+				   object.field(9).size() == (uint32_t)i;
+		success &= tape.root(4).get_detailed_type() == V2_DETAIL_PACKED_ARRAY &&
+				   tape.root(4).first_child().is_valid() == false;
+		success &= tape.root(5).get_detailed_type() == V2_DETAIL_BIT_ARRAY;
+		success &= tape.root(6).size() == (uint32_t)i &&
+				   (i == 0 || tape.root(6).element(i - 1).size() == 0);
+		int marker = 0;
+		tape.root(7).reader().op(marker);
+		success &= marker == 0x777;
+
+		// the same errors as validate()
+		for (uint32_t cut = 1; cut < size; ++cut) {
+			const Errors error = tape.build(data, cut);
+			success &= error == validate(data, cut) &&
+					   (error == ERROR_OK || tape.size() == 0);
+		}
+		for (int j = 0; j < 300; ++j) {
+			std::vector<uint8_t> corrupted(data, data + size);
+			for (int k = rng() % 4; k >= 0; --k) {
+				corrupted[rng() % size] = rng();
+			}
+			success &= tape.build(corrupted.data(), size) ==
+					   validate(corrupted.data(), size);
+		}
+		success &= tape.build(nullptr, 0) == ERROR_BUFFER_NULLPTR;
+
+		printf(" tape: %i -> %s\n", i, success ? "true" : "false");
+		if (!success) {
+			totalErrors++;
+		}
+	}
+
+	// nested arrays, each claiming as many elements as there are bytes left,
+	// do not allocate element slots quadratic in size of buffer
+	bitscpp::VectorWrapper nested;
+	{
+		ByteWriter writer(&nested);
+		for (uint32_t i = 0; i < 8000; ++i) {
+			writer.op_array_header((8000 - i - 1) * 3);
+		}
+	}
+	Tape tape;
+	const Errors error = tape.build(nested.data(), nested.size());
+	const bool success =
+		error == ERROR_BUFFER_TOO_SMALL &&
+		validate(nested.data(), nested.size()) == error &&
+		tape.elements.capacity() <= 2 * nested.size();
+	printf(" tape: nested claims -> %s\n", success ? "true" : "false");
+	if (!success) {
+		totalErrors++;
+	}
+}
+
+void TestIndexedArray() {
+	using namespace bitscpp::v2;
+	std::mt19937_64 rng(2024);
+	for (int i = 0; i < 8; ++i) {
+		// elements grow with i, so that tables of 1, 2 and 4 bytes are used
+		const uint32_t elements = i * 30;
+		std::vector<std::string> strings(elements);
+		for (uint32_t j = 0; j < elements; ++j) {
+			strings[j] =
+				std::string(j * i * i * i % (1 + i * i * i * 6), 'a' + j % 26);
+		}
+		std::vector<SizedObject> objects(i);
+		for (int j = 0; j < i; ++j) {
+			objects[j].name = std::to_string(j);
+			objects[j].values.resize(j, j);
+		}
+		bitscpp::VectorWrapper buffer;
+		{
+			ByteWriter writer(&buffer);
+			writer.op(-i);
+			writer.op_indexed_array(strings);
+			writer.op_indexed_array(objects);
+			writer.op(0x777);
+		}
+		const uint8_t *data = buffer.data();
+		const uint32_t size = buffer.size();
+
+		SizeCounter counter;
+		counter.op(-i);
+		counter.op_indexed_array(strings);
+		counter.op_indexed_array(objects);
+		counter.op(0x777);
+		bool success = counter.size == size && validate(data, size) == ERROR_OK;
+
+		const auto read = [&]<typename Reader>(Reader reader) {
+			int value = 0;
+			reader.op(value);
+			success &= reader.is_next_indexed_array() &&
+					   reader.array_element_count() == elements;
+			IndexedArray array;
+			reader.op_indexed_array_header(array);
+			const uint32_t total =
+				elements ? bitscpp::ReadBytesInNetworkOrder(
+							   data + array.data - array.width, array.width)
+						 : 0;
+			success &= array.elements == elements &&
+					   array.width == (total <= 0xFF ? 1u
+									   : total <= 0xFFFF ? 2u
+														 : 4u);
+			for (uint32_t j = 0; j < 40 && elements; ++j) {
+				const uint32_t index = rng() % elements;
+				std::string str;
+				reader.seek_array_element(array, index).op(str);
+				success &= str == strings[index];
+			}
+			reader.seek_array_element(array, elements);
+			std::vector<SizedObject> decoded;
+			reader.op_indexed_array(decoded);
+			reader.op(value);
+			success &= reader.is_valid() && decoded == objects && value == 0x777;
+			reader.seek_array_element(array, elements + 1);
+			success &= reader.get_errors() == ERROR_TYPE_MISMATCH;
+		};
+		read(ByteReader(data, size));
+		read(UncheckedByteReader(data, size));
+		// indexed array is read like array
+		{
+			ByteReader reader(data, size);
+			int value = 0;
+			std::vector<std::string> read;
+			reader.op(value).op(read);
+			success &= read == strings;
+			reader.skip_next_value().op(value);
+			success &= reader.is_valid() && value == 0x777;
+		}
+		// array without table is accepted and skipped through
+		{
+			bitscpp::VectorWrapper plain;
+			ByteWriter(&plain).op(strings);
+			ByteReader reader(plain.data(), plain.size());
+			IndexedArray array;
+			reader.op_indexed_array_header(array);
+			success &= array.elements == elements && array.width == 0;
+			if (elements) {
+				std::string str;
+				reader.seek_array_element(array, elements - 1).op(str);
+				success &= str == strings.back();
+			}
+		}
+
+		Tape tape;
+		success &= tape.build(data, size) == ERROR_OK && tape.size() == 4;
+		const TapeCursor array = tape.root(1);
+		success &= array.get_detailed_type() == V2_DETAIL_INDEXED_ARRAY &&
+				   array.get_type() == V2_ARRAY && array.size() == elements;
+		for (uint32_t j = 0; j < elements; j += 7) {
+			std::string str;
+			array.element(j).reader().op(str);
+			success &= str == strings[j];
+		}
+		success &= tape.root(2).size() == (uint32_t)i;
+
+		// elements have to end exactly at offsets of table
+		if (elements >= 2) {
+			std::vector<uint8_t> bytes(data, data + size);
+			ByteReader reader(data, size);
+			IndexedArray indexed;
+			reader.skip_next_value().op_indexed_array_header(indexed);
+			const uint32_t width = indexed.width;
+			uint8_t *table = bytes.data() + indexed.table;
+			const uint64_t first =
+				bitscpp::ReadBytesInNetworkOrder(table, width);
+			const uint64_t second =
+				bitscpp::ReadBytesInNetworkOrder(table + width, width);
+			bitscpp::WriteBytesInNetworkOrder(table, second, width);
+			success &= validate(bytes.data(), size) == ERROR_TYPE_MISMATCH;
+			if (second - first > 1) {
+				bitscpp::WriteBytesInNetworkOrder(table, first + 1, width);
+				success &= validate(bytes.data(), size) == ERROR_TYPE_MISMATCH &&
+						   tape.build(bytes.data(), size) == ERROR_TYPE_MISMATCH;
+			}
+			bitscpp::WriteBytesInNetworkOrder(table, first, width);
+			table[-1] = 3;
+			success &= validate(bytes.data(), size) == ERROR_TYPE_MISMATCH;
+		}
+
+		for (uint32_t cut = 1; cut < size; cut += 1 + size / 4096) {
+			success &= tape.build(data, cut) == validate(data, cut);
+		}
+		// corrupted buffers are never overread by seeks of checked reader
+		for (int j = 0; j < 300; ++j) {
+			std::vector<uint8_t> corrupted(data, data + size);
+			for (int k = rng() % 4; k >= 0; --k) {
+				corrupted[rng() % size] = rng();
+			}
+			success &= tape.build(corrupted.data(), size) ==
+					   validate(corrupted.data(), size);
+			ByteReader reader(corrupted.data(), size);
+			IndexedArray array;
+			reader.skip_next_value().op_indexed_array_header(array);
+			std::string str;
+			reader.seek_array_element(array, rng() % (elements + 1)).op(str);
+		}
+
+		printf(" indexed array: %i -> %s\n", i, success ? "true" : "false");
+		if (!success) {
+			totalErrors++;
+		}
+	}
+}
+
+void TestMapView() {
+	using namespace bitscpp::v2;
+	std::mt19937_64 rng(2025);
+	for (int i = 0; i < 8; ++i) {
+		std::map<std::string, int> strings;
+		std::map<int64_t, std::string> ints;
+		for (int j = 0; j < i * i * 20; ++j) {
+			strings[std::to_string(rng() % 100000)] = j;
+			ints[(int64_t)(rng() % 200000) - 100000] =
+				std::string(j % 300, 'a' + j % 26);
+		}
+		bitscpp::VectorWrapper buffer;
+		{
+			ByteWriter writer(&buffer);
+			writer.op_sorted_map(strings);
+			writer.op_sorted_map(ints);
+			writer.op(0x777);
+		}
+		// op() writes maps without offset tables to every buffer
+		const auto write = [&](auto &writer) {
+			writer.op(strings);
+			writer.op(ints);
+			writer.op(0x777);
+			writer.Commit();
+		};
+		bitscpp::VectorWrapper vector;
+		{
+			ByteWriter writer(&vector);
+			write(writer);
+		}
+		bitscpp::SegmentedBuffer segmented(256);
+		{
+			ByteWriter writer(&segmented);
+			write(writer);
+		}
+		std::vector<uint8_t> streamed;
+		bitscpp::StreamBuffer stream(
+			[&](const uint8_t *data, size_t bytes) {
+				streamed.insert(streamed.end(), data, data + bytes);
+				return true;
+			},
+			256);
+		{
+			ByteWriter writer(&stream);
+			write(writer);
+			stream.flush();
+		}
+		const std::vector<uint8_t> plain = segmented.flatten();
+
+		SizeCounter counter;
+		counter.op_sorted_map(strings);
+		counter.op_sorted_map(ints);
+		counter.op(0x777);
+		const size_t plainSize =
+			encoded_size(strings) + encoded_size(ints) + encoded_size(0x777);
+		const bool sorted = strings.empty() == false;
+		bool success = counter.size == buffer.size() &&
+					   plainSize == plain.size() && plain == vector.vector &&
+					   streamed == plain &&
+					   validate(buffer.data(), buffer.size()) == ERROR_OK &&
+					   validate(plain.data(), plain.size()) == ERROR_OK &&
+					   ByteReader(buffer.data(), buffer.size())
+							   .is_next_sorted_map() == sorted;
+
+		const auto read = [&]<bool CHECKED>(BasicByteReader<CHECKED> reader,
+											 bool sorted) {
+			using Reader = BasicByteReader<CHECKED>;
+			success &= reader.is_next_map();
+			BasicMapView<CHECKED> stringView(reader);
+			BasicMapView<CHECKED> intView(reader);
+			int value = 0;
+			reader.op(value);
+			success &= reader.is_valid() && value == 0x777 &&
+					   stringView.size() == strings.size() &&
+					   intView.size() == ints.size() &&
+					   stringView.is_sorted() == sorted &&
+					   intView.is_sorted() == sorted;
+			for (int j = 0; j < 30; ++j) {
+				const std::string key = std::to_string(rng() % 100000);
+				Reader found(nullptr, 0);
+				const auto it = strings.find(key);
+				if (stringView.find(key, found) != (it != strings.end())) {
+					success = false;
+				} else if (it != strings.end()) {
+					found.op(value);
+					success &= value == it->second;
+				}
+				const int64_t intKey = (int64_t)(rng() % 200000) - 100000;
+				const auto it2 = ints.find(intKey);
+				if (intView.find(intKey, found) != (it2 != ints.end())) {
+					success = false;
+				} else if (it2 != ints.end()) {
+					std::string str;
+					found.op(str);
+					success &= str == it2->second;
+				}
+			}
+			for (const auto &[key, val] : ints) {
+				if (rng() % 8 == 0) {
+					Reader found(nullptr, 0);
+					std::string str;
+					success &= intView.find(key, found) &&
+							   found.op(str).is_valid() && str == val;
+				}
+			}
+			// keys of other type are not found
+			Reader found(nullptr, 0);
+			success &= intView.find("1", found) == false &&
+					   stringView.find(1, found) == false;
+			std::map<std::string, int> iterated;
+			for (auto entry : stringView) {
+				std::string key;
+				entry.key.op(key);
+				entry.value.op(iterated[key]);
+				success &= entry.value.is_valid();
+			}
+			success &= iterated == strings;
+		};
+		read(ByteReader(buffer.data(), buffer.size()), sorted);
+		read(UncheckedByteReader(buffer.data(), buffer.size()), sorted);
+		read(ByteReader(plain.data(), plain.size()), false);
+
+		// sorted map is read like map
+		{
+			std::map<std::string, int> s2;
+			std::map<int64_t, std::string> i2;
+			ByteReader reader(buffer.data(), buffer.size());
+			reader.op(s2).op(i2);
+			success &= reader.is_valid() && s2 == strings && i2 == ints;
+		}
+
+		Tape tape;
+		success &= tape.build(buffer.data(), buffer.size()) == ERROR_OK &&
+				   tape.size() == 3;
+		const TapeCursor map = tape.root(1);
+		success &= map.get_type() == V2_MAP && map.size() == ints.size() &&
+				   map.get_detailed_type() ==
+					   (sorted ? V2_DETAIL_SORTED_MAP : V2_MAP);
+		uint32_t j = 0;
+		for (const auto &[key, val] : ints) {
+			int64_t k = 0;
+			std::string str;
+			map.key(j).reader().op(k);
+			map.value(j).reader().op(str);
+			success &= k == key && str == val;
+			++j;
+		}
+
+		const uint8_t *data = buffer.data();
+		const uint32_t size = buffer.size();
+		for (uint32_t cut = 1; cut < size; cut += 1 + size / 4096) {
+			success &= tape.build(data, cut) == validate(data, cut);
+		}
+		// corrupted buffers are never overread by lookups of checked view
+		for (int k = 0; k < 300; ++k) {
+			std::vector<uint8_t> corrupted(data, data + size);
+			for (int l = rng() % 4; l >= 0; --l) {
+				corrupted[rng() % size] = rng();
+			}
+			success &= tape.build(corrupted.data(), size) ==
+					   validate(corrupted.data(), size);
+			ByteReader reader(corrupted.data(), size);
+			MapView stringView(reader);
+			MapView intView(reader);
+			ByteReader found(nullptr, 0);
+			stringView.find(std::to_string(rng() % 100000), found);
+			intView.find((int64_t)(rng() % 200000) - 100000, found);
+		}
+
+		printf(" map view: %i -> %s\n", i, success ? "true" : "false");
+		if (!success) {
+			totalErrors++;
+		}
+	}
+
+	// unsigned keys above INT64_MAX are not in order of signed integers
+	std::map<uint64_t, int> big = {{1, 1}, {UINT64_MAX, 2}};
+	bitscpp::VectorWrapper buffer;
+	ByteWriter(&buffer).op_sorted_map(big);
+	SizeCounter counter;
+	counter.op_sorted_map(big);
+	ByteReader reader(buffer.data(), buffer.size());
+	const bool sorted = reader.is_next_sorted_map();
+	MapView view(reader);
+	ByteReader found(nullptr, 0);
+	int value = 0;
+	const bool success = sorted == false && counter.size == buffer.size() &&
+						 view.find(-1, found) && found.op(value).is_valid() &&
+						 value == 2;
+	printf(" map view: unsigned keys -> %s\n", success ? "true" : "false");
+	if (!success) {
+		totalErrors++;
+	}
+}
+
 int main() {
 	printf("bitscpp::network order:\n");
 	TestNetworkOrder();
 	
+	printf("\n\n");
+	printf("bitscpp::v2 cursor writer:\n");
+	TestCursorWriter();
+	
+	printf("\n\n");
+	printf("bitscpp::v2 raw buffer writer:\n");
+	TestRawBufferWriter();
+	
+	printf("\n\n");
+	printf("bitscpp::v2 segmented buffer writer:\n");
+	TestSegmentedBufferWriter();
+	
+	printf("\n\n");
+	printf("bitscpp::v2 byte array reference:\n");
+	TestByteArrayReference();
+	
+	printf("\n\n");
+	printf("bitscpp::v2 stream buffer writer:\n");
+	TestStreamBufferWriter();
+	
+	printf("\n\n");
+	printf("bitscpp::v2 fixed buffer writer:\n");
+	TestFixedBufferWriter();
+	
+	printf("\n\n");
+	printf("bitscpp::v2 bounded writer:\n");
+	TestBoundedWriter();
+	
+	printf("\n\n");
+	printf("bitscpp::v2 var uint:\n");
+	TestVarUintLength();
+	
+	printf("\n\n");
+	printf("bitscpp::v2 size counter:\n");
+	TestSizeCounter();
+	
+	printf("\n\n");
+	printf("bitscpp::v2 sized object:\n");
+	TestSizedObject();
+	
+	printf("\n\n");
+	printf("bitscpp::v2 integer array:\n");
+	TestIntegerArray();
+	
+	printf("\n\n");
+	printf("bitscpp::v2 packed array:\n");
+	TestPackedArray();
+	TestAlignedPackedArray();
+	
+	printf("\n\n");
+	printf("bitscpp::v2 bit array:\n");
+	TestBitArray();
+	
+	printf("\n\n");
+	printf("bitscpp::v2 half float:\n");
+	TestHalfFloat();
+	
+	printf("\n\n");
+	printf("bitscpp::v2 wide store:\n");
+	TestWideStore();
+	
+	printf("\n\n");
+	printf("bitscpp::v2 padded reader:\n");
+	TestPaddedReader();
+	
+	printf("\n\n");
+	printf("bitscpp::v2 validator:\n");
+	TestValidator();
+	
+	printf("\n\n");
+	printf("bitscpp::v2 skip values:\n");
+	TestSkipValue<bitscpp::v2::ByteReader>("skip_next_value");
+	TestSkipValue<bitscpp::v2::UncheckedByteReader>("skip_next_value unchecked");
+	
+	printf("\n\n");
+	printf("bitscpp::v2 tape:\n");
+	TestTape();
+	
+	printf("\n\n");
+	printf("bitscpp::v2 indexed array:\n");
+	TestIndexedArray();
+	
+	printf("\n\n");
+	printf("bitscpp::v2 map view:\n");
+	TestMapView();
+	
+	printf("\n\n");
+	printf("bitscpp buffer pool:\n");
+	TestBufferPool();
+	
 	printf("\n\n");
 	printf("bitscpp::v2:\n");
 	Test<bitscpp::v2::ByteReader, bitscpp::v2::ByteWriter<bitscpp::VectorWrapper>>{}.main();
 	
+	printf("\n\n");
+	printf("bitscpp::v2 unchecked reader:\n");
+	Test<bitscpp::v2::UncheckedByteReader, bitscpp::v2::ByteWriter<bitscpp::VectorWrapper>>{}.main();
+	
 	printf("\n\n");
 	printf("bitscpp::v1:\n");
 	Test<bitscpp::ByteReader<true>, bitscpp::ByteWriter<bitscpp::VectorWrapper>>{}.main();